@@ -0,0 +1,348 @@
+// ============================================================================
+// File: cbloomfilter.cpp
+// ============================================================================
+// This file contains the implementation of the CCountingBloomFilter class. It
+// uses the template parameter "NodeType" for the type of values that are
+// tracked.
+// ============================================================================
+
+#include    <cmath>
+using namespace std;
+#include    "cbloomfilter.h"
+
+
+// ==== CCountingBloomFilter::CCountingBloomFilter ============================
+//
+// This is the constructor for the CCountingBloomFilter class.  It sizes the
+// filter with CCountingBloomFilter::Reset.
+//
+// Access: public
+//
+// Input:
+//      capacity [IN]       -- the number of items the filter is sized for
+//
+//      falsePosRate [IN]   -- the false-positive rate wanted at that load
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CCountingBloomFilter<NodeType>::CCountingBloomFilter(size_t  capacity
+                                                    , double  falsePosRate)
+                                                    : m_numHashes(1)
+                                                    , m_capacity(0)
+                                                    , m_numItems(0)
+                                                    , m_targetRate(0)
+                                                    , m_numNegatives(0)
+                                                    , m_numFalsePositives(0)
+{
+    Reset(capacity, falsePosRate);
+
+}  // end of "CCountingBloomFilter<NodeType>::CCountingBloomFilter"
+
+
+
+// ==== CCountingBloomFilter::Clear ===========================================
+//
+// This function empties the filter and its statistics, keeping its size.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CCountingBloomFilter<NodeType>::Clear()
+{
+    m_counters.assign(m_counters.size(), 0);
+    m_numItems = 0;
+    m_numNegatives = 0;
+    m_numFalsePositives = 0;
+
+}  // end of "CCountingBloomFilter<NodeType>::Clear"
+
+
+
+// ==== CCountingBloomFilter::GetEstimatedRate ================================
+//
+// This function predicts the false-positive rate at the current load, which
+// is (1 - e^(-kn/m))^k for k hashes, n items and m counters.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The predicted probability that MayContain answers true for an item
+//      that is not in the set.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+double  CCountingBloomFilter<NodeType>::GetEstimatedRate() const
+{
+    double  numHashes = static_cast<double>(m_numHashes);
+    double  fill = exp(-numHashes * m_numItems / m_counters.size());
+
+    return pow(1.0 - fill, numHashes);
+
+}  // end of "CCountingBloomFilter<NodeType>::GetEstimatedRate"
+
+
+
+// ==== CCountingBloomFilter::GetObservedRate =================================
+//
+// This function reports the false-positive rate seen so far: the fraction of
+// lookups for absent items that MayContain let through, counting only the
+// ones the owner reported with CCountingBloomFilter::RecordFalsePositive.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The observed false-positive rate, or 0 if no absent item has been
+//      looked up yet.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+double  CCountingBloomFilter<NodeType>::GetObservedRate() const
+{
+    size_t  numAbsent = m_numNegatives + m_numFalsePositives;
+
+    if(numAbsent == 0)
+    {
+        return 0;
+    }
+
+    return static_cast<double>(m_numFalsePositives) / numAbsent;
+
+}  // end of "CCountingBloomFilter<NodeType>::GetObservedRate"
+
+
+
+// ==== CCountingBloomFilter::HashItem ========================================
+//
+// This function derives the two hash values used for double hashing from a
+// single std::hash call.  The std::hash result is run through a 64-bit mixer
+// first, since for integers it is often the value itself.  The second hash
+// is forced odd so that it steps through the counters without short cycles.
+//
+// Access: protected
+//
+// Input:
+//      item [IN]       -- the item to hash
+//
+//      hash1 [OUT]     -- the position of the first counter
+//
+//      hash2 [OUT]     -- the step between counters
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CCountingBloomFilter<NodeType>::HashItem(const NodeType  &item
+                                                , uint64_t  &hash1
+                                                , uint64_t  &hash2) const
+{
+    uint64_t    mixed = 0;
+
+    if constexpr (IS_HASHABLE)
+    {
+        mixed = hash<NodeType>()(item);
+    }
+
+    mixed ^= mixed >> 33;
+    mixed *= 0xFF51AFD7ED558CCDull;
+    mixed ^= mixed >> 33;
+    mixed *= 0xC4CEB9FE1A85EC53ull;
+    mixed ^= mixed >> 33;
+
+    hash1 = mixed;
+    hash2 = ((mixed >> 32) | (mixed << 32)) | 1;
+
+}  // end of "CCountingBloomFilter<NodeType>::HashItem"
+
+
+
+// ==== CCountingBloomFilter::Insert ==========================================
+//
+// This function adds an item to the filter by incrementing each of its
+// counters.  The caller must not insert an item that is already in the set.
+//
+// Access: public
+//
+// Input:
+//      item [IN]       -- the item to add
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CCountingBloomFilter<NodeType>::Insert(const NodeType  &item)
+{
+    uint64_t    hash1;
+    uint64_t    hash2;
+
+    HashItem(item, hash1, hash2);
+    for(size_t i = 0; i < m_numHashes; ++i)
+    {
+        uint8_t &counter = m_counters[(hash1 + i * hash2) % m_counters.size()];
+        if(counter < COUNTER_MAX)
+        {
+            ++counter;
+        }
+    }
+    ++m_numItems;
+
+}  // end of "CCountingBloomFilter<NodeType>::Insert"
+
+
+
+// ==== CCountingBloomFilter::MayContain ======================================
+//
+// This function checks whether an item might be in the set.  A zero in any
+// of the item's counters proves that it is not.
+//
+// Access: public
+//
+// Input:
+//      item [IN]       -- the item to look for
+//
+// Output:
+//      A value of false if the item is definitely not in the set, true if it
+//      may be.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CCountingBloomFilter<NodeType>::MayContain(const NodeType  &item) const
+{
+    uint64_t    hash1;
+    uint64_t    hash2;
+
+    HashItem(item, hash1, hash2);
+    for(size_t i = 0; i < m_numHashes; ++i)
+    {
+        if(m_counters[(hash1 + i * hash2) % m_counters.size()] == 0)
+        {
+            ++m_numNegatives;
+            return false;
+        }
+    }
+
+    return true;
+
+}  // end of "CCountingBloomFilter<NodeType>::MayContain"
+
+
+
+// ==== CCountingBloomFilter::Remove ==========================================
+//
+// This function takes an item out of the filter by decrementing each of its
+// counters.  Counters that have stuck at their maximum are left alone.  The
+// caller must only remove items that are in the set.
+//
+// Access: public
+//
+// Input:
+//      item [IN]       -- the item to remove
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CCountingBloomFilter<NodeType>::Remove(const NodeType  &item)
+{
+    uint64_t    hash1;
+    uint64_t    hash2;
+
+    HashItem(item, hash1, hash2);
+    for(size_t i = 0; i < m_numHashes; ++i)
+    {
+        uint8_t &counter = m_counters[(hash1 + i * hash2) % m_counters.size()];
+        if(counter > 0 && counter < COUNTER_MAX)
+        {
+            --counter;
+        }
+    }
+    if(m_numItems > 0)
+    {
+        --m_numItems;
+    }
+
+}  // end of "CCountingBloomFilter<NodeType>::Remove"
+
+
+
+// ==== CCountingBloomFilter::Reset ===========================================
+//
+// This function empties the filter and resizes it to hold capacity items at
+// the given false-positive rate, using the usual optimal sizes of
+// m = -n ln(p) / ln(2)^2 counters and k = (m / n) ln(2) hashes.  The
+// statistics are kept, so a filter can be regrown without losing them.
+//
+// Access: public
+//
+// Input:
+//      capacity [IN]       -- the number of items the filter is sized for
+//
+//      falsePosRate [IN]   -- the false-positive rate wanted at that load,
+//                             between 0 and 1
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CCountingBloomFilter<NodeType>::Reset(size_t  capacity
+                                                , double  falsePosRate)
+{
+    const double    LN2 = log(2.0);
+    double          numCounters;
+
+    if(capacity < 1)
+    {
+        capacity = 1;
+    }
+    if(falsePosRate <= 0 || falsePosRate >= 1)
+    {
+        falsePosRate = 0.01;
+    }
+
+    numCounters = ceil(-(capacity * log(falsePosRate)) / (LN2 * LN2));
+    if(numCounters < 64)
+    {
+        numCounters = 64;
+    }
+
+    m_numHashes = static_cast<size_t>(numCounters / capacity * LN2 + 0.5);
+    if(m_numHashes < 1)
+    {
+        m_numHashes = 1;
+    }
+    else if(m_numHashes > 16)
+    {
+        m_numHashes = 16;
+    }
+
+    m_capacity = capacity;
+    m_targetRate = falsePosRate;
+    m_counters.assign(static_cast<size_t>(numCounters), 0);
+    m_numItems = 0;
+
+}  // end of "CCountingBloomFilter<NodeType>::Reset"
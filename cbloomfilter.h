@@ -0,0 +1,75 @@
+// ============================================================================
+// File: cbloomfilter.h
+// ============================================================================
+// This header file contains the declaration of the CCountingBloomFilter class.
+// It uses the template parameter "NodeType" for the type of values that are
+// tracked, which are hashed with std::hash.
+//
+// A Bloom filter answers "might this item be in the set?" with either "no"
+// (always correct) or "maybe" (wrong at a small, configurable rate).  Each
+// item is mapped to a handful of counters by double hashing.  Inserting an
+// item increments its counters and removing it decrements them, so unlike a
+// plain bit-array Bloom filter this one supports deletes.  A counter that
+// reaches its maximum sticks there, which can only cause extra "maybe"
+// answers, never a wrong "no".
+//
+// The filter keeps count of its definite misses and of the "maybe" answers
+// its owner reports as wrong, so the observed false-positive rate can be
+// compared with the one predicted from its size and load.
+// ============================================================================
+
+#ifndef CCOUNTING_BLOOM_FILTER_HEADER
+#define CCOUNTING_BLOOM_FILTER_HEADER
+
+#include    <cstdint>
+#include    <functional>
+#include    <type_traits>
+#include    <vector>
+using namespace std;
+
+// class declaration
+template    <typename  NodeType>
+class   CCountingBloomFilter
+{
+public:
+    // true if std::hash can hash a NodeType; the filter is useless otherwise
+    static const bool   IS_HASHABLE =
+                            is_default_constructible<hash<NodeType> >::value;
+
+    // constructor
+    explicit CCountingBloomFilter(size_t  capacity = 1024
+                                        , double  falsePosRate = 0.01);
+
+    // member functions
+    void    Clear();
+    size_t  GetCapacity() const { return m_capacity; }
+    double  GetEstimatedRate() const;
+    size_t  GetNumItems() const { return m_numItems; }
+    double  GetObservedRate() const;
+    double  GetTargetRate() const { return m_targetRate; }
+    void    Insert(const NodeType  &item);
+    bool    MayContain(const NodeType  &item) const;
+    void    RecordFalsePositive() const { ++m_numFalsePositives; }
+    void    Remove(const NodeType  &item);
+    void    Reset(size_t  capacity, double  falsePosRate);
+
+protected:
+    // member functions
+    void    HashItem(const NodeType  &item, uint64_t  &hash1
+                                        , uint64_t  &hash2) const;
+
+    // the value at which a counter stops counting
+    static const uint8_t    COUNTER_MAX = 0xFF;
+
+    // data members
+    vector<uint8_t>     m_counters;
+    size_t              m_numHashes;
+    size_t              m_capacity;
+    size_t              m_numItems;
+    double              m_targetRate;
+    mutable size_t      m_numNegatives;
+    mutable size_t      m_numFalsePositives;
+};
+
+#include    "cbloomfilter.cpp"
+#endif  // CCOUNTING_BLOOM_FILTER_HEADER
@@ -3,665 +3,962 @@
 // ============================================================================
 // This file contains the implementation of the CBSTree class. It uses the
 // template parameter "NodeType" for the type of values that are stored in the
-// tree.
+// tree, and the template parameter "Compare" for the function object that
+// orders them.
 // ============================================================================
 
 #include    <fstream>
 #include    <iostream>
 #include    <cstdlib>
+#include    <cmath>
 using namespace std;
 #include    "cbstree.h"
 
+// the template header and the class name that begin every definition below
+#define     CBSTREE_TEMPLATE    template    <typename  NodeType        \
+                                    , typename  Compare                 \
+                                    , typename  BalancePolicy           \
+                                    , typename  AllocPolicy             \
+                                    , typename  StatsPolicy             \
+                                    , typename  FeaturePolicy>
+#define     CBSTREE_CLASS       CBSTree<NodeType, Compare, BalancePolicy  \
+                                    , AllocPolicy, StatsPolicy          \
+                                    , FeaturePolicy>
+
 
 // ==== CBSTree::CBSTree ======================================================
 //
-// This is the copy constructor for the CBSTree class, it just makes a call to
-// the CopyTree member function and saves the return value in the root member
-// of the calling object.
+// These are the default constructor and the constructor that takes a Compare
+// object for the CBSTree class.  They create an empty tree in the balance
+// policy's mode (BALANCE_NONE for CRuntimeBalance).  The feature policy's
+// mixins start with finger search on, lazy deletion off, a scapegoat alpha
+// of 0.7, no filter and nodes freed on the calling thread, and there are no
+// latency stats.
 //
 // Access: public
 //
 // Input:
-//      other [IN]  -- a constant reference to a CBSTree object.
+//      comp [IN]   -- a constant reference to the Compare object to use
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CBSTree<NodeType>::CBSTree(const CBSTree<NodeType>  &other)
+CBSTREE_TEMPLATE
+CBSTREE_CLASS::CBSTree()
 {
-    CopyTree(other.m_root);
+}  // end of "CBSTree<NodeType>::CBSTree"
+
 
+
+CBSTREE_TEMPLATE
+CBSTREE_CLASS::CBSTree(const Compare  &comp)
+                                        : CCompareHolder<Compare>(comp)
+{
 }  // end of "CBSTree<NodeType>::CBSTree"
 
 
 
-// ==== CBSTree::CopyTree =====================================================
+// ==== CBSTree::CBSTree ======================================================
 //
-// This recursive function creates a copy of a CBSTree. It receives a pointer
-// to the source tree's root and uses a preorder traversal to make recursive
-// calls and create a copy of the tree, and then returns a pointer to the root
-// of the new copy.
+// This is the copy constructor for the CBSTree class, it just makes a call to
+// the CopyTree member function and saves the return value in the root member
+// of the calling object.  The other tree's filter, if any, is copied too, but
+// its latency stats are not.
 //
-// Access: private
+// Access: public
 //
 // Input:
-//      sourcePtr [IN]          -- a pointer to the source tree's root
-//
-//  Output:
-//      A pointer to the root of the copied tree.
+//      other [IN]  -- a constant reference to a CBSTree object.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CTreeNode<NodeType>*    CBSTree<NodeType>::CopyTree(
-                                        const CTreeNode<NodeType>  *sourcePtr)
+CBSTREE_TEMPLATE
+CBSTREE_CLASS::CBSTree(const CBSTREE_CLASS  &other)
+                                    : BalancePolicy(other), StatsPolicy(other)
+                                    , AllocPolicy(other)
+                                    , CCompareHolder<Compare>(other)
 {
-    if(sourcePtr)
+    m_bUseFinger = other.m_bUseFinger;
+    m_bLazyDelete = other.m_bLazyDelete;
+    m_maxTombstoneRatio = other.m_maxTombstoneRatio;
+    m_numNodes = other.m_numNodes;
+    m_numTombstones = other.m_numTombstones;
+    m_alpha = other.m_alpha;
+    m_maxNodes = other.m_maxNodes;
+    m_bAsyncRelease = other.m_bAsyncRelease;
+    if(other.m_bSmallSet)
     {
-        InsertItem(sourcePtr->m_value);
-        return sourcePtr;
+        m_smallItems.assign(other.m_smallItems.begin()
+                                        , other.m_smallItems.end());
     }
-    if(sourcePtr->m_left)
+    else
     {
-        CopyTree(sourcePtr->m_left);
+        SwitchToNodes();
+        m_root = CopyTree(other.m_root);
     }
-    if(sourcePtr->m_right)
+    if(other.m_filter != NULL)
     {
-        CopyTree(sourcePtr->m_right);
+        m_filter = new CCountingBloomFilter<NodeType>(*other.m_filter);
     }
 
-}  // end of "CBSTree<NodeType>::CopyTree"
-
-
+}  // end of "CBSTree<NodeType>::CBSTree"
 
-// ==== CBSTree::CountNodes ===================================================
+// ==== CBSTree::AllocNode ====================================================
 //
-// This recursive function derives the current height and number of nodes in
-// the tree.  The height is a zero-based integer value, which represents the
-// length of the longest path from the root to a leaf (counting the edges, not
-// the nodes).  This function is called by public function CBSTree::GetTreeInfo
-// so that the caller may determine the total number of nodes and the height of
-// the tree.
+// This function allocates a node for a new item.  A free slot left in the
+// node block by a deletion (see CBSTree::CompactLayout) is reused if there is
+// one, so that the new node lands among the others; otherwise the node comes
+// from the allocation policy.
 //
 // Access: protected
 //
 // Input:
-//      nodePtr [IN]        -- a pointer to a tree node; initially this is the
-//                             root
-//
-//      currDepth [IN]      -- the depth of the parent node (initial value is
-//                             negative one, set by the caller)
-//
-//      numNodes [IN/OUT]   -- a reference to an int that will contain the
-//                             total number of nodes in the tree (initial value
-//                             is zero, set by the caller)
+//      newItem [IN]    -- a const reference to the item for the node
 //
 // Output:
-//      The length of the longest path from the root.
+//      A pointer to the new node.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-int     CBSTree<NodeType>::CountNodes(const CTreeNode<NodeType>  *nodePtr
-                                                        , int  currDepth
-                                                        , int  &numNodes )const
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::AllocNode(
+                                        const NodeType  &newItem)
 {
-    if(nodePtr == NULL)
-    {
-        return 0;
-    }
-
-    numNodes++;
+    TreeNode *slotPtr;
 
-    if(nodePtr->m_left == NULL && nodePtr->m_right == NULL)
+    if(m_freeSlots.empty())
     {
-        return 0;
+        return AllocPolicy::template NewNode<TreeNode>(newItem);
     }
-    else
-    {
-        currDepth++;
-
-        int left = CountNodes(nodePtr->m_left, currDepth, numNodes);
-        int right = CountNodes(nodePtr->m_right, currDepth, numNodes);
 
-        if(left > right)
-        {
-            left++;
-            return left;
-        }
-        else
-        {
-            right++;
-            return right;
-        }
-    }
+    slotPtr = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return new(slotPtr) TreeNode(newItem);
 
-}  // end of "CBSTree::CountNodes"
+}  // end of "CBSTree<NodeType>::AllocNode"
 
 
 
-// ==== CBSTree::Delete =======================================================
+// ==== CBSTree::BuildFromSorted ==============================================
 //
-// This function deletes a target node from the tree.  The function finds the
-// correct location for the target node by calling itself recursively. It then
-// returns the address of the (potentially new) root of the tree.
+// This function replaces the contents of the tree with the values of a sorted
+// array in O(n) time.  Up to SMALL_MAX values are simply copied into the
+// small set, if the tree has one.  Otherwise the new nodes are first chained
+// into a vine, in order, and the vine is then folded into a balanced tree by
+// CBSTree::VineToTree, so no comparisons are made at all.
 //
 // Access: protected
 //
 // Input:
-//      target [IN]         -- a const reference to a NodeType item that
-//                             contains the target search key value
-//
-//      nodePtr [IN]        -- a pointer to a tree node (initially this is
-//                             the root).
+//      array [IN]      -- the values, in strictly increasing order
 //
-//      bItemDeleted [OUT]  -- a reference to a bool that will indicate if the
-//                             target item was actually removed from the tree;
-//                             if that's the case it will have a value of true,
-//                             else it will have a value of false
+//      count [IN]      -- the number of values in the array
 //
 // Output:
-//      A pointer to the (potentially new) root of the tree.
+//      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CTreeNode<NodeType>*  CBSTree<NodeType>::Delete(const NodeType  &target
-                                                , CTreeNode<NodeType>  *nodePtr
-                                                , bool  &bItemDeleted)
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::BuildFromSorted(const NodeType  array[]
+                                                    , size_t  count)
 {
-    CTreeNode<NodeType> child;
-    CTreeNode<NodeType> *temp;
-    temp = NULL;
-    child->m_right = temp;
-    child->m_left = temp;
-
-    if(nodePtr == NULL)
-    {
-        bItemDeleted = false;
-        return NULL;
-    }
+    TreeNode    **link = &m_root;
 
-    if(target < nodePtr->m_value)
-    {
-        nodePtr->left = Delete(target, nodePtr->left);
-    }
-    else if(target > nodePtr->m_value)
+    DestroyTree();
+    if(HasFeature(FEATURE_SMALL_SET) && count <= SMALL_MAX)
     {
-        nodePtr->right = Delete(target, nodePtr->right);
+        m_smallItems.assign(array, array + count);
     }
     else
     {
-        if(nodePtr->m_right && nodePtr->m_left)
-        {
-            temp = FindMinNode(nodePtr->m_right);
-            nodePtr->m_value = temp->m_value;
-            nodePtr->m_right = Delete(nodePtr->m_value, nodePtr->m_right);
-        }
-        else
+        SwitchToNodes();
+        for(size_t i = 0; i < count; ++i)
         {
-            if(nodePtr->m_right && nodePtr->m_left == NULL)
-            {
-                child = nodePtr->m_right;
-            }
-            else
-            {
-                child = nodePtr->m_left;
-            }
-            delete nodePtr;
-            bItemDeleted = true;
-            return child;
+            *link = AllocNode(array[i]);
+            link = &(*link)->m_right;
         }
-        bItemDeleted = true;
-        return nodePtr;
+        VineToTree(&m_root, count);
     }
-    bItemDeleted = false;
 
-}  // end of "CBSTree<NodeType>::Delete"
+    m_numNodes = m_maxNodes = count;
+    if(m_filter != NULL)
+    {
+        RebuildFilter(m_filter->GetTargetRate());
+    }
 
-// ==== CBSTree::DeleteItem ===================================================
+}  // end of "CBSTree<NodeType>::BuildFromSorted"
+
+
+
+// ==== CBSTree::BuildSpines ==================================================
 //
-// This function allows the caller to delete a target node from the tree.
+// This function finds the left and right spines of the tree (the paths from
+// the root to the leftmost and to the rightmost node) and caches them.
 //
-// Access: public
+// Access: protected
 //
 // Input:
-//      target [IN]      -- a const reference to a NodeType object
+//      Nothing
 //
 // Output:
-//      A value of false if the target item is not in the tree, otherwise a
-//      value of true is returned and the item is removed from the tree.
+//      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-bool    CBSTree<NodeType>::DeleteItem(const NodeType  &target)
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::BuildSpines() const
 {
-    bool bItemDeleted = false;
-    Delete(target, m_root, &bItemDeleted);
-    return bItemDeleted;
+    m_minSpine.clear();
+    m_maxSpine.clear();
+    for(TreeNode *nodePtr = m_root; nodePtr != NULL
+                                            ; nodePtr = nodePtr->m_left)
+    {
+        m_minSpine.push_back(nodePtr);
+    }
+    for(TreeNode *nodePtr = m_root; nodePtr != NULL
+                                            ; nodePtr = nodePtr->m_right)
+    {
+        m_maxSpine.push_back(nodePtr);
+    }
+    m_bSpinesValid = true;
 
-}  // end of "CBSTree<NodeType>::DeleteItem"
+}  // end of "CBSTree<NodeType>::BuildSpines"
 
 
 
-// ==== CBSTree::DestroyNodes =================================================
+// ==== CBSTree::CompactLayout ================================================
 //
-// This function performs a recursive postorder descent down the tree,
-// releasing all allocated memory.
+// This function moves every node of the tree into one newly allocated block,
+// in the order given by CBSTree::VebOrder, without changing the shape of the
+// tree.  Each node is copied into its slot and the old node's left link is
+// pointed at the copy, so that a second pass can translate the copies' links
+// from old nodes to new ones.  The old nodes, and the previous block if
+// there was one, are then freed.  The height is measured with an explicit
+// stack, so a degenerate tree is handled too.  A small set is contiguous
+// already, so it is left as it is.  The tree must be built with
+// FEATURE_COMPACT_LAYOUT.
 //
-// Access: protected
+// Access: public
 //
 // Input:
-//      nodePtr [IN/OUT]    -- a pointer to a tree node (initially the root)
+//      Nothing
 //
 // Output:
-//      Nothing.
+//      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::DestroyNodes(CTreeNode<NodeType>  *const nodePtr)
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::CompactLayout()
 {
-    CTreeNode<NodeType> *temp;
-    temp = nodePtr;
+    allocator<TreeNode>                 alloc;
+    vector<pair<TreeNode*, size_t> >    pending;
+    vector<TreeNode*>                   order;
+    TreeNode                            *arena = NULL;
+    size_t                              levels = 0;
 
-    if(nodePtr == NULL)
+    static_assert(HasFeature(FEATURE_COMPACT_LAYOUT)
+                        , "CompactLayout needs FEATURE_COMPACT_LAYOUT");
+    if(m_bSmallSet)
     {
         return;
     }
-    if(temp->m_left == NULL && temp->m_right == NULL)
+
+    if(m_root != NULL)
     {
-        free(temp);
+        pending.push_back(make_pair(m_root, 1));
     }
-    else
+    while(!pending.empty())
+    {
+        TreeNode *nodePtr = pending.back().first;
+        size_t              depth = pending.back().second;
+        pending.pop_back();
+        if(depth > levels)
+        {
+            levels = depth;
+        }
+        if(nodePtr->m_left != NULL)
+        {
+            pending.push_back(make_pair(nodePtr->m_left, depth + 1));
+        }
+        if(nodePtr->m_right != NULL)
+        {
+            pending.push_back(make_pair(nodePtr->m_right, depth + 1));
+        }
+    }
+
+    order.reserve(m_numNodes);
+    VebOrder(m_root, levels, order);
+    if(!order.empty())
+    {
+        arena = alloc.allocate(order.size());
+    }
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        new(&arena[i]) TreeNode(*order[i]);
+        order[i]->m_left = &arena[i];
+    }
+    for(size_t i = 0; i < order.size(); ++i)
     {
-        DestroyNodes(nodePtr->m_left);
-        DestroyNodes(nodePtr->m_right);
+        if(arena[i].m_left != NULL)
+        {
+            arena[i].m_left = arena[i].m_left->m_left;
+        }
+        if(arena[i].m_right != NULL)
+        {
+            arena[i].m_right = arena[i].m_right->m_left;
+        }
     }
+    m_root = order.empty() ? NULL : m_root->m_left;
 
-}  // end of "CBSTree<ItemType>::DestroyNodes"
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        if(InArena(order[i]))
+        {
+            order[i]->~TreeNode();
+        }
+        else
+        {
+            AllocPolicy::DeleteNode(order[i]);
+        }
+    }
+    if(m_arena != NULL)
+    {
+        alloc.deallocate(m_arena, m_arenaSize);
+    }
 
+    m_arena = arena;
+    m_arenaSize = order.size();
+    m_freeSlots.clear();
+    m_finger.clear();
+    m_bSpinesValid = false;
 
+}  // end of "CBSTree<NodeType>::CompactLayout"
 
-// ==== CBSTree::FindMinNode ==================================================
+
+
+// ==== CBSTree::CompactTree ==================================================
 //
-// This function finds the inorder successor of the node pointed to by the
-// parameter, and returns a pointer to the inorder successor node.
+// This function removes every tombstone from the tree and leaves it balanced.
+// Tombstones are freed while CBSTree::RebalanceTree straightens the tree into
+// a vine, so compaction is simply a rebalance; the separate name makes the
+// intent clear at the call site.
 //
-// Access: protected
+// Access: public
 //
 // Input:
-//      nodePtr [IN]    -- a pointer to a tree node
+//      Nothing
 //
 // Output:
-//      A pointer to the target node.
+//      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CTreeNode<NodeType>*  CBSTree<NodeType>::FindMinNode(
-                            CTreeNode<NodeType>  *nodePtr) const
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::CompactTree()
 {
-    while(nodePtr->m_left != NULL)
-    {
-        nodePtr = nodePtr->m_left;
-    }
-    return nodePtr;
+    RebalanceTree();
 
-}  // end of "CBSTree<NodeType>::FindMinNode"
+}  // end of "CBSTree<NodeType>::CompactTree"
 
 
 
-// ==== CBSTree::GetTreeInfo ==================================================
+// ==== CBSTree::Compare3 =====================================================
 //
-// This function allows the caller to get the current number of nodes and the
-// height of the tree by calling the CBSTree::CountNodes member function.
+// This function compares two values with the tree's Compare object and
+// returns the result as a negative, zero or positive int.  A three-way
+// comparator is called once; a less-than predicate (one that returns a bool)
+// is called in both directions.
 //
-// Access: public
+// Access: protected
 //
 // Input:
-//      numNodes [OUT]  -- a reference to an int that will contain the total
-//                         number of nodes currently in the tree
+//      lhs [IN]    -- a const reference to the left-hand value
 //
-//      height [OUT]    -- a reference to an int that will contain the height
-//                         of the tree; this is a zero-based value that
-//                         represents the longest path from the root to a leaf
-//                         (counting edges, not the nodes)
+//      rhs [IN]    -- a const reference to the right-hand value
 //
 // Output:
-//      Nothing
+//      A negative value if lhs orders before rhs, a positive value if it
+//      orders after rhs, and zero if the two are equivalent.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::GetTreeInfo(int  &numNodes, int  &height) const
+CBSTREE_TEMPLATE
+template    <typename  LhsType, typename  RhsType>
+int     CBSTREE_CLASS::Compare3(const LhsType  &lhs
+                                            , const RhsType  &rhs) const
 {
-    numNodes = 0;
-    height = CountNodes(m_root, -1, numNodes);
+    const Compare   &compare = this->GetCompare();
+    typedef decltype(compare(lhs, rhs))     ResultType;
 
-}  // end of "CBSTree::GetTreeInfo"
+    if constexpr (is_same<typename decay<ResultType>::type, bool>::value)
+    {
+        return compare(lhs, rhs) ? -1 : (compare(rhs, lhs) ? 1 : 0);
+    }
+    else
+    {
+        ResultType  result = compare(lhs, rhs);
+        return (result < 0) ? -1 : ((result > 0) ? 1 : 0);
+    }
 
+}  // end of "CBSTree<NodeType>::Compare3"
 
 
-// ==== CBSTree::InOrder ======================================================
+
+// ==== CBSTree::Compress =====================================================
 //
-// This function performs an in-order traversal through the tree, calling the
-// "fPtr" parameter for each node.
+// This function performs one pass of the Day-Stout-Warren vine compression.
+// Starting at the vine hanging from the link parameter, it rotates every
+// second node left over its parent, "count" times, which halves the length of
+// the vine and hangs the skipped nodes as left children.
 //
 // Access: protected
 //
 // Input:
-//      nodePtr [IN]    -- a pointer to a tree node (this is a recursive
-//                         function, initially this points to the root).
+//      link [IN/OUT]   -- the address of the link that holds the vine
 //
-//      fPtr [IN]       -- a pointer to a non-member function that takes a
-//                         const reference to a NodeType object as input, and
-//                         returns nothing
+//      count [IN]      -- the number of left rotations to perform
 //
 // Output:
 //      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::InOrder(const CTreeNode<NodeType> *const nodePtr
-                                        , void (*fPtr)(const NodeType&)) const
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::Compress(TreeNode  **link
+                                                    , size_t  count)
 {
-    if(nodePtr == NULL)
+    TreeNode *child;
+    TreeNode *grandchild;
+
+    for(; count > 0; --count)
     {
-        return;
+        child = *link;
+        grandchild = child->m_right;
+        *link = grandchild;
+        child->m_right = grandchild->m_left;
+        grandchild->m_left = child;
+        link = &grandchild->m_right;
     }
 
-    InOrder(nodePtr->m_left, fPtr);
-    (*fPtr)(nodePtr->m_value);
-    InOrder(nodePtr->m_right, fPtr);
-
-}  // end of "CBSTree<NodeType>::InOrder"
+}  // end of "CBSTree<NodeType>::Compress"
 
 
 
-// ==== CBSTree::InOrderTraverse ==============================================
+// ==== CBSTree::CopyTree =====================================================
 //
-// This function allows the caller to execute an in-order traversal through the
-// tree, and have the "fPtr" parameter called for each node in the tree.
+// This function creates a copy of a CBSTree.  It receives a pointer to the
+// source tree's root, copies the nodes in preorder and returns a pointer to
+// the root of the new copy.  Tombstones are copied as they are.  Instead of
+// recursing, the function runs down the left links copying each node, and
+// keeps on an explicit stack the right children it passes along with the
+// links their copies belong in, so a tree of any depth can be copied.
 //
-// Access: public
+// Access: private
 //
 // Input:
-//      fPtr [IN]   -- a pointer to a non-member function that takes a const
-//                     reference to a NodeType object as input, and returns
-//                     nothing
+//      sourcePtr [IN]          -- a pointer to the source tree's root
 //
-// Output:
-//      Nothing
+//  Output:
+//      A pointer to the root of the copied tree.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::InOrderTraverse(void  (*fPtr)(const NodeType&)) const
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::CopyTree(
+                                        const TreeNode  *sourcePtr)
 {
-    InOrder(m_root, *fPtr);
+    vector<pair<const TreeNode*, TreeNode**> > pending;
+    TreeNode                            *rootPtr = NULL;
+    TreeNode                            **link = &rootPtr;
 
-}  // end of "CBSTree<NodeType>::InOrderTraverse"
+    for(;;)
+    {
+        while(sourcePtr != NULL)
+        {
+            *link = AllocNode(sourcePtr->m_value);
+            (*link)->m_bDeleted = sourcePtr->m_bDeleted;
+            if(sourcePtr->m_right != NULL)
+            {
+                pending.push_back(make_pair(sourcePtr->m_right
+                                                , &(*link)->m_right));
+            }
+            link = &(*link)->m_left;
+            sourcePtr = sourcePtr->m_left;
+        }
+
+        if(pending.empty())
+        {
+            break;
+        }
+        sourcePtr = pending.back().first;
+        link = pending.back().second;
+        pending.pop_back();
+    }
 
+    return rootPtr;
 
+}  // end of "CBSTree<NodeType>::CopyTree"
 
-// ==== CBSTree::Insert =======================================================
-//
-// This function inserts a new node into the tree.  It finds the correct
-// location for the new node by calling itself recursively. If the new item
-// is unique, a copy is created and inserted into the tree. Then the address of
-// the (potentially new) root of the tree is returned.
+
+
+// ==== CBSTree::CountNodes ===================================================
 //
-// If the root data member of this class is NULL upon entry, it is updated
-// with the value of the nodePtr parameter.
+// This function derives the current height and number of nodes in the tree.
+// The height is a zero-based value, which represents the length of the
+// longest path from the root to a leaf (counting the edges, not the nodes).
+// This function is called by public function CBSTree::GetTreeInfo so that
+// the caller may determine the total number of nodes and the height of the
+// tree.  Tombstones add to the height but are not counted as nodes.  The
+// nodes are visited with an explicit stack that holds each pending node with
+// its depth, so the tree may be as deep as it likes.
 //
 // Access: protected
 //
 // Input:
-//      newItem [IN]    -- a const reference to a NodeType object; it is
-//                         assumed that the object is initialized and ready to
-//                         be inserted
+//      nodePtr [IN]        -- a pointer to a tree node; initially this is the
+//                             root
 //
-//      nodePtr [IN]    -- a pointer to a tree node (initially this is usually
-//                         the root)
+//      numNodes [OUT]      -- a reference to a size_t that is set to the
+//                             total number of live nodes in the subtree
 //
 // Output:
-//      A pointer to the (potentially new) root of the tree
+//      The length of the longest path from the root, or zero if the subtree
+//      is empty.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CTreeNode<NodeType>*  CBSTree<NodeType>::Insert(const NodeType  &newItem
-                                            , CTreeNode<NodeType>  *nodePtr)
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::CountNodes(const TreeNode  *nodePtr
+                                        , size_t  &numNodes) const
 {
-    if(ItemInTree(newItem))
+    vector<pair<const TreeNode*, size_t> >   pending;
+    size_t                                              height = 0;
+
+    numNodes = 0;
+    if(nodePtr != NULL)
     {
-        return NULL;
+        pending.push_back(make_pair(nodePtr, 0));
     }
-    if(nodePtr == NULL)
+    while(!pending.empty())
     {
-        nodePtr = new CTreeNode<NodeType>(newItem);
-
-        if(m_root == NULL)
+        size_t  depth = pending.back().second;
+        nodePtr = pending.back().first;
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
         {
-            m_root = nodePtr;
+            ++numNodes;
         }
-    }
-    else
-    {
-        if(newItem < nodePtr->m_value)
+        if(depth > height)
         {
-            nodePtr->m_left = Insert(newItem, nodePtr->m_left);
+            height = depth;
         }
-        else if(newItem > nodePtr->m_value)
+        if(nodePtr->m_right != NULL)
         {
-            nodePtr->m_right = Insert(newItem, nodePtr->m_right);
+            pending.push_back(make_pair(nodePtr->m_right, depth + 1));
+        }
+        if(nodePtr->m_left != NULL)
+        {
+            pending.push_back(make_pair(nodePtr->m_left, depth + 1));
         }
     }
 
-    return nodePtr;
+    return height;
 
-}  // end of "CBSTree<NodeType>::Insert"
+}  // end of "CBSTree::CountNodes"
 
 
 
-// ==== CBSTree::InsertItem ===================================================
+// ==== CBSTree::Delete =======================================================
 //
-// This function allows the caller to insert a new node into the tree.  The
-// input parameter is a const reference to the item to insert.
+// This function deletes a target node from the tree.  The function finds the
+// target with a loop that keeps the address of the link leading to the
+// current node, making one three-way comparison per level.  A node with two
+// children takes the value of the smallest node of its right subtree, and
+// that node, which has no left child, is unlinked instead.  The function
+// then returns the address of the (unchanged) root of the tree.
 //
-// Access: public
+// Access: protected
 //
 // Input:
-//      newItem [IN]    -- a const reference a NodeType object
+//      target [IN]         -- a const reference to a NodeType item that
+//                             contains the target search key value
+//
+//      nodePtr [IN]        -- a pointer to a tree node (initially this is
+//                             the root).
+//
+//      bItemDeleted [OUT]  -- a reference to a bool that will indicate if the
+//                             target item was actually removed from the tree;
+//                             if that's the case it will have a value of true,
+//                             else it will have a value of false
 //
 // Output:
-//      A value of true if the item was successfully inserted into the tree,
-//      false otherwise.
+//      A pointer to the (potentially new) root of the tree.
 //
 // ============================================================================
-template    <typename  NodeType>
-bool    CBSTree<NodeType>::InsertItem(const NodeType  &newItem)
+
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::Delete(
+                                        const NodeType  &target
+                                        , TreeNode  *nodePtr
+                                        , bool  &bItemDeleted)
 {
-    if(Insert(newItem, m_root) == NULL)
+    TreeNode **link = &nodePtr;
+    TreeNode *temp;
+
+    bItemDeleted = false;
+    while(*link != NULL)
     {
-        return false;
+        int result = Compare3(target, (*link)->m_value);
+        if(result == 0)
+        {
+            break;
+        }
+        link = (result < 0) ? &(*link)->m_left : &(*link)->m_right;
     }
-    else
+    if(*link == NULL)
     {
-        return true;
+        return nodePtr;
     }
 
-}  // end of "CBSTree<NodeType>::InsertItem"
+    temp = *link;
+    if(temp->m_left != NULL && temp->m_right != NULL)
+    {
+        link = &temp->m_right;
+        while((*link)->m_left != NULL)
+        {
+            link = &(*link)->m_left;
+        }
+        temp->m_value = (*link)->m_value;
+        temp = *link;
+    }
+
+    *link = (temp->m_left != NULL) ? temp->m_left : temp->m_right;
+    FreeNode(temp);
+    --m_numNodes;
+    bItemDeleted = true;
+    return nodePtr;
+
+}  // end of "CBSTree<NodeType>::Delete"
 
 
 
-// ==== CBSTree::ItemInTree ===================================================
+// ==== CBSTree::DeleteItem ===================================================
 //
-// This function allows the caller to determine if a target item is in the
-// tree. The input parameter is a const reference to the target tree node
-// value, and this function calls CBSTree::Retrieve to determine if it's in the
-// tree or not.
+// This function allows the caller to delete a target node from the tree.  A
+// small set simply erases the item from its array.  In lazy delete mode the
+// work is done by CBSTree::LazyDelete, and otherwise in BALANCE_SPLAY mode by
+// CBSTree::SplayDelete.  In BALANCE_SCAPEGOAT mode the whole tree is
+// rebalanced once it has shrunk below alpha times its largest size since the
+// last rebalance, and a tree that has shrunk to SMALL_MIN items becomes a
+// small set again.  If the filter is enabled, an item it shows to be absent
+// is rejected without a search, and a deleted item is removed from it.
 //
 // Access: public
 //
 // Input:
-//      target [IN]     -- a const reference to a NodeType object that contains
-//                         the target key value to search for
+//      target [IN]      -- a const reference to a NodeType object
 //
 // Output:
-//      A value of true if the target item is found, false if not.
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-bool    CBSTree<NodeType>::ItemInTree(const NodeType  &target) const
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::DeleteItem(const NodeType  &target)
 {
-    if(NULL == Retrieve(target, m_root))
+    CLatencyTimer   timer(SampleLatency(LATENCY_DELETE));
+    bool            bItemDeleted = false;
+
+    if(m_filter != NULL && !m_filter->MayContain(target))
     {
         return false;
     }
+
+    if(m_bSmallSet)
+    {
+        size_t  index = SmallBound(target, false);
+        if(index < m_smallItems.size()
+                            && Compare3(target, m_smallItems[index]) == 0)
+        {
+            m_smallItems.erase(m_smallItems.begin() + index);
+            --m_numNodes;
+            bItemDeleted = true;
+        }
+    }
+    else if(m_bLazyDelete)
+    {
+        bItemDeleted = LazyDelete(target);
+    }
+    else if(BALANCE_SPLAY == GetBalanceMode())
+    {
+        bItemDeleted = SplayDelete(target);
+    }
     else
     {
-        return true;
+        m_finger.clear();
+        m_bSpinesValid = false;
+        m_root = Delete(target, m_root, bItemDeleted);
+        if(BALANCE_SCAPEGOAT == GetBalanceMode()
+                                && m_numNodes < m_alpha * m_maxNodes)
+        {
+            RebalanceTree();
+        }
     }
 
-}  // end of "CBSTree<NodeType>::ItemInTree"
+    if(m_filter != NULL)
+    {
+        if(bItemDeleted)
+        {
+            m_filter->Remove(target);
+        }
+        else
+        {
+            m_filter->RecordFalsePositive();
+        }
+    }
+    if(bItemDeleted)
+    {
+        ShrinkToSmallSet();
+    }
+    return bItemDeleted;
 
+}  // end of "CBSTree<NodeType>::DeleteItem"
 
 
-// ==== CBSTree::PostOrder ====================================================
+
+// ==== CBSTree::DeleteRange ==================================================
 //
-// This function performs a post-order traversal through the tree, calling the
-// "fPtr" parameter for each node.
+// This function removes every item from lo to hi (inclusive) from the tree.
+// The range is detached in one piece by CBSTree::DetachRange and its nodes
+// are then freed together by CBSTree::ReleaseNodes; a small set erases the
+// range from its array with CBSTree::SmallEraseRange.
 //
-// Access: protected
+// Access: public
 //
 // Input:
-//      nodePtr [IN]    -- a pointer to a CTreeNode (this is a recursive
-//                         function, initially this points to the root)
+//      lo [IN]         -- the smallest item to remove
 //
-//      fPtr [IN]       -- a pointer to a non-member function that takes a
-//                         const reference to a NodeType object as input and
-//                         returns nothing
+//      hi [IN]         -- the largest item to remove
 //
 // Output:
-//      Nothing
+//      The number of items removed; zero if lo orders after hi.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::PostOrder(const CTreeNode<NodeType>  *const nodePtr
-                                        , void (*fPtr)(const NodeType&)) const
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::DeleteRange(const NodeType  &lo
+                                                , const NodeType  &hi)
 {
-    if(nodePtr == NULL)
+    CLatencyTimer       timer(SampleLatency(LATENCY_DELETE_RANGE));
+    TreeNode            *rangePtr;
+    size_t              numNodes;
+    size_t              numTombstones;
+
+    if(m_bSmallSet)
     {
-        return;
+        return SmallEraseRange(lo, hi, NULL);
     }
 
-    PostOrder(nodePtr->m_left, fPtr);
-    PostOrder(nodePtr->m_right, fPtr);
-    (*fPtr)(nodePtr->m_value);
+    rangePtr = DetachRange(lo, hi, numNodes, numTombstones);
+    ReleaseNodes(rangePtr);
+    RestoreBalance();
+    return numNodes - numTombstones;
 
-}  // end of "CBSTree<NodeType>::PostOrder"
+}  // end of "CBSTree<NodeType>::DeleteRange"
 
-// ==== CBSTree::PostOrderTraverse ============================================
+
+
+// ==== CBSTree::DestroyNodes =================================================
 //
-// This function allows the caller to execute a post-order traversal through
-// the tree, and have the "fPtr" parameter called for each node in the tree.
+// This function frees every node of a subtree without recursion, the way
+// CNodeReclaimer::FreeNodes does: while the current node has a left child,
+// that child is rotated up in its place, and once it has none, the node is
+// freed by CBSTree::FreeNode and its right child becomes current.  No stack
+// is needed however deep the subtree is.
 //
-// Access: public
+// Access: protected
 //
 // Input:
-//      fPtr [IN]   -- a pointer to a non-member function that takes a const
-//                     reference to a NodeType object as input, and returns
-//                     nothing
+//      nodePtr [IN/OUT]    -- a pointer to a tree node (initially the root)
 //
 // Output:
-//      Nothing
+//      Nothing.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::PostOrderTraverse(void  (*fPtr)(const NodeType&)) const
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::DestroyNodes(TreeNode  *nodePtr)
 {
-    PostOrder(m_root, *fPtr);
+    TreeNode *childPtr;
 
-}  // end of "CBSTree<NodeType>::PostOrderTraverse"
+    while(nodePtr != NULL)
+    {
+        childPtr = nodePtr->m_left;
+        if(childPtr != NULL)
+        {
+            nodePtr->m_left = childPtr->m_right;
+            childPtr->m_right = nodePtr;
+        }
+        else
+        {
+            childPtr = nodePtr->m_right;
+            FreeNode(nodePtr);
+        }
+        nodePtr = childPtr;
+    }
 
+}  // end of "CBSTree<ItemType>::DestroyNodes"
 
 
-// ==== CBSTree::PreOrder =====================================================
+
+// ==== CBSTree::DestroyTree ==================================================
 //
-// This function performs a pre-order traversal through the tree, calling the
-// "fPtr" parameter for each node.
+// This function removes every item from the tree.  In async release mode the
+// nodes, and the node block if there is one, are handed to the NodeType
+// reclaimer in O(1); otherwise, or if the nodes come from a pool that only
+// this tree can free them into, they are freed at once.  The tree is left as
+// an empty small set, and its settings are kept.
 //
-// Access: protected
+// Access: public
 //
 // Input:
-//      nodePtr [IN]    -- a pointer to a CTreeNode (this is a recursive
-//                         function, initially this points to the root)
-//
-//      fPtr [IN]       -- a pointer to a non-member function that takes a
-//                         const reference NodeType object as input, and returns
-//                         nothing
+//      Nothing
 //
 // Output:
 //      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::PreOrder(const CTreeNode<NodeType>  *const nodePtr
-                                    , void  (*fPtr)(const NodeType&)) const
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::DestroyTree()
 {
-    if(nodePtr == NULL)
+    if(m_bSmallSet)
     {
-        return;
+        // the small set is freed by MakeEmpty
+    }
+    else if(m_bAsyncRelease && AllocPolicy::IS_HEAP)
+    {
+        CNodeReclaimer<NodeType, TreeNode>::GetInstance().Release(m_root
+                                                        , m_arena
+                                                        , m_arenaSize);
+    }
+    else
+    {
+        DestroyNodes(m_root);
+        if(m_arena != NULL)
+        {
+            allocator<TreeNode>().deallocate(m_arena
+                                                        , m_arenaSize);
+        }
     }
 
-    (*fPtr)(nodePtr->m_value);
-    PreOrder(nodePtr->m_left, fPtr);
-    PreOrder(nodePtr->m_right, fPtr);
+    MakeEmpty();
+    m_arena = NULL;
+    m_arenaSize = 0;
+    m_freeSlots.clear();
+    m_finger.clear();
+    m_numNodes = m_numTombstones = 0;
+    m_maxNodes = 0;
+    if(m_filter != NULL)
+    {
+        m_filter->Clear();
+    }
+    m_bSpinesValid = false;
 
-}  // end of "CBSTree<NodeType>::PreOrder"
+}  // end of "CBSTree<NodeType>::DestroyTree"
 
 
 
-// ==== CBSTree::PreOrderTraverse =============================================
+// ==== CBSTree::DetachRange ==================================================
 //
-// This function allows the caller to execute a pre-order traversal through the
-// tree, and have the "fPtr" parameter called for each node in the tree.
+// This function unlinks every node from lo to hi (inclusive) from the tree
+// and returns them as a subtree of their own.  The tree is split at lo and
+// the upper part again at hi, then the parts below and above the range are
+// joined, all in O(height).  The detached nodes are then counted (and their
+// items removed from the filter) with an explicit stack, so only the size of
+// the range matters and not its shape.  The caller must dispose of the
+// detached nodes and then call CBSTree::RestoreBalance.
 //
-// Access: public
+// Access: protected
 //
 // Input:
-//      fPtr [IN]   -- a pointer to a non-member function that takes a const
-//                     reference to a NodeType object as input, and returns
-//                     nothing
+//      lo [IN]                 -- the smallest item to detach
+//
+//      hi [IN]                 -- the largest item to detach
+//
+//      numNodes [OUT]          -- set to the number of nodes detached
+//
+//      numTombstones [OUT]     -- set to how many of those are tombstones
 //
 // Output:
-//      Nothing
+//      A pointer to the root of the detached subtree, or NULL if the range
+//      holds no nodes.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::PreOrderTraverse(void (*fPtr)(const NodeType&)) const
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::DetachRange(
+                                        const NodeType  &lo
+                                        , const NodeType  &hi
+                                        , size_t  &numNodes
+                                        , size_t  &numTombstones)
 {
-    PreOrder(m_root, *fPtr);
+    vector<const TreeNode*>  pending;
+    TreeNode                            *lowerPtr;
+    TreeNode                            *rangePtr;
+    TreeNode                            *upperPtr;
 
-}  // end of "CBSTree<NodeType>::PreOrderTraverse"
+    numNodes = numTombstones = 0;
+    if(Compare3(lo, hi) > 0)
+    {
+        return NULL;
+    }
 
-// ==== CBSTree::RebalanceTree ================================================
+    Split(m_root, lo, false, lowerPtr, rangePtr);
+    Split(rangePtr, hi, true, rangePtr, upperPtr);
+    m_root = Join(lowerPtr, upperPtr);
+    m_finger.clear();
+    m_bSpinesValid = false;
+
+    if(rangePtr != NULL)
+    {
+        pending.push_back(rangePtr);
+    }
+    while(!pending.empty())
+    {
+        const TreeNode              *nodePtr = pending.back();
+        pending.pop_back();
+        ++numNodes;
+        if(nodePtr->m_bDeleted)
+        {
+            ++numTombstones;
+        }
+        else if(m_filter != NULL)
+        {
+            m_filter->Remove(nodePtr->m_value);
+        }
+        if(nodePtr->m_left != NULL)
+        {
+            pending.push_back(nodePtr->m_left);
+        }
+        if(nodePtr->m_right != NULL)
+        {
+            pending.push_back(nodePtr->m_right);
+        }
+    }
+    m_numNodes -= numNodes;
+    m_numTombstones -= numTombstones;
+    return rangePtr;
+
+}  // end of "CBSTree<NodeType>::DetachRange"
+
+
+// ==== CBSTree::DisableFilter ================================================
 //
-// This function rebalances the tree to an optimal height. It first derives the
-// number of nodes in the tree, then allocates a dynamic array to store all of
-// the tree's values. After that it saves the tree's values to the dynamic
-// array by calling CBSTree::SaveToArray, then releases all of the nodes in the
-// tree. Next, it calls the CBSTree::Repopulate function to repopulate the tree
-// with the array before releasing the array back to the heap.
+// This function removes the tree's Bloom filter, if it has one.  A tree built
+// without FEATURE_FILTER never has one, so for it this does nothing.
 //
 // Access: public
 //
@@ -673,187 +970,3531 @@ void    CBSTree<NodeType>::PreOrderTraverse(void (*fPtr)(const NodeType&)) const
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void        CBSTree<NodeType>::RebalanceTree()
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::DisableFilter()
 {
-    int numNodes, height;
-    GetTreeInfo(numNodes, height);
+    if constexpr (HasFeature(FEATURE_FILTER))
+    {
+        delete m_filter;
+        m_filter = NULL;
+    }
 
-    int *array = new int[numNodes+2];
+}  // end of "CBSTree<NodeType>::DisableFilter"
 
-    int index = 0;
-    SaveToArray(m_root, array, index);
 
-    DestroyTree();
-    Repopulate(array, 0, numNodes-1);
 
-    delete[] array;
+// ==== CBSTree::EnableFilter =================================================
+//
+// This function puts a counting Bloom filter in front of the tree (or resets
+// the one already there) and loads it with the items in the tree.  The filter
+// is sized for twice the current number of items, and at least 1024.  The
+// tree must be built with FEATURE_FILTER.
+//
+// Access: public
+//
+// Input:
+//      falsePosRate [IN]   -- the fraction of lookups for absent items that
+//                             the filter may let through to the tree
+//
+// Output:
+//      A value of true if the filter was enabled, or false if NodeType cannot
+//      be hashed with std::hash.
+//
+// ============================================================================
 
-}  // end of "CBSTree<NodeType>::RebalanceTree"
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::EnableFilter(double  falsePosRate)
+{
+    static_assert(HasFeature(FEATURE_FILTER)
+                        , "EnableFilter needs FEATURE_FILTER");
+    if(!CCountingBloomFilter<NodeType>::IS_HASHABLE)
+    {
+        return false;
+    }
+
+    if(m_filter == NULL)
+    {
+        m_filter = new CCountingBloomFilter<NodeType>;
+    }
+    RebuildFilter(falsePosRate);
+    return true;
 
+}  // end of "CBSTree<NodeType>::EnableFilter"
 
 
-// ==== CBSTree::Repopulate ===================================================
+
+// ==== CBSTree::ExtendSpines =================================================
 //
-// This function uses the contents of a sorted array to repopulate the tree.
-// The array is processed using 'divide and conquer' recursion so that the
-// middle element of the array is inserted into the tree, resulting in a
-// balanced binary tree.
+// This function brings the cached spines up to date after an insertion that
+// did not restructure the tree.  A new minimum always lands as the left child
+// of the old one, and a new maximum as the right child of the old one, so
+// only the ends of the spines need to be checked.  A small set has no spines.
 //
 // Access: protected
 //
 // Input:
-//      array [IN]      -- the base address of the array; it is assumed that
-//                         the values in the array are in sorted ascending order
-//
-//      first [IN]      -- an index to the first element
-//
-//      last [IN]       -- an index to the last element
+//      Nothing
 //
 // Output:
 //      Nothing
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void        CBSTree<NodeType>::Repopulate(const NodeType array[], int first
-                                                                , int last)
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::ExtendSpines()
 {
-    if(first > last)
+    if(!m_bSpinesValid || m_bSmallSet)
     {
         return;
     }
 
-    int mid = (first+last)/2;
-    Insert(array[mid], m_root);
-    Repopulate(array, first, mid-1);
-    Repopulate(array, mid+1, last);
+    if(m_minSpine.empty())
+    {
+        if(m_root != NULL)
+        {
+            m_minSpine.push_back(m_root);
+            m_maxSpine.push_back(m_root);
+        }
+        return;
+    }
 
-}  // end of "CBSTree<NodeType>::Repopulate"
+    if(m_minSpine.back()->m_left != NULL)
+    {
+        m_minSpine.push_back(m_minSpine.back()->m_left);
+    }
+    if(m_maxSpine.back()->m_right != NULL)
+    {
+        m_maxSpine.push_back(m_maxSpine.back()->m_right);
+    }
 
+}  // end of "CBSTree<NodeType>::ExtendSpines"
 
 
-// ==== CBSTree::Retrieve =====================================================
+
+// ==== CBSTree::ExtractRange =================================================
 //
-// This function finds the node in the tree whose value equals that of the
-// tree node reference parameter. The target node is located through recursive
-// function calls. If the node does not exist in the tree, a value of NULL is
-// returned.
+// This function moves every item from lo to hi (inclusive) out of the tree
+// and into another tree, for example to archive them.  The range is detached
+// in one piece by CBSTree::DetachRange and becomes the whole of the other
+// tree; whatever that tree held before is destroyed.  If this tree's nodes
+// are laid out in a block (see CBSTree::CompactLayout) or taken from a pool,
+// the range is copied out instead, since the block or pool is not the other
+// tree's to free, and a small set hands its range over with
+// CBSTree::SmallEraseRange.  Tombstones that came along with the range are
+// freed by compacting the other tree, and its filter, if it has one, is
+// reloaded.  Either tree may end up small enough to become a small set.
+// Both trees must order their items the same way.
 //
 // Access: public
 //
 // Input:
-//      target [IN]     -- a reference to a NodeType object; it is assumed that
-//                         the object is fully initialized so a search can be
-//                         performed
+//      lo [IN]         -- the smallest item to move
 //
-//      nodePtr [IN]    -- a pointer to a tree node (initially this is usually
-//                         the root)
+//      hi [IN]         -- the largest item to move
+//
+//      dest [OUT]      -- the tree that receives the items; it must not be
+//                         this tree
 //
 // Output:
-//      If a tree node is found that has the same value as the target
-//      parameter, then a pointer to the node in the tree is returned.
-//      Otherwise, a value of NULL is returned.
+//      The number of items moved; zero if lo orders after hi.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CTreeNode<NodeType>*  CBSTree<NodeType>::Retrieve(const NodeType  &target
-                                          , CTreeNode<NodeType>  *nodePtr) const
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::ExtractRange(const NodeType  &lo
+                                        , const NodeType  &hi
+                                        , CBSTREE_CLASS  &dest)
 {
-    if(nodePtr == NULL)
+    TreeNode            *rangePtr;
+    size_t              numNodes;
+    size_t              numTombstones;
+
+    if(&dest == this)
     {
-        return NULL;
+        return 0;
     }
 
-    if(target < nodePtr->m_value)
+    dest.DestroyTree();
+    if(m_bSmallSet)
     {
-        nodePtr = Retrieve(target, nodePtr->m_left);
+        return SmallEraseRange(lo, hi, &dest);
     }
-    else if(target > nodePtr->m_value)
+
+    rangePtr = DetachRange(lo, hi, numNodes, numTombstones);
+    dest.SwitchToNodes();
+    if(m_arena != NULL || !AllocPolicy::IS_HEAP)
     {
-        nodePtr = Retrieve(target, nodePtr->m_right);
+        dest.m_root = dest.CopyTree(rangePtr);
+        DestroyNodes(rangePtr);
     }
+    else
+    {
+        dest.m_root = rangePtr;
+    }
+    RestoreBalance();
+    dest.m_numNodes = dest.m_maxNodes = numNodes;
+    dest.m_numTombstones = numTombstones;
+    if(numTombstones > 0)
+    {
+        dest.CompactTree();
+    }
+    if(dest.m_filter != NULL)
+    {
+        dest.RebuildFilter(dest.m_filter->GetTargetRate());
+    }
+    dest.ShrinkToSmallSet();
+    return numNodes - numTombstones;
 
-    return nodePtr;
-
-}  // end of "CBSTree<NodeType>::Retrieve"
-
+}  // end of "CBSTree<NodeType>::ExtractRange"
 
 
-// ==== CBSTree::SaveToArray ==================================================
+// ==== CBSTree::FindFingerStart ==============================================
 //
-// This function does an inorder traversal of the tree so that the values in
-// the nodes can be written to the caller's array in sorted ascending order.
-//
-// This function performs an inorder traversal of the tree making recursive
-// calls so that the values in the nodes can be written to the caller's array
-// in sorted ascending order.
+// This function finds the deepest node on the finger path whose subtree is
+// where the new item belongs.  The subtrees along the path are nested, so the
+// steps that can hold the item form a prefix of the path and a binary search
+// over the path finds the last of them.  The end of the path is tried first,
+// since that is where in-order keys go.
 //
 // Access: protected
 //
 // Input:
-//      nodePtr[IN]     -- a ptr to a tree node, initially the root
-//
-//      array [IN]      -- the base address of the caller's array
-//
-//      index [IN/OUT]  -- a reference to the an int to be used for the index
-//                         into the array; as node values are copied into the
-//                         array, this index is incremented so the other
-//                         recursive stack frames immediately have the updated
-//                         index value to access the next element in the sorted
-//                         array
+//      newItem [IN]    -- a const reference to the item about to be inserted
 //
 // Output:
-//      Nothing
+//      The number of finger steps to keep (the position of the starting node
+//      plus one), or zero if there is no finger.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-void    CBSTree<NodeType>::SaveToArray(const CTreeNode<NodeType> *const nodePtr
-                                                            , NodeType array[]
-                                                            , int &index)
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::FindFingerStart(
+                                            const NodeType  &newItem) const
 {
-    if(nodePtr == NULL)
+    size_t  count = m_finger.size();
+    size_t  low;
+    size_t  high;
+    size_t  mid;
+
+    if(count == 0)
     {
-        return;
+        return 0;
     }
 
-    SaveToArray(nodePtr->m_left, array, index);
-    array[index] = nodePtr->m_value;
-    index++;
-    SaveToArray(nodePtr->m_right, array, index);
+    if(InFingerRange(newItem, count - 1))
+    {
+        return count;
+    }
 
-}  // end of "CBSTree<NodeType>::SaveToArray"
+    // the root's range is unbounded; the end of the path is known to fail
+    low = 0;
+    high = count - 1;
+    while(high - low > 1)
+    {
+        mid = low + (high - low) / 2;
+        if(InFingerRange(newItem, mid))
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
 
+    return low + 1;
 
+}  // end of "CBSTree<NodeType>::FindFingerStart"
 
-// ==== CBSTree::operator= ====================================================
+
+
+// ==== CBSTree::FindMinNode ==================================================
 //
-// This is the overloaded assignment operator for the CBSTree class. It first
-// checks for assignment to self, then releases all of the nodes in the calling
-// object. Then it uses the parameter as an argument to the CopyTree member
-// function so that the parameter's tree is replicated in the calling object.
+// This function finds the inorder successor of the node pointed to by the
+// parameter, and returns a pointer to the inorder successor node.
 //
-// Access: public
+// Access: protected
 //
 // Input:
-//      rhs [IN]    -- a const reference to an existing CBSTree object
+//      nodePtr [IN]    -- a pointer to a tree node
 //
 // Output:
-//      A reference to the calling object.
+//      A pointer to the target node.
 //
 // ============================================================================
 
-template    <typename  NodeType>
-CBSTree<NodeType>&  CBSTree<NodeType>::operator=(const CBSTree<NodeType> &rhs)
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::FindMinNode(
+                            TreeNode  *nodePtr) const
 {
-    if(this != &rhs)
+    while(nodePtr->m_left != NULL)
     {
-        DestroyTree();
-        m_root = CopyTree(rhs.m_root);
+        nodePtr = nodePtr->m_left;
     }
-    return *this;
+    return nodePtr;
 
-}  // end of "CBSTree<NodeType>::operator="
+}  // end of "CBSTree<NodeType>::FindMinNode"
+
+
+// ==== CBSTree::FingerInsert =================================================
+//
+// This function inserts a new node into the tree, starting the descent from
+// the node picked by CBSTree::FindFingerStart instead of from the root.  The
+// finger is cut back to that node and extended as the descent goes on, so
+// when the function returns it leads to the new node (or to the node that
+// already holds the item).
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree
+//      (or a tombstone for it was revived), false if it was already there.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::FingerInsert(const NodeType  &newItem)
+{
+    CFingerStep             step;
+    TreeNode                **link;
+    TreeNode                *nodePtr;
+    size_t                  parent;
+    size_t                  keep;
+
+    step.m_loBound = FINGER_NONE;
+    step.m_hiBound = FINGER_NONE;
+    if(m_root == NULL)
+    {
+        m_root = AllocNode(newItem);
+        ++m_numNodes;
+        step.m_node = m_root;
+        m_finger.clear();
+        m_finger.push_back(step);
+        return true;
+    }
+
+    keep = FindFingerStart(newItem);
+    if(keep == 0)
+    {
+        step.m_node = m_root;
+        m_finger.push_back(step);
+        keep = 1;
+    }
+    m_finger.resize(keep);
+
+    for(;;)
+    {
+        parent = m_finger.size() - 1;
+        nodePtr = m_finger[parent].m_node;
+
+        int result = Compare3(newItem, nodePtr->m_value);
+        if(result == 0)
+        {
+            if(nodePtr->m_bDeleted)
+            {
+                Revive(nodePtr, newItem);
+                return true;
+            }
+            return false;
+        }
+        else if(result < 0)
+        {
+            link = &nodePtr->m_left;
+            step.m_loBound = m_finger[parent].m_loBound;
+            step.m_hiBound = parent;
+        }
+        else
+        {
+            link = &nodePtr->m_right;
+            step.m_loBound = parent;
+            step.m_hiBound = m_finger[parent].m_hiBound;
+        }
+
+        if(*link == NULL)
+        {
+            *link = AllocNode(newItem);
+            ++m_numNodes;
+            step.m_node = *link;
+            m_finger.push_back(step);
+            return true;
+        }
+
+        step.m_node = *link;
+        m_finger.push_back(step);
+    }
+
+}  // end of "CBSTree<NodeType>::FingerInsert"
+
+
+
+// ==== CBSTree::FingerRetrieve ===============================================
+//
+// This function searches for a target, starting from the node at the end of
+// the finger when the target falls within that node's subtree, and from the
+// root otherwise.  Only the end of the finger is tried, so a lookup far from
+// the last insertion costs just two extra comparisons.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object, or to any
+//                         key the Compare object can compare against one
+//
+// Output:
+//      A pointer to the node holding the target, or NULL if it is not in the
+//      tree.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+template    <typename  KeyType>
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::FingerRetrieve(
+                                            const KeyType  &target) const
+{
+    if(!m_finger.empty() && InFingerRange(target, m_finger.size() - 1))
+    {
+        return Retrieve(target, m_finger.back().m_node);
+    }
+
+    return Retrieve(target, m_root);
+
+}  // end of "CBSTree<NodeType>::FingerRetrieve"
+
+
+
+// ==== CBSTree::FreeNode =====================================================
+//
+// This function frees a node that has been unlinked from the tree.  A node
+// in the node block is destroyed in place and its slot kept for reuse by
+// CBSTree::AllocNode; any other node is returned to the allocation policy.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the node to free
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::FreeNode(TreeNode  *nodePtr)
+{
+    if(InArena(nodePtr))
+    {
+        nodePtr->~TreeNode();
+        m_freeSlots.push_back(nodePtr);
+    }
+    else
+    {
+        AllocPolicy::DeleteNode(nodePtr);
+    }
+
+}  // end of "CBSTree<NodeType>::FreeNode"
+
+
+
+// ==== CBSTree::FirstLive ====================================================
+//
+// This function finds the live node nearest one end of the tree.  Normally
+// that is the last node on the spine, but if it is a tombstone the function
+// walks on in order from there (toward the other end) until it meets a live
+// node, working on a copy so that the cached spine is left alone.
+//
+// Access: protected
+//
+// Input:
+//      spine [IN]      -- the cached spine of that end
+//
+//      inner [IN]      -- the child link the spine follows (&m_left for the
+//                         minimum, &m_right for the maximum)
+//
+// Output:
+//      A pointer to the live node nearest that end, or NULL if there is none.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+const typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::FirstLive(
+                                const CSmallArray<TreeNode*>  &spine
+                                , ChildLink  inner) const
+{
+    ChildLink   outer = (inner == &TreeNode::m_left)
+                            ? &TreeNode::m_right
+                            : &TreeNode::m_left;
+
+    if(spine.empty() || !spine.back()->m_bDeleted)
+    {
+        return spine.empty() ? NULL : spine.back();
+    }
+
+    vector<TreeNode*>   pending(spine.begin(), spine.end());
+    while(!pending.empty())
+    {
+        TreeNode *nodePtr = pending.back();
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            return nodePtr;
+        }
+
+        for(nodePtr = nodePtr->*outer; nodePtr != NULL
+                                        ; nodePtr = nodePtr->*inner)
+        {
+            pending.push_back(nodePtr);
+        }
+    }
+
+    return NULL;
+
+}  // end of "CBSTree<NodeType>::FirstLive"
+
+
+// ==== CBSTree::GetFilterInfo ================================================
+//
+// This function reports how well the filter is working.
+//
+// Access: public
+//
+// Input:
+//      estimatedRate [OUT] -- the false-positive rate predicted from the size
+//                             of the filter and the number of items in it
+//
+//      observedRate [OUT]  -- the fraction of lookups and deletes of absent
+//                             items so far that the filter let through
+//
+// Output:
+//      A value of true if the filter is enabled, false if it is not (and the
+//      reference parameters are left alone).
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::GetFilterInfo(double  &estimatedRate
+                                                , double  &observedRate) const
+{
+    if(m_filter == NULL)
+    {
+        return false;
+    }
+
+    estimatedRate = m_filter->GetEstimatedRate();
+    observedRate = m_filter->GetObservedRate();
+    return true;
+
+}  // end of "CBSTree<NodeType>::GetFilterInfo"
+
+
+
+// ==== CBSTree::GetNumItems ==================================================
+//
+// This function returns the number of items in the tree, tombstones aside.
+// A tree built with FEATURE_COUNT keeps the count as it changes, so this
+// takes O(1); one built without it counts its nodes, in O(n).
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The number of items in the tree.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::GetNumItems() const
+{
+    if constexpr (HasFeature(FEATURE_COUNT))
+    {
+        return m_numNodes - m_numTombstones;
+    }
+    else
+    {
+        return m_bSmallSet ? m_smallItems.size() : SubtreeSize(m_root);
+    }
+
+}  // end of "CBSTree<NodeType>::GetNumItems"
+
+
+
+// ==== CBSTree::GetSpine =====================================================
+//
+// This function returns the spine of one end of the tree: the path from the
+// root to the smallest or to the largest node.  With FEATURE_SPINES that is
+// the cached spine, found first by CBSTree::BuildSpines if a change to the
+// tree has dropped it.  Without it the spine is walked into the scratch
+// array passed in, and that array is returned.
+//
+// Access: protected
+//
+// Input:
+//      inner [IN]      -- the child link the spine follows (&m_left for the
+//                         minimum, &m_right for the maximum)
+//
+//      scratch [OUT]   -- an array for a spine that is not cached
+//
+// Output:
+//      A reference to the spine.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+CSmallArray<typename CBSTREE_CLASS::TreeNode*>&  CBSTREE_CLASS::GetSpine(
+                                ChildLink  inner
+                                , CSmallArray<TreeNode*>  &scratch) const
+{
+    if constexpr (HasFeature(FEATURE_SPINES))
+    {
+        if(!m_bSpinesValid)
+        {
+            BuildSpines();
+        }
+        return (inner == &TreeNode::m_left) ? m_minSpine : m_maxSpine;
+    }
+    else
+    {
+        scratch.clear();
+        for(TreeNode *nodePtr = m_root; nodePtr != NULL
+                                        ; nodePtr = nodePtr->*inner)
+        {
+            scratch.push_back(nodePtr);
+        }
+        return scratch;
+    }
+
+}  // end of "CBSTree<NodeType>::GetSpine"
+
+
+
+// ==== CBSTree::GetTombstoneRatio ============================================
+//
+// This function reports the fraction of the tree's nodes that are tombstones.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The number of tombstones divided by the number of nodes, or zero if
+//      the tree is empty.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+double  CBSTREE_CLASS::GetTombstoneRatio() const
+{
+    if(m_numNodes == 0)
+    {
+        return 0.0;
+    }
+
+    return static_cast<double>(m_numTombstones) / m_numNodes;
+
+}  // end of "CBSTree<NodeType>::GetTombstoneRatio"
+
+
+
+// ==== CBSTree::GetTreeInfo ==================================================
+//
+// This function allows the caller to get the current number of nodes and the
+// height of the tree by calling the CBSTree::CountNodes member function.  A
+// small set reports its size, and the height of the balanced tree its array
+// stands for.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- a reference to a size_t that will contain the total
+//                         number of nodes currently in the tree
+//
+//      height [OUT]    -- a reference to a size_t that will contain the height
+//                         of the tree; this is the number of edges on the
+//                         longest path from the root to a leaf, and is zero
+//                         for a tree of one node or an empty tree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::GetTreeInfo(size_t  &numNodes
+                                                , size_t  &height) const
+{
+    if(m_bSmallSet)
+    {
+        numNodes = m_smallItems.size();
+        height = 0;
+        for(size_t count = m_smallItems.size(); count > 1; count /= 2)
+        {
+            ++height;
+        }
+        return;
+    }
+
+    height = CountNodes(m_root, numNodes);
+
+}  // end of "CBSTree::GetTreeInfo"
+
+
+// ==== CBSTree::GrowToNodes ==================================================
+//
+// This function turns a small set into a tree of nodes, when an insertion is
+// about to take it past SMALL_MAX items.  The items are already sorted, so
+// their nodes are chained into a vine and folded into a balanced tree by
+// CBSTree::VineToTree, as in CBSTree::BuildFromSorted.  The array's memory
+// is released, and the filter is left alone since the items do not change.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::GrowToNodes()
+{
+    TreeNode    *vinePtr = NULL;
+    TreeNode    **link = &vinePtr;
+    size_t      count = m_smallItems.size();
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        *link = AllocNode(m_smallItems[i]);
+        link = &(*link)->m_right;
+    }
+    SwitchToNodes();
+    m_root = vinePtr;
+    VineToTree(&m_root, count);
+    m_maxNodes = m_numNodes;
+
+}  // end of "CBSTree<NodeType>::GrowToNodes"
+
+
+
+// ==== CBSTree::InArena ======================================================
+//
+// This function determines if a node lives in the node block allocated by
+// CBSTree::CompactLayout.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a node
+//
+// Output:
+//      A value of true if the node is in the block, false if it came from
+//      the heap.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::InArena(
+                                const TreeNode  *nodePtr) const
+{
+    return (m_arena != NULL && nodePtr >= m_arena
+                                && nodePtr < m_arena + m_arenaSize);
+
+}  // end of "CBSTree<NodeType>::InArena"
+
+
+
+// ==== CBSTree::InFingerRange ================================================
+//
+// This function determines whether a target lies strictly between the bounds
+// of the subtree rooted at a given step of the finger path.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object, or to any
+//                         key the Compare object can compare against one
+//
+//      step [IN]       -- the position of a node on the finger path
+//
+// Output:
+//      A value of true if the target belongs in that node's subtree, false
+//      if not.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+template    <typename  KeyType>
+bool    CBSTREE_CLASS::InFingerRange(const KeyType  &target
+                                                    , size_t  step) const
+{
+    const CFingerStep   &entry = m_finger[step];
+
+    if(entry.m_loBound != FINGER_NONE
+        && Compare3(target, m_finger[entry.m_loBound].m_node->m_value) <= 0)
+    {
+        return false;
+    }
+
+    if(entry.m_hiBound != FINGER_NONE
+        && Compare3(target, m_finger[entry.m_hiBound].m_node->m_value) >= 0)
+    {
+        return false;
+    }
+
+    return true;
+
+}  // end of "CBSTree<NodeType>::InFingerRange"
+
+
+
+// ==== CBSTree::InOrder ======================================================
+//
+// This function performs an in-order traversal through the tree, calling the
+// "fPtr" parameter for each node that is not a tombstone.  The nodes whose
+// left subtrees are still being visited are kept on an explicit stack, so
+// the depth of the tree does not matter.  The tree is not modified on the
+// way (as a threaded Morris traversal would), so "fPtr" may look the tree up
+// and other readers may traverse it at the same time.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a tree node (initially this points to
+//                         the root)
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference to a NodeType object as input, and
+//                         returns nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::InOrder(const TreeNode  *nodePtr
+                                    , void (*fPtr)(const NodeType&)) const
+{
+    vector<const TreeNode*>  pending;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+
+        nodePtr = pending.back();
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            (*fPtr)(nodePtr->m_value);
+        }
+        nodePtr = nodePtr->m_right;
+    }
+
+}  // end of "CBSTree<NodeType>::InOrder"
+
+
+
+// ==== CBSTree::InOrderTraverse ==============================================
+//
+// This function allows the caller to execute an in-order traversal through the
+// tree, and have the "fPtr" parameter called for each node in the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a NodeType object as input, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::InOrderTraverse(
+                                    void  (*fPtr)(const NodeType&)) const
+{
+    if(m_bSmallSet)
+    {
+        for(size_t i = 0; i < m_smallItems.size(); ++i)
+        {
+            (*fPtr)(m_smallItems[i]);
+        }
+        return;
+    }
+
+    InOrder(m_root, *fPtr);
+
+}  // end of "CBSTree<NodeType>::InOrderTraverse"
+
+
+
+// ==== CBSTree::Insert =======================================================
+//
+// This function inserts a new node into the tree.  It finds the correct
+// location for the new node with a loop that keeps the address of the link
+// leading to the current node, making one three-way comparison per level.
+// If the new item is unique, a copy is created and stored in the empty link
+// the search ends on. Then the address of the (potentially new) root of the
+// tree is returned.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference to a NodeType object; it is
+//                         assumed that the object is initialized and ready to
+//                         be inserted
+//
+//      nodePtr [IN]    -- a pointer to a tree node (initially this is usually
+//                         the root)
+//
+//      bInserted [OUT] -- a reference to a bool that is set to true if a new
+//                         node was added or a tombstone revived, or false if
+//                         the item was already in the tree
+//
+// Output:
+//      A pointer to the (potentially new) root of the tree
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::Insert(
+                                        const NodeType  &newItem
+                                        , TreeNode  *nodePtr
+                                        , bool  &bInserted)
+{
+    TreeNode **link = &nodePtr;
+
+    while(*link != NULL)
+    {
+        int result = Compare3(newItem, (*link)->m_value);
+        if(result < 0)
+        {
+            link = &(*link)->m_left;
+        }
+        else if(result > 0)
+        {
+            link = &(*link)->m_right;
+        }
+        else if((*link)->m_bDeleted)
+        {
+            Revive(*link, newItem);
+            bInserted = true;
+            return nodePtr;
+        }
+        else
+        {
+            bInserted = false;
+            return nodePtr;
+        }
+    }
+
+    *link = AllocNode(newItem);
+    ++m_numNodes;
+    bInserted = true;
+    return nodePtr;
+
+}  // end of "CBSTree<NodeType>::Insert"
+
+
+
+// ==== CBSTree::Join =========================================================
+//
+// This function joins two subtrees, every item of the first ordering before
+// every item of the second.  The smallest node of the right subtree is
+// unlinked and becomes the root, with the left subtree on its left and the
+// rest of the right subtree on its right, so the result is only one level
+// taller than the taller of the two.
+//
+// Access: protected
+//
+// Input:
+//      leftTree [IN]   -- the root of the subtree with the smaller items
+//
+//      rightTree [IN]  -- the root of the subtree with the larger items
+//
+// Output:
+//      A pointer to the root of the joined tree.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::Join(
+                                        TreeNode  *leftTree
+                                        , TreeNode  *rightTree)
+{
+    TreeNode **link = &rightTree;
+    TreeNode *rootPtr;
+
+    if(leftTree == NULL || rightTree == NULL)
+    {
+        return (leftTree != NULL) ? leftTree : rightTree;
+    }
+
+    while((*link)->m_left != NULL)
+    {
+        link = &(*link)->m_left;
+    }
+    rootPtr = *link;
+    *link = rootPtr->m_right;
+    rootPtr->m_left = leftTree;
+    rootPtr->m_right = rightTree;
+    return rootPtr;
+
+}  // end of "CBSTree<NodeType>::Join"
+
+
+
+// ==== CBSTree::InsertItem ===================================================
+//
+// This function allows the caller to insert a new node into the tree.  The
+// input parameter is a const reference to the item to insert.  A small set
+// inserts the item into its array, after turning into a tree of nodes with
+// CBSTree::GrowToNodes if the array is full.  Otherwise, in
+// BALANCE_SPLAY mode the work is done by CBSTree::SplayInsert, in
+// BALANCE_SCAPEGOAT mode by CBSTree::ScapegoatInsert, and otherwise by
+// CBSTree::FingerInsert unless the finger has been turned off.  A new item
+// is also added to the filter, if it is enabled, and the filter is regrown
+// once the tree holds more items than it was sized for.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree,
+//      false otherwise.
+//
+// ============================================================================
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::InsertItem(const NodeType  &newItem)
+{
+    CLatencyTimer   timer(SampleLatency(LATENCY_INSERT));
+    bool            bInserted = false;
+
+    if(m_bSmallSet)
+    {
+        size_t  index = SmallBound(newItem, false);
+        if(index < m_smallItems.size()
+                            && Compare3(newItem, m_smallItems[index]) == 0)
+        {
+            return false;
+        }
+
+        if(m_smallItems.size() < SMALL_MAX)
+        {
+            m_smallItems.insert(m_smallItems.begin() + index, newItem);
+            ++m_numNodes;
+            bInserted = true;
+        }
+        else
+        {
+            GrowToNodes();
+        }
+    }
+
+    if(!m_bSmallSet)
+    {
+        if(BALANCE_SPLAY == GetBalanceMode())
+        {
+            bInserted = SplayInsert(newItem);
+        }
+        else if(BALANCE_SCAPEGOAT == GetBalanceMode())
+        {
+            bInserted = ScapegoatInsert(newItem);
+        }
+        else if(m_bUseFinger)
+        {
+            bInserted = FingerInsert(newItem);
+        }
+        else
+        {
+            m_root = Insert(newItem, m_root, bInserted);
+        }
+    }
+
+    if(bInserted)
+    {
+        ExtendSpines();
+    }
+    if(bInserted && m_filter != NULL)
+    {
+        if(m_filter->GetNumItems() < m_filter->GetCapacity())
+        {
+            m_filter->Insert(newItem);
+        }
+        else
+        {
+            RebuildFilter(m_filter->GetTargetRate());
+        }
+    }
+    return bInserted;
+
+}  // end of "CBSTree<NodeType>::InsertItem"
+
+
+
+// ==== CBSTree::ItemInTree ===================================================
+//
+// This function allows the caller to determine if a target item is in the
+// tree. The input parameter is a const reference to the target tree node
+// value, and this function calls CBSTree::FingerRetrieve to determine if it's
+// in the tree or not.  In BALANCE_SPLAY mode CBSTree::Splay is called instead, which
+// leaves the target (or the last node on its search path) at the root.  A
+// small set is searched with CBSTree::SmallBound.  If the filter is enabled
+// and shows that the target is absent, the tree is not searched at all.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object that contains
+//                         the target key value to search for
+//
+// Output:
+//      A value of true if the target item is found, false if not.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::ItemInTree(const NodeType  &target) const
+{
+    CLatencyTimer   timer(SampleLatency(LATENCY_FIND));
+    bool            bFound;
+
+    if(m_filter != NULL && !m_filter->MayContain(target))
+    {
+        return false;
+    }
+
+    if(m_bSmallSet)
+    {
+        size_t  index = SmallBound(target, false);
+        bFound = (index < m_smallItems.size()
+                            && Compare3(target, m_smallItems[index]) == 0);
+    }
+    else if(BALANCE_SPLAY == GetBalanceMode())
+    {
+        m_root = Splay(target, m_root);
+        bFound = (m_root != NULL && !m_root->m_bDeleted
+                            && Compare3(target, m_root->m_value) == 0);
+    }
+    else
+    {
+        TreeNode *nodePtr = FingerRetrieve(target);
+        bFound = (NULL != nodePtr && !nodePtr->m_bDeleted);
+    }
+
+    if(!bFound && m_filter != NULL)
+    {
+        m_filter->RecordFalsePositive();
+    }
+    return bFound;
+
+}  // end of "CBSTree<NodeType>::ItemInTree"
+
+
+
+// ==== CBSTree::ItemInTree ===================================================
+//
+// This overload searches the tree with a key of some other type, for example
+// a string_view in a tree of std::string.  It is only available when the
+// Compare object is transparent, and no NodeType temporary is built.  Like the
+// NodeType version, it splays in BALANCE_SPLAY mode and searches the array of
+// a small set.  It does not consult the filter, since a key of another type
+// need not hash like the equal NodeType.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a key that the Compare object
+//                         can compare against a NodeType object
+//
+// Output:
+//      A value of true if the target item is found, false if not.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+template    <typename  KeyType, typename  Cmp, typename>
+bool    CBSTREE_CLASS::ItemInTree(const KeyType  &target) const
+{
+    CLatencyTimer   timer(SampleLatency(LATENCY_FIND));
+
+    if(m_bSmallSet)
+    {
+        size_t  index = SmallBound(target, false);
+        return (index < m_smallItems.size()
+                            && Compare3(target, m_smallItems[index]) == 0);
+    }
+
+    if(BALANCE_SPLAY == GetBalanceMode())
+    {
+        m_root = Splay(target, m_root);
+        return (m_root != NULL && !m_root->m_bDeleted
+                            && Compare3(target, m_root->m_value) == 0);
+    }
+
+    TreeNode *nodePtr = FingerRetrieve(target);
+    return (NULL != nodePtr && !nodePtr->m_bDeleted);
+
+}  // end of "CBSTree<NodeType>::ItemInTree"
+
+// ==== CBSTree::ItemsInTree ==================================================
+//
+// This function looks up a batch of keys.  The keys are taken BATCH_WIDTH at
+// a time, and each pass over a group moves every unfinished search down one
+// level and prefetches the node it will compare against next.  By the time a
+// search comes around again its node is usually in the cache, because the
+// other searches in the group were working in the meantime.  Tombstones are
+// reported as absent, and nothing is splayed.  The array of a small set fits
+// in a few cache lines, so its keys are simply searched one after another.
+//
+// Access: public
+//
+// Input:
+//      keys [IN]       -- an array of count keys to look up
+//
+//      count [IN]      -- the number of keys
+//
+//      results [OUT]   -- an array of count flags; results[i] is set to true
+//                         if keys[i] is in the tree, false otherwise
+//
+// Output:
+//      The number of keys that were found.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::ItemsInTree(const NodeType  keys[]
+                                                , size_t  count
+                                                , bool  results[]) const
+{
+    TreeNode            *cursor[BATCH_WIDTH];
+    TreeNode            *nodePtr;
+    size_t              numFound = 0;
+
+    if(m_bSmallSet)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            size_t  index = SmallBound(keys[i], false);
+            results[i] = (index < m_smallItems.size()
+                            && Compare3(keys[i], m_smallItems[index]) == 0);
+            if(results[i])
+            {
+                ++numFound;
+            }
+        }
+        return numFound;
+    }
+
+    for(size_t first = 0; first < count; first += BATCH_WIDTH)
+    {
+        size_t  width = (count - first < BATCH_WIDTH) ? count - first
+                                                      : BATCH_WIDTH;
+        size_t  numActive = 0;
+        for(size_t i = 0; i < width; ++i)
+        {
+            results[first + i] = false;
+            cursor[i] = m_root;
+            if(cursor[i] != NULL)
+            {
+                ++numActive;
+            }
+        }
+
+        while(numActive > 0)
+        {
+            for(size_t i = 0; i < width; ++i)
+            {
+                nodePtr = cursor[i];
+                if(nodePtr == NULL)
+                {
+                    continue;
+                }
+
+                int result = Compare3(keys[first + i], nodePtr->m_value);
+                if(result == 0)
+                {
+                    if(!nodePtr->m_bDeleted)
+                    {
+                        results[first + i] = true;
+                        ++numFound;
+                    }
+                    nodePtr = NULL;
+                }
+                else
+                {
+                    nodePtr = (result < 0) ? nodePtr->m_left
+                                           : nodePtr->m_right;
+                }
+
+                cursor[i] = nodePtr;
+                if(nodePtr == NULL)
+                {
+                    --numActive;
+                }
+                else
+                {
+                    CBSTREE_PREFETCH(nodePtr);
+                }
+            }
+        }
+    }
+
+    return numFound;
+
+}  // end of "CBSTree<NodeType>::ItemsInTree"
+
+
+
+// ==== CBSTree::LazyDelete ===================================================
+//
+// This function deletes a target item in lazy delete mode.  The target's node
+// is found (splaying it to the root in BALANCE_SPLAY mode) and marked as a
+// tombstone; the tree's shape is not touched.  If the share of tombstones
+// then exceeds the limit given to CBSTree::SetLazyDelete, the tree is
+// compacted.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]      -- a const reference to a NodeType object
+//
+// Output:
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::LazyDelete(const NodeType  &target)
+{
+    TreeNode *nodePtr;
+
+    if(BALANCE_SPLAY == GetBalanceMode())
+    {
+        m_root = Splay(target, m_root);
+        nodePtr = (m_root != NULL && Compare3(target, m_root->m_value) == 0)
+                                                            ? m_root : NULL;
+    }
+    else
+    {
+        nodePtr = FingerRetrieve(target);
+    }
+
+    if(nodePtr == NULL || nodePtr->m_bDeleted)
+    {
+        return false;
+    }
+
+    nodePtr->m_bDeleted = true;
+    ++m_numTombstones;
+    if(GetTombstoneRatio() > m_maxTombstoneRatio)
+    {
+        CompactTree();
+    }
+    return true;
+
+}  // end of "CBSTree<NodeType>::LazyDelete"
+
+
+// ==== CBSTree::LowerBound ===================================================
+//
+// This function finds the live node with the smallest value that does not
+// order before the target.  LowerBounds only calls it when its batched
+// search ends on a tombstone, since the answer then may lie in a subtree
+// that search did not enter.  The nodes that do not order before the target
+// are visited in order, with an explicit stack, skipping every subtree that
+// orders wholly before it, until one of them turns out to be live.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to the key to search for
+//
+//      nodePtr [IN]    -- a pointer to a tree node (initially this is usually
+//                         the root)
+//
+// Output:
+//      A pointer to the node holding the lower bound, or NULL if every live
+//      value in the subtree orders before the target.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::LowerBound(
+                                        const NodeType  &target
+                                        , TreeNode  *nodePtr) const
+{
+    vector<TreeNode*>               pending;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        if(nodePtr != NULL)
+        {
+            if(Compare3(nodePtr->m_value, target) < 0)
+            {
+                nodePtr = nodePtr->m_right;
+            }
+            else
+            {
+                pending.push_back(nodePtr);
+                nodePtr = nodePtr->m_left;
+            }
+            continue;
+        }
+
+        nodePtr = pending.back();
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            return nodePtr;
+        }
+        nodePtr = nodePtr->m_right;
+    }
+
+    return NULL;
+
+}  // end of "CBSTree<NodeType>::LowerBound"
+
+
+
+// ==== CBSTree::LowerBounds ==================================================
+//
+// This function finds the lower bound (the smallest value in the tree that
+// does not order before the key) of each key in a batch.  The searches run
+// in lockstep groups with prefetching, just as in CBSTree::ItemsInTree; each
+// one remembers the last node at which it turned left, which is the lower
+// bound once the search falls off the tree.  If that node is a tombstone the
+// key is searched again by CBSTree::LowerBound, which skips tombstones.  The
+// keys are searched one after another in the array of a small set.
+//
+// Access: public
+//
+// Input:
+//      keys [IN]       -- an array of count keys to search for
+//
+//      count [IN]      -- the number of keys
+//
+//      results [OUT]   -- an array of count pointers; results[i] is set to
+//                         the value in the tree that is the lower bound of
+//                         keys[i], or NULL if there is none.  The pointers
+//                         stay valid until the tree is next changed.
+//
+// Output:
+//      The number of keys that have a lower bound.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::LowerBounds(const NodeType  keys[]
+                                                , size_t  count
+                                                , const NodeType  *results[])
+                                                                        const
+{
+    TreeNode            *cursor[BATCH_WIDTH];
+    TreeNode            *bound[BATCH_WIDTH];
+    TreeNode            *nodePtr;
+    size_t              numFound = 0;
+
+    if(m_bSmallSet)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            size_t  index = SmallBound(keys[i], false);
+            results[i] = (index < m_smallItems.size()) ? &m_smallItems[index]
+                                                        : NULL;
+            if(results[i] != NULL)
+            {
+                ++numFound;
+            }
+        }
+        return numFound;
+    }
+
+    for(size_t first = 0; first < count; first += BATCH_WIDTH)
+    {
+        size_t  width = (count - first < BATCH_WIDTH) ? count - first
+                                                      : BATCH_WIDTH;
+        size_t  numActive = 0;
+        for(size_t i = 0; i < width; ++i)
+        {
+            bound[i] = NULL;
+            cursor[i] = m_root;
+            if(cursor[i] != NULL)
+            {
+                ++numActive;
+            }
+        }
+
+        while(numActive > 0)
+        {
+            for(size_t i = 0; i < width; ++i)
+            {
+                nodePtr = cursor[i];
+                if(nodePtr == NULL)
+                {
+                    continue;
+                }
+
+                int result = Compare3(keys[first + i], nodePtr->m_value);
+                if(result == 0)
+                {
+                    bound[i] = nodePtr;
+                    nodePtr = NULL;
+                }
+                else if(result < 0)
+                {
+                    bound[i] = nodePtr;
+                    nodePtr = nodePtr->m_left;
+                }
+                else
+                {
+                    nodePtr = nodePtr->m_right;
+                }
+
+                cursor[i] = nodePtr;
+                if(nodePtr == NULL)
+                {
+                    --numActive;
+                }
+                else
+                {
+                    CBSTREE_PREFETCH(nodePtr);
+                }
+            }
+        }
+
+        for(size_t i = 0; i < width; ++i)
+        {
+            nodePtr = bound[i];
+            if(nodePtr != NULL && nodePtr->m_bDeleted)
+            {
+                nodePtr = LowerBound(keys[first + i], m_root);
+            }
+
+            results[first + i] = (nodePtr == NULL) ? NULL : &nodePtr->m_value;
+            if(nodePtr != NULL)
+            {
+                ++numFound;
+            }
+        }
+    }
+
+    return numFound;
+
+}  // end of "CBSTree<NodeType>::LowerBounds"
+
+
+
+// ==== CBSTree::Max ==========================================================
+//
+// This function retrieves the largest item in the tree from the right spine
+// (see CBSTree::GetSpine), which is O(1) when the spine is cached.  A
+// small set reads the last end of its array.
+//
+// Access: public
+//
+// Input:
+//      item [OUT]      -- set to a copy of the largest item
+//
+// Output:
+//      A value of true if the tree holds an item, false if it is empty (and
+//      item is left alone).
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::Max(NodeType  &item) const
+{
+    const TreeNode          *nodePtr;
+    CSmallArray<TreeNode*>  scratch;
+
+    if(m_bSmallSet)
+    {
+        if(m_smallItems.empty())
+        {
+            return false;
+        }
+
+        item = m_smallItems.back();
+        return true;
+    }
+
+    nodePtr = FirstLive(GetSpine(&TreeNode::m_right, scratch)
+                                                    , &TreeNode::m_right);
+    if(nodePtr == NULL)
+    {
+        return false;
+    }
+
+    item = nodePtr->m_value;
+    return true;
+
+}  // end of "CBSTree<NodeType>::Max"
+
+
+
+// ==== CBSTree::Min ==========================================================
+//
+// This function retrieves the smallest item in the tree from the left spine
+// (see CBSTree::GetSpine), which is O(1) when the spine is cached.  A
+// small set reads the first end of its array.
+//
+// Access: public
+//
+// Input:
+//      item [OUT]      -- set to a copy of the smallest item
+//
+// Output:
+//      A value of true if the tree holds an item, false if it is empty (and
+//      item is left alone).
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::Min(NodeType  &item) const
+{
+    const TreeNode          *nodePtr;
+    CSmallArray<TreeNode*>  scratch;
+
+    if(m_bSmallSet)
+    {
+        if(m_smallItems.empty())
+        {
+            return false;
+        }
+
+        item = m_smallItems.front();
+        return true;
+    }
+
+    nodePtr = FirstLive(GetSpine(&TreeNode::m_left, scratch)
+                                                    , &TreeNode::m_left);
+    if(nodePtr == NULL)
+    {
+        return false;
+    }
+
+    item = nodePtr->m_value;
+    return true;
+
+}  // end of "CBSTree<NodeType>::Min"
+
+
+
+// ==== CBSTree::PopExtreme ===================================================
+//
+// This function does the work of PopMin and PopMax.  The node at the end of
+// the spine has no child on the inner side, so it is unlinked by putting its
+// outer child in its place, and the inner spine of that child is pushed onto
+// the spine; over a run of pops each node is pushed once, which makes a pop
+// O(1) amortized.  Tombstones reached this way are freed and skipped.  The
+// root is the first node of both spines, so if it is popped the other spine
+// loses its first node too; the spines are CSmallArrays, which drop their
+// first item in O(1), so a run of pops that each take the root stays O(1)
+// per pop.  A small set takes the item off its end of the array, which is
+// O(1) at either end, and a tree that has shrunk to SMALL_MIN items becomes
+// a small set again.
+//
+// Access: protected
+//
+// Input:
+//      item [OUT]      -- set to the item that was removed
+//
+//      inner [IN]      -- &CTreeNode::m_left to pop the minimum, or
+//                         &CTreeNode::m_right to pop the maximum
+//
+// Output:
+//      A value of true if an item was removed, false if the tree was empty.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::PopExtreme(NodeType  &item
+                                                , ChildLink  inner)
+{
+    CLatencyTimer   timer(SampleLatency(LATENCY_POP));
+    bool        bMin = (inner == &TreeNode::m_left);
+    ChildLink   outer = bMin ? &TreeNode::m_right
+                             : &TreeNode::m_left;
+    bool        bPopped = false;
+
+    if(m_bSmallSet)
+    {
+        if(m_smallItems.empty())
+        {
+            return false;
+        }
+
+        item = bMin ? m_smallItems.front() : m_smallItems.back();
+        m_smallItems.erase(bMin ? m_smallItems.begin()
+                                : m_smallItems.end() - 1);
+        --m_numNodes;
+        if(m_filter != NULL)
+        {
+            m_filter->Remove(item);
+        }
+        return true;
+    }
+
+    CSmallArray<TreeNode*>  scratch;
+    CSmallArray<TreeNode*>  &spine = GetSpine(inner, scratch);
+    while(!bPopped && !spine.empty())
+    {
+        TreeNode *nodePtr = spine.back();
+        spine.pop_back();
+
+        TreeNode **link = spine.empty() ? &m_root
+                                                   : &(spine.back()->*inner);
+        *link = nodePtr->*outer;
+        for(TreeNode *childPtr = nodePtr->*outer; childPtr != NULL
+                                            ; childPtr = childPtr->*inner)
+        {
+            spine.push_back(childPtr);
+        }
+        if constexpr (HasFeature(FEATURE_SPINES))
+        {
+            CSmallArray<TreeNode*>  &other = bMin ? m_maxSpine
+                                                  : m_minSpine;
+            if(!other.empty() && other.front() == nodePtr)
+            {
+                other.erase(other.begin());
+            }
+        }
+
+        bPopped = !nodePtr->m_bDeleted;
+        if(bPopped)
+        {
+            item = nodePtr->m_value;
+        }
+        else
+        {
+            --m_numTombstones;
+        }
+        --m_numNodes;
+        FreeNode(nodePtr);
+    }
+
+    m_finger.clear();
+    if(!bPopped)
+    {
+        return false;
+    }
+
+    if(m_filter != NULL)
+    {
+        m_filter->Remove(item);
+    }
+    if(BALANCE_SCAPEGOAT == GetBalanceMode()
+                                        && m_numNodes < m_alpha * m_maxNodes)
+    {
+        RebalanceTree();
+    }
+    ShrinkToSmallSet();
+    return true;
+
+}  // end of "CBSTree<NodeType>::PopExtreme"
+
+
+
+// ==== CBSTree::PopMax =======================================================
+//
+// This function removes the largest item from the tree and hands it back to
+// the caller, by calling CBSTree::PopExtreme.
+//
+// Access: public
+//
+// Input:
+//      item [OUT]      -- set to the item that was removed
+//
+// Output:
+//      A value of true if an item was removed, false if the tree was empty.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::PopMax(NodeType  &item)
+{
+    return PopExtreme(item, &TreeNode::m_right);
+
+}  // end of "CBSTree<NodeType>::PopMax"
+
+
+
+// ==== CBSTree::PopMin =======================================================
+//
+// This function removes the smallest item from the tree and hands it back to
+// the caller, by calling CBSTree::PopExtreme.
+//
+// Access: public
+//
+// Input:
+//      item [OUT]      -- set to the item that was removed
+//
+// Output:
+//      A value of true if an item was removed, false if the tree was empty.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::PopMin(NodeType  &item)
+{
+    return PopExtreme(item, &TreeNode::m_left);
+
+}  // end of "CBSTree<NodeType>::PopMin"
+
+
+
+// ==== CBSTree::PostOrder ====================================================
+//
+// This function performs a post-order traversal through the tree, calling the
+// "fPtr" parameter for each node that is not a tombstone.  The path down to
+// the current node is kept on an explicit stack, and a node is visited once
+// its right subtree is done, which is known when the node last visited is
+// its right child (or it has none).
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a CTreeNode (initially this points to
+//                         the root)
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference to a NodeType object as input and
+//                         returns nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::PostOrder(const TreeNode  *nodePtr
+                                    , void (*fPtr)(const NodeType&)) const
+{
+    vector<const TreeNode*>  pending;
+    const TreeNode                      *lastPtr = NULL;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+
+        nodePtr = pending.back();
+        if(nodePtr->m_right != NULL && nodePtr->m_right != lastPtr)
+        {
+            nodePtr = nodePtr->m_right;
+            continue;
+        }
+
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            (*fPtr)(nodePtr->m_value);
+        }
+        lastPtr = nodePtr;
+        nodePtr = NULL;
+    }
+
+}  // end of "CBSTree<NodeType>::PostOrder"
+
+// ==== CBSTree::PostOrderTraverse ============================================
+//
+// This function allows the caller to execute a post-order traversal through
+// the tree, and have the "fPtr" parameter called for each node in the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a NodeType object as input, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::PostOrderTraverse(
+                                    void  (*fPtr)(const NodeType&)) const
+{
+    if(m_bSmallSet)
+    {
+        SmallOrder(0, m_smallItems.size(), false, *fPtr);
+        return;
+    }
+
+    PostOrder(m_root, *fPtr);
+
+}  // end of "CBSTree<NodeType>::PostOrderTraverse"
+
+
+
+// ==== CBSTree::PreOrder =====================================================
+//
+// This function performs a pre-order traversal through the tree, calling the
+// "fPtr" parameter for each node that is not a tombstone.  It runs down the
+// left links visiting each node, and keeps the right children it passes on
+// an explicit stack to be visited after the left subtree.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a CTreeNode (initially this points to
+//                         the root)
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference NodeType object as input, and
+//                         returns nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::PreOrder(const TreeNode  *nodePtr
+                                    , void  (*fPtr)(const NodeType&)) const
+{
+    vector<const TreeNode*>  pending;
+
+    for(;;)
+    {
+        while(nodePtr != NULL)
+        {
+            if(!nodePtr->m_bDeleted)
+            {
+                (*fPtr)(nodePtr->m_value);
+            }
+            if(nodePtr->m_right != NULL)
+            {
+                pending.push_back(nodePtr->m_right);
+            }
+            nodePtr = nodePtr->m_left;
+        }
+
+        if(pending.empty())
+        {
+            break;
+        }
+        nodePtr = pending.back();
+        pending.pop_back();
+    }
+
+}  // end of "CBSTree<NodeType>::PreOrder"
+
+
+
+// ==== CBSTree::PreOrderTraverse =============================================
+//
+// This function allows the caller to execute a pre-order traversal through the
+// tree, and have the "fPtr" parameter called for each node in the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a NodeType object as input, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::PreOrderTraverse(
+                                    void (*fPtr)(const NodeType&)) const
+{
+    if(m_bSmallSet)
+    {
+        SmallOrder(0, m_smallItems.size(), true, *fPtr);
+        return;
+    }
+
+    PreOrder(m_root, *fPtr);
+
+}  // end of "CBSTree<NodeType>::PreOrderTraverse"
+
+// ==== CBSTree::RebalanceTree ================================================
+//
+// This function rebalances the tree to an optimal height in place, using the
+// Day-Stout-Warren algorithm.  CBSTree::TreeToVine first rotates the tree into
+// a "vine" (a sorted list linked through the right children), freeing any
+// tombstones on the way, then CBSTree::VineToTree folds the vine back into a
+// balanced tree with a series of left rotations.  The existing nodes are
+// relinked: nothing is allocated, no values are copied and there is no
+// recursion, so the tree can be rebalanced however large or deep it is.  If
+// the nodes have been laid out by CBSTree::CompactLayout, the rebuilt tree
+// is laid out again.  A small set is already balanced, and is left
+// alone.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void        CBSTREE_CLASS::RebalanceTree()
+{
+    CLatencyTimer   timer(SampleLatency(LATENCY_REBALANCE));
+    size_t          size;
+
+    if(m_bSmallSet)
+    {
+        return;
+    }
+
+    size = TreeToVine(&m_root);
+    VineToTree(&m_root, size);
+    m_finger.clear();
+    m_maxNodes = m_numNodes;
+    if constexpr (HasFeature(FEATURE_COMPACT_LAYOUT))
+    {
+        if(m_arena != NULL)
+        {
+            CompactLayout();
+        }
+    }
+
+}  // end of "CBSTree<NodeType>::RebalanceTree"
+
+
+// ==== CBSTree::RebuildFilter ================================================
+//
+// This function resizes the filter for twice the number of items now in the
+// tree (and at least 1024) and reloads it with those items, from the array
+// of a small set or from the nodes.  The tree is walked with an explicit
+// stack, so its height does not matter.
+//
+// Access: protected
+//
+// Input:
+//      falsePosRate [IN]   -- the false-positive rate the filter is sized for
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::RebuildFilter(double  falsePosRate)
+{
+    vector<const TreeNode*>  pending;
+    const TreeNode                      *nodePtr;
+    size_t                              capacity;
+
+    capacity = 2 * GetNumItems();
+    m_filter->Reset((capacity < 1024) ? 1024 : capacity, falsePosRate);
+
+    if(m_bSmallSet)
+    {
+        for(size_t i = 0; i < m_smallItems.size(); ++i)
+        {
+            m_filter->Insert(m_smallItems[i]);
+        }
+    }
+    else if(m_root != NULL)
+    {
+        pending.push_back(m_root);
+    }
+    while(!pending.empty())
+    {
+        nodePtr = pending.back();
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            m_filter->Insert(nodePtr->m_value);
+        }
+        if(nodePtr->m_left != NULL)
+        {
+            pending.push_back(nodePtr->m_left);
+        }
+        if(nodePtr->m_right != NULL)
+        {
+            pending.push_back(nodePtr->m_right);
+        }
+    }
+
+}  // end of "CBSTree<NodeType>::RebuildFilter"
+
+
+
+// ==== CBSTree::ReleaseNodes =================================================
+//
+// This function frees a subtree that has already been unlinked from the tree.
+// In async release mode the subtree is handed to the NodeType reclaimer in
+// O(1) and freed on its thread; otherwise, or if the tree has a node block
+// or a node pool that its nodes must be returned to, it is freed at once by
+// CBSTree::DestroyNodes.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- the root of the subtree to free (may be NULL)
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::ReleaseNodes(TreeNode  *nodePtr)
+{
+    if(m_bAsyncRelease && AllocPolicy::IS_HEAP && m_arena == NULL)
+    {
+        CNodeReclaimer<NodeType, TreeNode>::GetInstance().Release(nodePtr);
+    }
+    else
+    {
+        DestroyNodes(nodePtr);
+    }
+
+}  // end of "CBSTree<NodeType>::ReleaseNodes"
+
+
+
+// ==== CBSTree::Repopulate ===================================================
+//
+// This function uses the contents of a sorted array to repopulate the tree.
+// The array is processed by 'divide and conquer' so that the middle element
+// of each range is inserted into the tree before the two halves on either
+// side of it, resulting in a balanced binary tree.  The ranges still to be
+// processed are kept on an explicit stack rather than in recursive calls.
+//
+// Access: protected
+//
+// Input:
+//      array [IN]      -- the base address of the array; it is assumed that
+//                         the values in the array are in sorted ascending order
+//
+//      first [IN]      -- an index to the first element
+//
+//      last [IN]       -- an index just past the last element
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void        CBSTREE_CLASS::Repopulate(const NodeType  array[]
+                                                , size_t  first, size_t  last)
+{
+    vector<pair<size_t, size_t> >   pending;
+    bool                            bInserted;
+
+    pending.push_back(make_pair(first, last));
+    while(!pending.empty())
+    {
+        first = pending.back().first;
+        last = pending.back().second;
+        pending.pop_back();
+        if(first >= last)
+        {
+            continue;
+        }
+
+        size_t  mid = first + (last - first) / 2;
+        m_root = Insert(array[mid], m_root, bInserted);
+        pending.push_back(make_pair(mid + 1, last));
+        pending.push_back(make_pair(first, mid));
+    }
+
+}  // end of "CBSTree<NodeType>::Repopulate"
+
+
+
+// ==== CBSTree::Retrieve =====================================================
+//
+// This function finds the node in the tree whose value equals that of the
+// target parameter. The target node is located with a loop down the tree,
+// making one three-way comparison per level. If the node does not exist in
+// the tree, a value of NULL is returned.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a reference to a NodeType object, or to any key the
+//                         Compare object can compare against one; it is
+//                         assumed that the object is fully initialized so a
+//                         search can be performed
+//
+//      nodePtr [IN]    -- a pointer to a tree node (initially this is usually
+//                         the root)
+//
+// Output:
+//      If a tree node is found that has the same value as the target
+//      parameter, then a pointer to the node in the tree is returned.
+//      Otherwise, a value of NULL is returned.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+template    <typename  KeyType>
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::Retrieve(
+                                        const KeyType  &target
+                                        , TreeNode  *nodePtr) const
+{
+    while(nodePtr != NULL)
+    {
+        int result = Compare3(target, nodePtr->m_value);
+        if(result == 0)
+        {
+            break;
+        }
+        nodePtr = (result < 0) ? nodePtr->m_left : nodePtr->m_right;
+    }
+
+    return nodePtr;
+
+}  // end of "CBSTree<NodeType>::Retrieve"
+
+
+// ==== CBSTree::RestoreBalance ===============================================
+//
+// This function is called after a batch of nodes has been removed at once.
+// As after DeleteItem, a tree in BALANCE_SCAPEGOAT mode that has shrunk far
+// enough is rebalanced, and in lazy delete mode the tree is compacted if the
+// remaining tombstones now exceed their limit.  A tree that has shrunk to
+// SMALL_MIN items becomes a small set again.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::RestoreBalance()
+{
+    if(BALANCE_SCAPEGOAT == GetBalanceMode()
+                                        && m_numNodes < m_alpha * m_maxNodes)
+    {
+        RebalanceTree();
+    }
+    else if(m_bLazyDelete && GetTombstoneRatio() > m_maxTombstoneRatio)
+    {
+        CompactTree();
+    }
+    ShrinkToSmallSet();
+
+}  // end of "CBSTree<NodeType>::RestoreBalance"
+
+
+
+// ==== CBSTree::Revive =======================================================
+//
+// This function turns a tombstone back into a live node when its item is
+// inserted again.  The node takes the new item's value, since a NodeType that
+// compares equal may still carry different data.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN/OUT]    -- a pointer to a tombstone node
+//
+//      newItem [IN]        -- a const reference to the item being inserted
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::Revive(TreeNode  *nodePtr
+                                            , const NodeType  &newItem)
+{
+    nodePtr->m_value = newItem;
+    nodePtr->m_bDeleted = false;
+    --m_numTombstones;
+
+}  // end of "CBSTree<NodeType>::Revive"
+
+
+
+// ==== CBSTree::SaveToArray ==================================================
+//
+// This function performs an inorder traversal of the tree, with an explicit
+// stack of the nodes whose left subtrees are being written, so that the
+// values in the nodes can be written to the caller's array in sorted
+// ascending order.  Tombstones are skipped.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr[IN]     -- a ptr to a tree node, initially the root
+//
+//      array [IN]      -- the base address of the caller's array
+//
+//      index [IN/OUT]  -- a reference to the index of the next element of the
+//                         array to be written; it is incremented as each node
+//                         value is copied into the array
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::SaveToArray(const TreeNode  *nodePtr
+                                    , NodeType  array[]
+                                    , size_t  &index)
+{
+    vector<const TreeNode*>  pending;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+
+        nodePtr = pending.back();
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            array[index] = nodePtr->m_value;
+            index++;
+        }
+        nodePtr = nodePtr->m_right;
+    }
+
+}  // end of "CBSTree<NodeType>::SaveToArray"
+
+
+
+// ==== CBSTree::SaveToArray ==================================================
+//
+// This overload writes every item in the tree to the caller's array in
+// sorted ascending order, from the array of a small set or from the nodes.
+//
+// Access: protected
+//
+// Input:
+//      array [OUT]     -- the base address of the caller's array, which must
+//                         have room for GetNumItems() items
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::SaveToArray(NodeType  array[])
+{
+    size_t  index = 0;
+
+    if(m_bSmallSet)
+    {
+        for(size_t i = 0; i < m_smallItems.size(); ++i)
+        {
+            array[i] = m_smallItems[i];
+        }
+        return;
+    }
+
+    SaveToArray(m_root, array, index);
+
+}  // end of "CBSTree<NodeType>::SaveToArray"
+
+
+// ==== CBSTree::ScapegoatInsert ==============================================
+//
+// This function inserts a new node into a tree in BALANCE_SCAPEGOAT mode.
+// The descent records the address of each link it follows.  If the new node
+// ends up deeper than CBSTree::ScapegoatLimit allows, the function climbs
+// back up that path, adding up subtree sizes, until it finds an ancestor
+// whose child on the path holds more than alpha of its nodes.  Only that
+// ancestor's subtree is rebuilt, in place, by CBSTree::TreeToVine and
+// CBSTree::VineToTree.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree
+//      (or a tombstone for it was revived), false if it was already there.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::ScapegoatInsert(const NodeType  &newItem)
+{
+    TreeNode            **link = &m_root;
+    TreeNode            *nodePtr;
+    TreeNode            *child;
+    TreeNode            *sibling;
+    size_t              childSize;
+    size_t              nodeSize;
+
+    m_path.clear();
+    while(*link != NULL)
+    {
+        nodePtr = *link;
+        m_path.push_back(link);
+
+        int result = Compare3(newItem, nodePtr->m_value);
+        if(result == 0)
+        {
+            if(nodePtr->m_bDeleted)
+            {
+                Revive(nodePtr, newItem);
+                return true;
+            }
+            return false;
+        }
+
+        link = (result < 0) ? &nodePtr->m_left : &nodePtr->m_right;
+    }
+
+    *link = AllocNode(newItem);
+    if(++m_numNodes > m_maxNodes)
+    {
+        m_maxNodes = m_numNodes;
+    }
+
+    // the new node's depth is the number of links above it
+    if(m_path.size() <= ScapegoatLimit())
+    {
+        return true;
+    }
+
+    child = *link;
+    childSize = 1;
+    for(size_t i = m_path.size(); i-- > 0; )
+    {
+        nodePtr = *m_path[i];
+        sibling = (nodePtr->m_left == child) ? nodePtr->m_right
+                                             : nodePtr->m_left;
+        nodeSize = childSize + 1 + SubtreeSize(sibling);
+        if(childSize > m_alpha * nodeSize)
+        {
+            VineToTree(m_path[i], TreeToVine(m_path[i]));
+            break;
+        }
+
+        child = nodePtr;
+        childSize = nodeSize;
+    }
+
+    return true;
+
+}  // end of "CBSTree<NodeType>::ScapegoatInsert"
+
+
+
+// ==== CBSTree::ScapegoatLimit ===============================================
+//
+// This function computes the deepest a node may sit in BALANCE_SCAPEGOAT mode,
+// which is the floor of log(n) / log(1 / alpha) for a tree of n nodes.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The largest allowed depth (counting edges from the root).
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::ScapegoatLimit() const
+{
+    if(m_numNodes < 2)
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(floor(log(static_cast<double>(m_numNodes))
+                                            / log(1.0 / m_alpha)));
+
+}  // end of "CBSTree<NodeType>::ScapegoatLimit"
+
+
+
+// ==== CBSTree::SetAsyncRelease ==============================================
+//
+// This function turns async release on or off (see CNodeReclaimer).  The
+// tree must be built with FEATURE_ASYNC_RELEASE.
+//
+// Access: public
+//
+// Input:
+//      bAsync [IN]     -- true to hand removed nodes to the reclaimer's
+//                         thread, false to free them on the calling thread
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::SetAsyncRelease(bool  bAsync)
+{
+    static_assert(HasFeature(FEATURE_ASYNC_RELEASE)
+                        , "SetAsyncRelease needs FEATURE_ASYNC_RELEASE");
+    m_bAsyncRelease = bAsync;
+
+}  // end of "CBSTree<NodeType>::SetAsyncRelease"
+
+
+
+// ==== CBSTree::SetBalanceMode ===============================================
+//
+// This function selects how the tree restructures itself during normal
+// operations (see BalanceMode).  Switching to BALANCE_SCAPEGOAT rebalances the
+// tree first so that its height limit holds from the start.  A tree whose
+// balance policy fixes the mode ignores a request for any other mode, and a
+// tree built without FEATURE_SCAPEGOAT ignores a request for that mode.
+//
+// Access: public
+//
+// Input:
+//      mode [IN]       -- the new balance mode
+//
+//      alpha [IN]      -- the weight-balance factor for BALANCE_SCAPEGOAT
+//                         mode, between 0.5 (strict) and 1.0 (loose)
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::SetBalanceMode(BalanceMode  mode
+                                                    , double  alpha)
+{
+    if((BALANCE_SCAPEGOAT == mode && !HasFeature(FEATURE_SCAPEGOAT))
+                                || !BalancePolicy::SelectBalanceMode(mode))
+    {
+        return;
+    }
+
+    m_alpha = alpha;
+    m_finger.clear();
+    if(BALANCE_SCAPEGOAT == GetBalanceMode())
+    {
+        RebalanceTree();
+    }
+
+}  // end of "CBSTree<NodeType>::SetBalanceMode"
+
+
+// ==== CBSTree::SetLazyDelete ================================================
+//
+// This function turns lazy delete mode on or off and sets the share of
+// tombstones that triggers compaction.  When the mode is turned off, any
+// remaining tombstones are removed right away by CBSTree::CompactTree.  The
+// tree must be built with FEATURE_LAZY_DELETE.
+//
+// Access: public
+//
+// Input:
+//      bLazy [IN]              -- true to mark deleted items as tombstones,
+//                                 false to remove them immediately
+//
+//      maxTombstoneRatio [IN]  -- the fraction of nodes (0.0 to 1.0) that may
+//                                 be tombstones before the tree is compacted
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::SetLazyDelete(bool  bLazy
+                                            , double  maxTombstoneRatio)
+{
+    static_assert(HasFeature(FEATURE_LAZY_DELETE)
+                        , "SetLazyDelete needs FEATURE_LAZY_DELETE");
+    m_bLazyDelete = bLazy;
+    m_maxTombstoneRatio = maxTombstoneRatio;
+    if(!m_bLazyDelete && m_numTombstones > 0)
+    {
+        CompactTree();
+    }
+
+}  // end of "CBSTree<NodeType>::SetLazyDelete"
+
+
+
+// ==== CBSTree::ShrinkToSmallSet =============================================
+//
+// This function turns a tree of nodes that has shrunk to SMALL_MIN items or
+// fewer back into a small set, and does nothing otherwise (or in a tree
+// without FEATURE_SMALL_SET).  The live items
+// are copied into a new array in order, walking the tree with an explicit
+// stack, and the nodes are then freed by CBSTree::DestroyTree.  The filter is
+// set aside meanwhile, since it already holds exactly those items.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::ShrinkToSmallSet()
+{
+    vector<const TreeNode*>             pending;
+    const TreeNode                      *nodePtr;
+    CCountingBloomFilter<NodeType>      *filterPtr = m_filter;
+    vector<NodeType>                    items;
+
+    if(!HasFeature(FEATURE_SMALL_SET) || m_bSmallSet
+                                        || GetNumItems() > SMALL_MIN)
+    {
+        return;
+    }
+
+    nodePtr = m_root;
+    items.reserve(SMALL_MAX);
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+        nodePtr = pending.back();
+        pending.pop_back();
+        if(!nodePtr->m_bDeleted)
+        {
+            items.push_back(nodePtr->m_value);
+        }
+        nodePtr = nodePtr->m_right;
+    }
+
+    m_filter = NULL;
+    DestroyTree();
+    m_filter = filterPtr;
+    m_smallItems.assign(items.data(), items.data() + items.size());
+    m_numNodes = m_maxNodes = m_smallItems.size();
+
+}  // end of "CBSTree<NodeType>::ShrinkToSmallSet"
+
+
+
+// ==== CBSTree::SmallBound ===================================================
+//
+// This function finds where a target falls in the sorted array of a small
+// set.  The search is a branchless binary search: each step compares the
+// target with the middle of the remaining range and keeps one half of it
+// with a conditional move rather than a branch, so there are no mispredicted
+// branches to pay for, only one comparison per halving.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object, or to any
+//                         key the Compare object can compare against one
+//
+//      bUpper [IN]     -- false to find the first item that does not order
+//                         before the target (its lower bound), true to find
+//                         the first item that orders after it (its upper
+//                         bound)
+//
+// Output:
+//      The index of that item, or the size of the array if there is none.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+template    <typename  KeyType>
+size_t  CBSTREE_CLASS::SmallBound(const KeyType  &target, bool  bUpper) const
+{
+    const NodeType  *basePtr = m_smallItems.data();
+    size_t          count = m_smallItems.size();
+    int             limit = bUpper ? -1 : 0;
+
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    while(count > 1)
+    {
+        size_t  half = count / 2;
+        basePtr = (Compare3(target, basePtr[half]) > limit) ? basePtr + half
+                                                            : basePtr;
+        count -= half;
+    }
+
+    return (basePtr - m_smallItems.data())
+                            + ((Compare3(target, *basePtr) > limit) ? 1 : 0);
+
+}  // end of "CBSTree<NodeType>::SmallBound"
+
+
+
+// ==== CBSTree::SmallEraseRange ==============================================
+//
+// This function removes every item from lo to hi (inclusive) from a small
+// set, for DeleteRange and ExtractRange.  The range is found with two calls
+// to CBSTree::SmallBound, its items are removed from the filter and, if
+// there is a tree to receive them, handed to it by CBSTree::BuildFromSorted,
+// and the range is then erased from the array in one move.
+//
+// Access: protected
+//
+// Input:
+//      lo [IN]         -- the smallest item to remove
+//
+//      hi [IN]         -- the largest item to remove
+//
+//      destPtr [OUT]   -- a pointer to an empty tree that receives the items,
+//                         or NULL if they are simply deleted
+//
+// Output:
+//      The number of items removed; zero if lo orders after hi.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::SmallEraseRange(const NodeType  &lo
+                                        , const NodeType  &hi
+                                        , CBSTree  *destPtr)
+{
+    size_t  first;
+    size_t  last;
+
+    if(Compare3(lo, hi) > 0)
+    {
+        return 0;
+    }
+
+    first = SmallBound(lo, false);
+    last = SmallBound(hi, true);
+    if(first == last)
+    {
+        return 0;
+    }
+
+    if(m_filter != NULL)
+    {
+        for(size_t i = first; i < last; ++i)
+        {
+            m_filter->Remove(m_smallItems[i]);
+        }
+    }
+    if(destPtr != NULL)
+    {
+        destPtr->BuildFromSorted(&m_smallItems[first], last - first);
+    }
+    m_smallItems.erase(m_smallItems.begin() + first
+                                        , m_smallItems.begin() + last);
+    m_numNodes = m_smallItems.size();
+    return last - first;
+
+}  // end of "CBSTree<NodeType>::SmallEraseRange"
+
+
+
+// ==== CBSTree::SmallOrder ===================================================
+//
+// This function performs a pre-order or post-order traversal of the balanced
+// tree that a stretch of a small set's array stands for: the middle item of
+// the stretch is the root, and the items on either side of it are its left
+// and right subtrees.  The recursion is no deeper than log2(SMALL_MAX).
+//
+// Access: protected
+//
+// Input:
+//      first [IN]      -- the index of the first item of the stretch
+//
+//      last [IN]       -- the index just past its last item
+//
+//      bPreOrder [IN]  -- true for a pre-order traversal, false for a
+//                         post-order one
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference to a NodeType object as input, and
+//                         returns nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::SmallOrder(size_t  first, size_t  last
+                                        , bool  bPreOrder
+                                        , void (*fPtr)(const NodeType&)) const
+{
+    if(first >= last)
+    {
+        return;
+    }
+
+    size_t  mid = first + (last - first) / 2;
+    if(bPreOrder)
+    {
+        (*fPtr)(m_smallItems[mid]);
+    }
+    SmallOrder(first, mid, bPreOrder, fPtr);
+    SmallOrder(mid + 1, last, bPreOrder, fPtr);
+    if(!bPreOrder)
+    {
+        (*fPtr)(m_smallItems[mid]);
+    }
+
+}  // end of "CBSTree<NodeType>::SmallOrder"
+
+
+// ==== CBSTree::Splay ========================================================
+//
+// This function performs a top-down splay of the subtree rooted at nodePtr.
+// It walks down the search path for the target, rotating at every second step
+// (the "zig-zig" case) and hanging the nodes it passes onto a left tree (nodes
+// less than the target) and a right tree (nodes greater than the target).
+// When the walk ends, the last node reached becomes the new subtree root with
+// the left and right trees as its children.  If the target is in the subtree,
+// it ends up at the root; otherwise the root is its inorder predecessor or
+// successor.  No recursion and no extra memory are used.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object, or to any
+//                         key the Compare object can compare against one
+//
+//      nodePtr [IN]    -- a pointer to the root of the subtree to splay
+//
+// Output:
+//      A pointer to the new root of the subtree (NULL if it was empty).
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+template    <typename  KeyType>
+typename CBSTREE_CLASS::TreeNode*  CBSTREE_CLASS::Splay(
+                                        const KeyType  &target
+                                        , TreeNode  *nodePtr) const
+{
+    TreeNode *leftTree = NULL;
+    TreeNode *rightTree = NULL;
+    TreeNode **leftHook = &leftTree;
+    TreeNode **rightHook = &rightTree;
+    TreeNode *child;
+
+    m_bSpinesValid = false;
+    if(nodePtr == NULL)
+    {
+        return NULL;
+    }
+
+    for(;;)
+    {
+        int result = Compare3(target, nodePtr->m_value);
+        if(result < 0)
+        {
+            child = nodePtr->m_left;
+            if(child == NULL)
+            {
+                break;
+            }
+
+            // zig-zig: rotate right before linking
+            if(Compare3(target, child->m_value) < 0)
+            {
+                nodePtr->m_left = child->m_right;
+                child->m_right = nodePtr;
+                nodePtr = child;
+                if(nodePtr->m_left == NULL)
+                {
+                    break;
+                }
+            }
+
+            // link the current node into the right tree
+            *rightHook = nodePtr;
+            rightHook = &nodePtr->m_left;
+            nodePtr = nodePtr->m_left;
+        }
+        else if(result > 0)
+        {
+            child = nodePtr->m_right;
+            if(child == NULL)
+            {
+                break;
+            }
+
+            // zag-zag: rotate left before linking
+            if(Compare3(target, child->m_value) > 0)
+            {
+                nodePtr->m_right = child->m_left;
+                child->m_left = nodePtr;
+                nodePtr = child;
+                if(nodePtr->m_right == NULL)
+                {
+                    break;
+                }
+            }
+
+            // link the current node into the left tree
+            *leftHook = nodePtr;
+            leftHook = &nodePtr->m_right;
+            nodePtr = nodePtr->m_right;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // reassemble the tree around the last node reached
+    *leftHook = nodePtr->m_left;
+    *rightHook = nodePtr->m_right;
+    nodePtr->m_left = leftTree;
+    nodePtr->m_right = rightTree;
+    return nodePtr;
+
+}  // end of "CBSTree<NodeType>::Splay"
+
+
+
+// ==== CBSTree::SplayDelete ==================================================
+//
+// This function deletes a target node from a tree in BALANCE_SPLAY mode.  The
+// target is splayed to the root and removed.  Its left subtree is then splayed
+// for the same target, which brings the largest node of that subtree (with no
+// right child) to the top, and the old right subtree is attached there.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object
+//
+// Output:
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::SplayDelete(const NodeType  &target)
+{
+    TreeNode *oldRoot;
+
+    m_root = Splay(target, m_root);
+    if(m_root == NULL || Compare3(target, m_root->m_value) != 0)
+    {
+        return false;
+    }
+
+    oldRoot = m_root;
+    if(oldRoot->m_left == NULL)
+    {
+        m_root = oldRoot->m_right;
+    }
+    else
+    {
+        m_root = Splay(target, oldRoot->m_left);
+        m_root->m_right = oldRoot->m_right;
+    }
+
+    FreeNode(oldRoot);
+    --m_numNodes;
+    return true;
+
+}  // end of "CBSTree<NodeType>::SplayDelete"
+
+
+
+// ==== CBSTree::SplayInsert ==================================================
+//
+// This function inserts a new node into a tree in BALANCE_SPLAY mode.  The
+// tree is splayed for the new item, which leaves its inorder neighbor at the
+// root.  Unless that root holds the item already, the new node becomes the
+// root, with the old root on one side and the old root's subtree on that side
+// moved over to the other.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree,
+//      false otherwise.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+bool    CBSTREE_CLASS::SplayInsert(const NodeType  &newItem)
+{
+    TreeNode *newPtr;
+
+    if(m_root == NULL)
+    {
+        m_root = AllocNode(newItem);
+        ++m_numNodes;
+        return true;
+    }
+
+    m_root = Splay(newItem, m_root);
+    int result = Compare3(newItem, m_root->m_value);
+    if(result == 0)
+    {
+        if(m_root->m_bDeleted)
+        {
+            Revive(m_root, newItem);
+            return true;
+        }
+        return false;
+    }
+
+    newPtr = AllocNode(newItem);
+    ++m_numNodes;
+    if(result < 0)
+    {
+        newPtr->m_left = m_root->m_left;
+        newPtr->m_right = m_root;
+        m_root->m_left = NULL;
+    }
+    else
+    {
+        newPtr->m_right = m_root->m_right;
+        newPtr->m_left = m_root;
+        m_root->m_right = NULL;
+    }
+
+    m_root = newPtr;
+    return true;
+
+}  // end of "CBSTree<NodeType>::SplayInsert"
+
+
+
+// ==== CBSTree::Split ========================================================
+//
+// This function splits a subtree in two around a key.  It walks down the
+// search path of the key once; each node on the path goes to the left or to
+// the right result along with its subtree on the far side of the path, and is
+// hooked in where the previous node of that result left a gap.  No node off
+// the path is touched, so the split costs O(height).
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]            -- the root of the subtree to split
+//
+//      key [IN]                -- the key to split around
+//
+//      bEqualGoesLeft [IN]     -- true if items equal to the key go to the
+//                                 left result, false if they go to the right
+//
+//      leftTree [OUT]          -- set to the root of the items before the key
+//
+//      rightTree [OUT]         -- set to the root of the items after the key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::Split(TreeNode  *nodePtr
+                                        , const NodeType  &key
+                                        , bool  bEqualGoesLeft
+                                        , TreeNode  *&leftTree
+                                        , TreeNode  *&rightTree)
+{
+    TreeNode *leftRoot = NULL;
+    TreeNode *rightRoot = NULL;
+    TreeNode **leftHook = &leftRoot;
+    TreeNode **rightHook = &rightRoot;
+
+    while(nodePtr != NULL)
+    {
+        int result = Compare3(nodePtr->m_value, key);
+        if(result < 0 || (result == 0 && bEqualGoesLeft))
+        {
+            *leftHook = nodePtr;
+            leftHook = &nodePtr->m_right;
+            nodePtr = nodePtr->m_right;
+        }
+        else
+        {
+            *rightHook = nodePtr;
+            rightHook = &nodePtr->m_left;
+            nodePtr = nodePtr->m_left;
+        }
+    }
+    *leftHook = NULL;
+    *rightHook = NULL;
+    leftTree = leftRoot;
+    rightTree = rightRoot;
+
+}  // end of "CBSTree<NodeType>::Split"
+
+
+// ==== CBSTree::SubtreeSize ==================================================
+//
+// This function counts the nodes (tombstones included) in the subtree rooted
+// at nodePtr.  The nodes are visited with an explicit stack, as in
+// CBSTree::CountNodes, so a subtree of any depth can be measured.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+// Output:
+//      The number of nodes in the subtree.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::SubtreeSize(
+                                const TreeNode  *nodePtr) const
+{
+    vector<const TreeNode*>  pending;
+    size_t                              numNodes = 0;
+
+    if(nodePtr != NULL)
+    {
+        pending.push_back(nodePtr);
+    }
+    while(!pending.empty())
+    {
+        nodePtr = pending.back();
+        pending.pop_back();
+        ++numNodes;
+        if(nodePtr->m_right != NULL)
+        {
+            pending.push_back(nodePtr->m_right);
+        }
+        if(nodePtr->m_left != NULL)
+        {
+            pending.push_back(nodePtr->m_left);
+        }
+    }
+
+    return numNodes;
+
+}  // end of "CBSTree<NodeType>::SubtreeSize"
+
+
+// ==== CBSTree::TreeToVine ===================================================
+//
+// This function rotates the subtree hanging from the link parameter into a
+// vine: each node with a left child is rotated right until none is left, so
+// the nodes end up in sorted order along the right links.  Tombstones met
+// along the way are unlinked and released.
+//
+// Access: protected
+//
+// Input:
+//      link [IN/OUT]   -- the address of the link that holds the subtree
+//
+// Output:
+//      The number of nodes in the vine.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+size_t  CBSTREE_CLASS::TreeToVine(TreeNode  **link)
+{
+    TreeNode            *nodePtr;
+    TreeNode            *left;
+    size_t              size = 0;
+
+    m_bSpinesValid = false;
+    while(*link != NULL)
+    {
+        nodePtr = *link;
+        if(nodePtr->m_left != NULL)
+        {
+            left = nodePtr->m_left;
+            nodePtr->m_left = left->m_right;
+            left->m_right = nodePtr;
+            *link = left;
+        }
+        else if(nodePtr->m_bDeleted)
+        {
+            *link = nodePtr->m_right;
+            FreeNode(nodePtr);
+            --m_numNodes;
+            --m_numTombstones;
+        }
+        else
+        {
+            ++size;
+            link = &nodePtr->m_right;
+        }
+    }
+
+    return size;
+
+}  // end of "CBSTree<NodeType>::TreeToVine"
+
+
+
+// ==== CBSTree::VebOrder =====================================================
+//
+// This recursive function lists the nodes of a subtree in van Emde Boas
+// order.  The subtree's levels are split in two: the top half is listed
+// first, by a recursive call, and then each subtree hanging below it, left to
+// right, each by a recursive call of its own.  The roots of those bottom
+// subtrees are gathered with an explicit stack.  The recursion only nests
+// O(log levels) deep.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+//      levels [IN]     -- the number of levels of the subtree to list; no
+//                         node of the subtree may lie deeper than that
+//
+//      order [OUT]     -- the nodes are appended to this vector
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::VebOrder(TreeNode  *nodePtr
+                                    , size_t  levels
+                                    , vector<TreeNode*>  &order)
+                                                                    const
+{
+    vector<pair<TreeNode*, size_t> >     pending;
+    vector<TreeNode*>                               bottomRoots;
+    size_t                                          bottomLevels = levels / 2;
+    size_t                                          topLevels;
+
+    if(nodePtr == NULL || levels == 0)
+    {
+        return;
+    }
+    if(levels == 1)
+    {
+        order.push_back(nodePtr);
+        return;
+    }
+
+    topLevels = levels - bottomLevels;
+    VebOrder(nodePtr, topLevels, order);
+
+    pending.push_back(make_pair(nodePtr, 0));
+    while(!pending.empty())
+    {
+        TreeNode *currPtr = pending.back().first;
+        size_t              depth = pending.back().second;
+        pending.pop_back();
+        if(depth == topLevels)
+        {
+            bottomRoots.push_back(currPtr);
+            continue;
+        }
+        if(currPtr->m_right != NULL)
+        {
+            pending.push_back(make_pair(currPtr->m_right, depth + 1));
+        }
+        if(currPtr->m_left != NULL)
+        {
+            pending.push_back(make_pair(currPtr->m_left, depth + 1));
+        }
+    }
+
+    for(size_t i = 0; i < bottomRoots.size(); ++i)
+    {
+        VebOrder(bottomRoots[i], bottomLevels, order);
+    }
+
+}  // end of "CBSTree<NodeType>::VebOrder"
+
+
+
+// ==== CBSTree::VineToTree ===================================================
+//
+// This function folds a vine of "size" nodes into a balanced tree.  The first
+// compression pass hangs the nodes that do not fit into a complete tree as
+// the bottom level; each later pass halves what remains of the vine.
+//
+// Access: protected
+//
+// Input:
+//      link [IN/OUT]   -- the address of the link that holds the vine
+//
+//      size [IN]       -- the number of nodes in the vine
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::VineToTree(TreeNode  **link
+                                                    , size_t  size)
+{
+    size_t  complete = 1;
+
+    // find the size of the largest complete tree that fits
+    while(complete <= size)
+    {
+        complete = complete * 2 + 1;
+    }
+    complete /= 2;
+
+    Compress(link, size - complete);
+    for(size = complete; size > 1; )
+    {
+        size /= 2;
+        Compress(link, size);
+    }
+
+}  // end of "CBSTree<NodeType>::VineToTree"
+
+
+
+// ==== CBSTree::WaitForRelease ===============================================
+//
+// This function blocks until every tree of NodeType nodes that was handed to
+// the reclaimer, by any CBSTree in async release mode, has been freed.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::WaitForRelease()
+{
+    CNodeReclaimer<NodeType, TreeNode>::GetInstance().WaitForIdle();
+
+}  // end of "CBSTree<NodeType>::WaitForRelease"
+
+
+
+// ==== CBSTree::operator= ====================================================
+//
+// This is the overloaded assignment operator for the CBSTree class. It first
+// checks for assignment to self, then releases all of the nodes in the calling
+// object. Then it uses the parameter as an argument to the CopyTree member
+// function so that the parameter's tree is replicated in the calling object.
+//
+// Access: public
+//
+// Input:
+//      rhs [IN]    -- a const reference to an existing CBSTree object
+//
+// Output:
+//      A reference to the calling object.
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+CBSTREE_CLASS&  CBSTREE_CLASS::operator=(
+                                    const CBSTREE_CLASS  &rhs)
+{
+    if(this != &rhs)
+    {
+        DestroyTree();
+        this->GetCompare() = rhs.GetCompare();
+        BalancePolicy::operator=(rhs);
+        m_bUseFinger = rhs.m_bUseFinger;
+        m_bLazyDelete = rhs.m_bLazyDelete;
+        m_maxTombstoneRatio = rhs.m_maxTombstoneRatio;
+        if(rhs.m_bSmallSet)
+        {
+            m_smallItems.assign(rhs.m_smallItems.begin()
+                                        , rhs.m_smallItems.end());
+        }
+        else
+        {
+            SwitchToNodes();
+            m_root = CopyTree(rhs.m_root);
+        }
+        m_numNodes = rhs.m_numNodes;
+        m_numTombstones = rhs.m_numTombstones;
+        m_alpha = rhs.m_alpha;
+        m_maxNodes = rhs.m_maxNodes;
+        m_bAsyncRelease = rhs.m_bAsyncRelease;
+        DisableFilter();
+        if(rhs.m_filter != NULL)
+        {
+            m_filter = new CCountingBloomFilter<NodeType>(*rhs.m_filter);
+        }
+    }
+    return *this;
+
+}  // end of "CBSTree<NodeType>::operator="
+
+
+
+// ==== CBSTree::CInOrderCursor::CInOrderCursor ===============================
+//
+// This is the constructor for the CInOrderCursor class.  It pushes the left
+// spine of the tree, whose last node is the smallest, and moves past any
+// tombstones to the first item.  A small set is walked by index instead.
+//
+// Access: public
+//
+// Input:
+//      tree [IN]       -- a const reference to the tree to walk
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+CBSTREE_CLASS::CInOrderCursor::CInOrderCursor(const CBSTREE_CLASS  &tree)
+                                        : m_treePtr(&tree)
+                                        , m_itemPtr(NULL)
+                                        , m_index(0)
+{
+    if(!tree.m_bSmallSet)
+    {
+        for(const TreeNode *nodePtr = tree.m_root; nodePtr != NULL
+                                            ; nodePtr = nodePtr->m_left)
+        {
+            m_pending.push_back(nodePtr);
+        }
+    }
+    Settle();
+
+}  // end of "CBSTree<NodeType>::CInOrderCursor::CInOrderCursor"
+
+
+
+// ==== CBSTree::CInOrderCursor::Advance ======================================
+//
+// This function steps the node walk from the node on top of the stack to its
+// in-order successor: the node is popped and the left spine of its right
+// subtree is pushed, as in CBSTree::InOrder.
+//
+// Access: private
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::CInOrderCursor::Advance()
+{
+    const TreeNode              *nodePtr = m_pending.back()->m_right;
+
+    m_pending.pop_back();
+    for(; nodePtr != NULL; nodePtr = nodePtr->m_left)
+    {
+        m_pending.push_back(nodePtr);
+    }
+
+}  // end of "CBSTree<NodeType>::CInOrderCursor::Advance"
+
+
+
+// ==== CBSTree::CInOrderCursor::Next =========================================
+//
+// This function moves the cursor to the next item in order.  It must not be
+// called once the cursor is at the end.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::CInOrderCursor::Next()
+{
+    if(m_treePtr->m_bSmallSet)
+    {
+        ++m_index;
+    }
+    else
+    {
+        Advance();
+    }
+    Settle();
+
+}  // end of "CBSTree<NodeType>::CInOrderCursor::Next"
+
+
+
+// ==== CBSTree::CInOrderCursor::Settle =======================================
+//
+// This function skips any tombstones at the cursor's position and points
+// m_itemPtr at the item it has reached, or sets it to NULL at the end.
+//
+// Access: private
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+CBSTREE_TEMPLATE
+void    CBSTREE_CLASS::CInOrderCursor::Settle()
+{
+    if(m_treePtr->m_bSmallSet)
+    {
+        m_itemPtr = (m_index < m_treePtr->m_smallItems.size())
+                                    ? &m_treePtr->m_smallItems[m_index] : NULL;
+        return;
+    }
+
+    while(!m_pending.empty() && m_pending.back()->m_bDeleted)
+    {
+        Advance();
+    }
+    m_itemPtr = m_pending.empty() ? NULL : &m_pending.back()->m_value;
+
+}  // end of "CBSTree<NodeType>::CInOrderCursor::Settle"
 
+#undef      CBSTREE_TEMPLATE
+#undef      CBSTREE_CLASS
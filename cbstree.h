@@ -3,71 +3,426 @@
 // ============================================================================
 // This header file contains the declaration of the CBSTree class. It uses the
 // template parameter "NodeType" for the type of values that are stored in the
-// tree.
+// tree, and the template parameter "Compare" for the function object that
+// orders them.
+//
+// A Compare object is called with two values and may either return a
+// negative, zero or positive int (a three-way comparator such as the default
+// CThreeWayCompare), or return a bool like std::less.  With a three-way
+// comparator each level of a search costs one comparison.  If the comparator
+// has an "is_transparent" member type, as CThreeWayCompare<> does, ItemInTree
+// also accepts any key type the comparator can compare against a NodeType.
+//
+// The tree can also restructure itself as it is used; see SetBalanceMode.  In
+// BALANCE_SPLAY mode every ItemInTree, InsertItem and DeleteItem call splays
+// the node it reaches to the root, so frequently used items stay near the top
+// and any sequence of operations costs O(log n) amortized per operation.
+//
+// BALANCE_SCAPEGOAT mode keeps the height within log(n) / log(1 / alpha)
+// without storing anything extra in the nodes.  When an insertion lands
+// deeper than that, the nearest ancestor whose subtree is out of alpha-weight
+// balance (the "scapegoat") is found and only that subtree is rebuilt, with
+// the same in-place vine helpers RebalanceTree uses.  When deletions shrink
+// the tree below alpha times its largest size since the last full rebuild,
+// the whole tree is rebalanced.  Updates cost O(log n) amortized.
+//
+// In BALANCE_NONE mode the tree keeps a "finger": the path from the root to
+// the node most recently inserted, along with the ancestors that bound each
+// node's subtree.  InsertItem starts from the deepest node on that path whose
+// subtree can hold the new item, found with a binary search over the path, so
+// keys that arrive in (nearly) increasing order are appended in amortized
+// O(1) instead of walking down from the root.  ItemInTree also starts from
+// the end of the finger when the target falls under it.  Any other change to
+// the tree's shape drops the finger; see SetFingerSearch to turn it off.
+//
+// With SetLazyDelete, DeleteItem only marks the target node as deleted and
+// leaves it in place as a tombstone, so a delete costs one search and no
+// restructuring.  Lookups and traversals skip tombstones, and inserting a
+// deleted item again revives its node.  Once tombstones make up more than the
+// given fraction of the nodes, CompactTree frees them and rebalances the tree
+// in a single linear pass.
+//
+// A CInOrderCursor visits the items in order one at a time, for callers that
+// cannot hand the whole walk to a callback, such as a merge of several trees.
+// It keeps the path to its current node on a stack of its own, so it does
+// not change the tree, but any change to the tree invalidates it.
+//
+// ItemsInTree and LowerBounds answer a whole batch of lookups at once.  They
+// advance a group of independent searches together, one level per pass, and
+// prefetch the next node of each search as soon as it is known, so the cache
+// misses of different searches overlap instead of being paid one after the
+// other.  Batched lookups never splay or move the finger.
+//
+// EnableFilter puts a counting Bloom filter (see cbloomfilter.h) in front of
+// the tree.  InsertItem and DeleteItem keep it up to date, and ItemInTree and
+// DeleteItem return at once, without touching a node, when it shows that the
+// item is absent.  The filter hashes values with std::hash, so it should only
+// be enabled when values that the Compare object treats as equal also hash
+// equally.  It is regrown whenever the tree outgrows the size it was built
+// for, and GetFilterInfo reports its predicted and observed false-positive
+// rates.
+//
+// The tree also caches its left and right spines: the paths from the root to
+// the smallest and to the largest node.  Min and Max read the end of a spine
+// in O(1).  PopMin and PopMax unlink that end node, which never has a child
+// on the outer side, and push the spine of its one subtree in its place, so a
+// run of pops costs O(1) amortized each and the tree can serve as an ordered
+// priority queue.  A plain insertion extends a spine in O(1) when it creates a
+// new minimum or maximum.  Any other change to the tree's shape (a splay, a
+// rebuild or a DeleteItem) drops the spines, and they are found again by the
+// next call that needs them.
+//
+// DeleteRange and ExtractRange remove every item in a closed range at once.
+// The tree is split along the search paths of the two bounds into the items
+// below, inside and above the range, and the outer two parts are joined
+// again, so the tree itself is touched in O(height) however many items the
+// range holds.  The detached subtree is then freed, or handed over as a
+// separate tree, in a single pass over its own nodes.
+//
+// With SetAsyncRelease, DestroyTree (and so the destructor and operator=)
+// and DeleteRange only detach the nodes they remove, in O(1), and hand them
+// to a background thread that frees them (see cnodereclaimer.h); the calling
+// thread never waits for a large tree to be freed.  WaitForRelease blocks
+// until every tree handed over so far has been freed.
+//
+// Nodes are allocated one at a time as items arrive, so after a long run of
+// updates neighbouring nodes sit far apart on the heap and every step of a
+// search or traversal can miss the cache.  CompactLayout copies all of the
+// nodes into one contiguous block in van Emde Boas order: the top half of
+// the tree's levels is laid out first, recursively, and then each subtree
+// hanging below it, so any root-to-leaf path crosses O(log_B n) cache lines
+// of B nodes, whatever B is.  The tree stays fully mutable: a node of the
+// block that is deleted is destroyed in place and its slot is reused by a
+// later insertion, and the block is released only when the tree is
+// destroyed or laid out again.  Once CompactLayout has been called,
+// RebalanceTree lays the rebuilt tree out again as well.
+//
+// EnableLatencyStats starts timing the public operations listed in
+// LatencyOp, each into a histogram of its own (see clatencyhistogram.h), so
+// that tail latencies can be watched next to the tree's height and its
+// rebalances.  Every sampleEvery-th operation is timed, and the others pay
+// for one counter increment; with the stats disabled the cost is one test of
+// a pointer.  The stats belong to the tree object, and are not copied with
+// it.
+//
+// The last four template parameters choose, at compile time, how the tree
+// balances itself, where its nodes come from, whether it keeps stats and
+// which features it is built with (see cbstreepolicy.h).  A tree built with
+// CFixedBalance<Mode> has its balance mode fixed and tests it as a constant,
+// so the code for the other modes drops out; one built with CPoolNodeAlloc
+// takes its nodes from chunks of its own; and one built with CNoStats
+// carries no latency stats and no timing code at all.  A policy with no data
+// adds nothing to the size of the tree.
+//
+// The default features are counting, finger search, cached spines, scapegoat
+// mode and small sets.  Lazy deletion, the filter, CompactLayout and async
+// release must be asked for in CTreeFeatures (the calls that use them do
+// not compile otherwise), and only a tree built with lazy deletion has a
+// tombstone flag in its nodes.  Without cached spines Min, Max and the pops
+// walk the spine each time, and without counting GetNumItems counts the
+// nodes.  A tree built with CFixedBalance<BALANCE_NONE>, CNoStats and
+// FEATURE_NONE is a root pointer and nodes of a value and two links, like a
+// plain binary search tree.
+//
+// Most trees stay small, and for them a node per item and a pointer chase
+// per level are pure overhead.  So a tree of up to SMALL_MAX items keeps them
+// in a sorted array instead, with no nodes at all, and searches it with a
+// branchless binary search over one or two cache lines.  Inserting and
+// deleting shift the array, which at this size is cheaper than allocating or
+// freeing a node.  When an insertion would take the array past SMALL_MAX
+// items it is built into a balanced tree in O(n), and when deletions leave
+// a tree with SMALL_MIN items or fewer they are copied back into an array;
+// the gap between the two keeps a tree that hovers around one size from
+// switching back and forth.  The switch is invisible to callers.  A small
+// set has no tombstones, splays nothing and is always balanced:
+// RebalanceTree and CompactLayout leave it alone, and PreOrderTraverse,
+// PostOrderTraverse and GetTreeInfo describe the balanced tree that the
+// array stands for.  The array is one pointer to a block holding its size and
+// its items (see csmallarray.h), and it shares that pointer with the root of
+// the nodes, since a tree never has both.
+//
+// Without balancing a tree built from sorted input is a list as deep as it
+// is long, so no operation recurses on the tree's height.  Lookups and
+// insertions are loops; traversals, copies and counts keep the nodes still to
+// be visited on an explicit stack on the heap, and DestroyTree frees nodes by
+// rotating them into a vine as it goes.  Morris threading would avoid the
+// stack, but it rewrites links while it runs, which would make the const
+// traversals unsafe for concurrent readers or for callbacks that search the
+// tree.  Counts are size_t throughout.
 // ============================================================================
 
 #ifndef CBIN_SEARCH_TREE_HEADER
 #define CBIN_SEARCH_TREE_HEADER
 
+#include    <memory>
+#include    <type_traits>
+#include    <utility>
+#include    <vector>
 #include    "ctreenode.h"
+#include    "ccompare.h"
+#include    "cbloomfilter.h"
+#include    "cnodereclaimer.h"
+#include    "cbstreepolicy.h"
+
+// asks the CPU to start loading the memory at addr into the cache
+#if defined(__GNUC__) || defined(__clang__)
+#define     CBSTREE_PREFETCH(addr)      __builtin_prefetch(addr)
+#else
+#define     CBSTREE_PREFETCH(addr)      ((void)0)
+#endif
 
 // class declaration
-template    <typename  NodeType>
-class   CBSTree
+template    <typename  NodeType, typename  Compare = CThreeWayCompare<NodeType>
+            , typename  BalancePolicy = CRuntimeBalance
+            , typename  AllocPolicy = CHeapNodeAlloc<NodeType>
+            , typename  StatsPolicy = CLatencyStats
+            , typename  FeaturePolicy = CTreeFeatures<NodeType> >
+class   CBSTree : public BalancePolicy, public StatsPolicy
+                                                    , protected AllocPolicy
+                                                    , protected FeaturePolicy
+                                                    , private CCompareHolder<
+                                                                    Compare>
 {
+    // scapegoat mode needs the scapegoat state
+    static_assert((FeaturePolicy::FEATURES & FEATURE_SCAPEGOAT) != 0
+                    || !is_same<BalancePolicy
+                                , CFixedBalance<BALANCE_SCAPEGOAT> >::value
+                    , "CFixedBalance<BALANCE_SCAPEGOAT> needs "
+                      "FEATURE_SCAPEGOAT");
+
 public:
+    // the node type, a CTombstoneNode with lazy deletion and a CTreeNode
+    // without it (see CTreeFeatures)
+    typedef typename FeaturePolicy::TreeNode    TreeNode;
+
     // constructors and destructor
-    CBSTree() : m_root(NULL) {}
+    CBSTree();
+    explicit CBSTree(const Compare  &comp);
     CBSTree(const CBSTree  &other);
-    virtual ~CBSTree() { DestroyTree(); }
+    virtual ~CBSTree() { DestroyTree(); DisableFilter(); }
 
     // member functions
+    void    CompactLayout();
+    void    CompactTree();
     bool    DeleteItem(const NodeType  &target);
-    void    DestroyTree() { DestroyNodes(m_root); m_root = NULL; }
-    void    GetTreeInfo(int  &numNodes, int  &height) const;
+    size_t  DeleteRange(const NodeType  &lo, const NodeType  &hi);
+    void    DestroyTree();
+    void    DisableFilter();
+    bool    EnableFilter(double  falsePosRate = 0.01);
+    size_t  ExtractRange(const NodeType  &lo, const NodeType  &hi
+                                        , CBSTree  &dest);
+    bool    GetAsyncRelease() const { return m_bAsyncRelease; }
+    using   BalancePolicy::GetBalanceMode;
+    bool    GetFilterInfo(double  &estimatedRate, double  &observedRate) const;
+    size_t  GetNumItems() const;
+    double  GetTombstoneRatio() const;
+    void    GetTreeInfo(size_t  &numNodes, size_t  &height) const;
     void    InOrderTraverse(void  (*fPtr)(const NodeType&)) const;
     bool    InsertItem(const NodeType  &newItem);
-    bool    IsTreeEmpty() { return (NULL == m_root); }
+    bool    IsTreeEmpty() { return m_bSmallSet ? m_smallItems.empty()
+                                                : (NULL == m_root); }
     bool    ItemInTree(const NodeType  &target) const;
+    size_t  ItemsInTree(const NodeType  keys[], size_t  count
+                                        , bool  results[]) const;
+    size_t  LowerBounds(const NodeType  keys[], size_t  count
+                                        , const NodeType  *results[]) const;
+    bool    Max(NodeType  &item) const;
+    bool    Min(NodeType  &item) const;
+    bool    PopMax(NodeType  &item);
+    bool    PopMin(NodeType  &item);
     void    PostOrderTraverse(void (*fPtr)(const NodeType&)) const;
     void    PreOrderTraverse(void (*fPtr)(const NodeType&)) const;
     void    RebalanceTree();
+    void    SetAsyncRelease(bool  bAsync);
+    void    SetBalanceMode(BalanceMode  mode, double  alpha = 0.7);
+    void    SetFingerSearch(bool  bUseFinger) { m_bUseFinger = bUseFinger;
+                                                        m_finger.clear(); }
+    void    SetLazyDelete(bool  bLazy, double  maxTombstoneRatio = 0.25);
+    static void WaitForRelease();
+
+    // heterogeneous lookup, only available with a transparent comparator
+    template    <typename  KeyType, typename  Cmp = Compare
+                                    , typename = typename Cmp::is_transparent>
+    bool    ItemInTree(const KeyType  &target) const;
+
+    // walks the items of a tree in order, one at a time, without changing
+    // the tree; a cursor is valid only until the tree is next changed
+    class   CInOrderCursor
+    {
+    public:
+        explicit CInOrderCursor(const CBSTree  &tree);
+        bool    AtEnd() const { return (NULL == m_itemPtr); }
+        const NodeType&     Current() const { return *m_itemPtr; }
+        void    Next();
+
+    private:
+        void    Advance();
+        void    Settle();
+
+        const CBSTree                       *m_treePtr;
+        const NodeType                      *m_itemPtr;
+        size_t                              m_index;
+        vector<const TreeNode*>             m_pending;
+    };
 
     // operators
-    CBSTree<NodeType>&  operator=(const CBSTree<NodeType> &rhs);
+    CBSTree&    operator=(const CBSTree  &rhs);
 
 protected:
+    // one node on the finger path (see CFingerSearch); a bound is
+    // FINGER_NONE when there is none
+    typedef typename FeaturePolicy::CFingerStep     CFingerStep;
+
+    // tells whether the tree is built with a feature (see TreeFeature)
+    static constexpr bool   HasFeature(unsigned  feature)
+                        { return (FeaturePolicy::FEATURES & feature) != 0; }
+
+    static const size_t     FINGER_NONE = static_cast<size_t>(-1);
+
+    // the number of searches ItemsInTree and LowerBounds advance together
+    static const size_t     BATCH_WIDTH = 16;
+
+    // a small set grows into nodes when it would hold more than SMALL_MAX
+    // items, and nodes shrink back into a small set at SMALL_MIN items
+    static const size_t     SMALL_MAX = 64;
+    static const size_t     SMALL_MIN = SMALL_MAX / 2;
+
+    // selects one of a node's two child links (&CTreeNode::m_left or
+    // &CTreeNode::m_right), so a spine function can serve either end
+    typedef TreeNode*               TreeNode::*ChildLink;
+
     // member functions
-    int                     CountNodes(const CTreeNode<NodeType>  *nodePtr
-                                        , int  currDepth
-                                        , int  &numNodes) const;
-    CTreeNode<NodeType>*    Delete(const NodeType  &target
-                                        , CTreeNode<NodeType>  *nodePtr
+    TreeNode*               AllocNode(const NodeType  &newItem);
+    void                    BuildFromSorted(const NodeType  array[]
+                                        , size_t  count);
+    void                    BuildSpines() const;
+    template    <typename  LhsType, typename  RhsType>
+    int                     Compare3(const LhsType  &lhs
+                                        , const RhsType  &rhs) const;
+    void                    Compress(TreeNode  **link
+                                        , size_t  count);
+    size_t                  CountNodes(const TreeNode  *nodePtr
+                                        , size_t  &numNodes) const;
+    TreeNode*               Delete(const NodeType  &target
+                                        , TreeNode  *nodePtr
                                         , bool  &bItemDeleted);
-    void                    DestroyNodes(CTreeNode<NodeType>  *const nodePtr);
-    CTreeNode<NodeType>*    FindMinNode(CTreeNode<NodeType>  *nodePtr) const;
-    void                    InOrder(const CTreeNode<NodeType> *const nodePtr
+    void                    DestroyNodes(TreeNode  *nodePtr);
+    TreeNode*               DetachRange(const NodeType  &lo
+                                        , const NodeType  &hi
+                                        , size_t  &numNodes
+                                        , size_t  &numTombstones);
+    void                    ExtendSpines();
+    size_t                  FindFingerStart(const NodeType  &newItem) const;
+    TreeNode*               FindMinNode(TreeNode  *nodePtr) const;
+    bool                    FingerInsert(const NodeType  &newItem);
+    template    <typename  KeyType>
+    TreeNode*               FingerRetrieve(const KeyType  &target) const;
+    void                    FreeNode(TreeNode  *nodePtr);
+    void                    GrowToNodes();
+    const TreeNode*         FirstLive(const CSmallArray<TreeNode*>  &spine
+                                        , ChildLink  inner) const;
+    TreeNode*               GetRoot() const { return m_bSmallSet ? NULL
+                                                            : m_root; }
+    CSmallArray<TreeNode*>& GetSpine(ChildLink  inner
+                                , CSmallArray<TreeNode*>  &scratch) const;
+    bool                    InArena(const TreeNode  *nodePtr)
+                                                                    const;
+    template    <typename  KeyType>
+    bool                    InFingerRange(const KeyType  &target
+                                        , size_t  step) const;
+    void                    InOrder(const TreeNode  *nodePtr
+                                        , void (*fPtr)(const NodeType&)) const;
+    TreeNode*               Insert(const NodeType  &newItem
+                                        , TreeNode  *nodePtr
+                                        , bool  &bInserted);
+    TreeNode*               Join(TreeNode  *leftTree
+                                        , TreeNode  *rightTree);
+    bool                    LazyDelete(const NodeType  &target);
+    TreeNode*               LowerBound(const NodeType  &target
+                                        , TreeNode  *nodePtr) const;
+    bool                    PopExtreme(NodeType  &item, ChildLink  inner);
+    void                    PostOrder(const TreeNode  *nodePtr
                                         , void (*fPtr)(const NodeType&)) const;
-    CTreeNode<NodeType>*    Insert(const NodeType  &newItem
-                                        , CTreeNode<NodeType>  *nodePtr);
-    void                    PostOrder(const CTreeNode<NodeType>  *const nodePtr
+    void                    PreOrder(const TreeNode  *nodePtr
                                         , void (*fPtr)(const NodeType&)) const;
-    void                    PreOrder(const CTreeNode<NodeType>  *const nodePtr
+    void                    RebuildFilter(double  falsePosRate);
+    void                    ReleaseNodes(TreeNode  *nodePtr);
+    void                    Repopulate(const NodeType  array[]
+                                        , size_t  first, size_t  last);
+    void                    RestoreBalance();
+    void                    Revive(TreeNode  *nodePtr
+                                        , const NodeType  &newItem);
+    template    <typename  KeyType>
+    TreeNode*               Retrieve(const KeyType  &target
+                                        , TreeNode *nodePtr) const;
+    void                    SaveToArray(const TreeNode  *nodePtr
+                                        , NodeType  array[]
+                                        , size_t  &index);
+    void                    SaveToArray(NodeType  array[]);
+    using                   StatsPolicy::SampleLatency;
+    bool                    ScapegoatInsert(const NodeType  &newItem);
+    size_t                  ScapegoatLimit() const;
+    template    <typename  KeyType>
+    TreeNode*               Splay(const KeyType  &target
+                                        , TreeNode  *nodePtr) const;
+    bool                    SplayDelete(const NodeType  &target);
+    bool                    SplayInsert(const NodeType  &newItem);
+    void                    ShrinkToSmallSet();
+    template    <typename  KeyType>
+    size_t                  SmallBound(const KeyType  &target
+                                        , bool  bUpper) const;
+    size_t                  SmallEraseRange(const NodeType  &lo
+                                        , const NodeType  &hi
+                                        , CBSTree  *destPtr);
+    void                    SmallOrder(size_t  first, size_t  last
+                                        , bool  bPreOrder
                                         , void (*fPtr)(const NodeType&)) const;
-    void                    Repopulate(const NodeType array[], int first
-                                        , int last);
-    CTreeNode<NodeType>*    Retrieve(const NodeType  &target
-                                        , CTreeNode<NodeType> *nodePtr) const;
-    void                    SaveToArray(const CTreeNode<NodeType> *const nodePtr
-                                        , NodeType array[]
-                                        , int &index);
+    void                    Split(TreeNode  *nodePtr
+                                        , const NodeType  &key
+                                        , bool  bEqualGoesLeft
+                                        , TreeNode  *&leftTree
+                                        , TreeNode  *&rightTree);
+    size_t                  SubtreeSize(const TreeNode  *nodePtr)
+                                                                    const;
+    size_t                  TreeToVine(TreeNode  **link);
+    void                    VebOrder(TreeNode  *nodePtr
+                                        , size_t  levels
+                                        , vector<TreeNode*>  &order)
+                                                                    const;
+    void                    VineToTree(TreeNode  **link
+                                        , size_t  size);
 
 private:
     // member functions
-    CTreeNode<NodeType>*    CopyTree(const CTreeNode<NodeType>  *sourcePtr);
+    TreeNode*               CopyTree(const TreeNode  *sourcePtr);
+
+    // the state of the features, from FeaturePolicy (for a feature the
+    // tree is built without, a constant that takes no space)
+    using   FeaturePolicy::m_alpha;
+    using   FeaturePolicy::m_arena;
+    using   FeaturePolicy::m_arenaSize;
+    using   FeaturePolicy::m_bAsyncRelease;
+    using   FeaturePolicy::m_bLazyDelete;
+    using   FeaturePolicy::m_bSmallSet;
+    using   FeaturePolicy::m_bSpinesValid;
+    using   FeaturePolicy::m_bUseFinger;
+    using   FeaturePolicy::m_filter;
+    using   FeaturePolicy::m_finger;
+    using   FeaturePolicy::m_freeSlots;
+    using   FeaturePolicy::m_maxNodes;
+    using   FeaturePolicy::m_maxSpine;
+    using   FeaturePolicy::m_maxTombstoneRatio;
+    using   FeaturePolicy::m_minSpine;
+    using   FeaturePolicy::m_numNodes;
+    using   FeaturePolicy::m_numTombstones;
+    using   FeaturePolicy::m_path;
+    using   FeaturePolicy::m_root;
+    using   FeaturePolicy::m_smallItems;
 
-    // data members
-    CTreeNode<NodeType> *m_root;
+    // switching between the small set and the nodes, which share a word
+    // (see CSmallSet): the root is only valid while m_bSmallSet is false
+    using   FeaturePolicy::MakeEmpty;
+    using   FeaturePolicy::SwitchToNodes;
 };
 
 #include    "cbstree.cpp"
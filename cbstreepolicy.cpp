@@ -0,0 +1,267 @@
+// ============================================================================
+// File: cbstreepolicy.cpp
+// ============================================================================
+// This file contains the implementation of the CBSTree policy classes that
+// are not defined in their declarations.
+// ============================================================================
+
+#include    <new>
+using namespace std;
+#include    "cbstreepolicy.h"
+
+
+// ==== CPoolNodeAlloc::~CPoolNodeAlloc =======================================
+//
+// This is the destructor for the CPoolNodeAlloc class.  It releases every
+// chunk of the pool; the tree has destroyed all of its nodes by then.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  ChunkSize>
+CPoolNodeAlloc<NodeType, ChunkSize>::~CPoolNodeAlloc()
+{
+    for(size_t i = 0; i < m_chunks.size(); ++i)
+    {
+        ::operator delete(m_chunks[i]);
+    }
+
+}  // end of "CPoolNodeAlloc<NodeType>::~CPoolNodeAlloc"
+
+
+
+// ==== CPoolNodeAlloc::DeleteNode ============================================
+//
+// This function destroys a node and puts its slot at the head of the free
+// list.  The link to the next free slot is kept in the slot's own storage, so
+// the list costs no memory of its own.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a node returned by NewNode
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  ChunkSize>
+template    <typename  TreeNode>
+void    CPoolNodeAlloc<NodeType, ChunkSize>::DeleteNode(TreeNode  *nodePtr)
+{
+    nodePtr->~TreeNode();
+    *reinterpret_cast<void**>(nodePtr) = m_freeNodes;
+    m_freeNodes = nodePtr;
+
+}  // end of "CPoolNodeAlloc<NodeType>::DeleteNode"
+
+
+
+// ==== CPoolNodeAlloc::NewNode ===============================================
+//
+// This function constructs a node for a new item in the most recently freed
+// slot, or else in the next unused slot of the newest chunk, allocating a
+// new chunk of raw memory for ChunkSize nodes when that one is full.  A slot
+// is only taken once the node has been constructed, so a NodeType copy that
+// throws leaves the pool as it was.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference to the item for the node
+//
+// Output:
+//      A pointer to the new node.
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  ChunkSize>
+template    <typename  TreeNode>
+TreeNode*   CPoolNodeAlloc<NodeType, ChunkSize>::NewNode(
+                                        const NodeType  &newItem)
+{
+    void    *slotPtr;
+
+    if(m_freeNodes != NULL)
+    {
+        slotPtr = m_freeNodes;
+        void    *nextPtr = *static_cast<void**>(slotPtr);
+        TreeNode    *nodePtr = new(slotPtr) TreeNode(newItem);
+        m_freeNodes = nextPtr;
+        return nodePtr;
+    }
+
+    if(ChunkSize == m_numUsed)
+    {
+        m_chunks.reserve(m_chunks.size() + 1);
+        m_chunks.push_back(static_cast<char*>(::operator new(
+                                            ChunkSize * sizeof(TreeNode))));
+        m_numUsed = 0;
+    }
+    slotPtr = m_chunks.back() + m_numUsed * sizeof(TreeNode);
+    TreeNode    *nodePtr = new(slotPtr) TreeNode(newItem);
+    ++m_numUsed;
+    return nodePtr;
+
+}  // end of "CPoolNodeAlloc<NodeType>::NewNode"
+
+
+
+// ==== CLatencyStats::EnableLatencyStats =====================================
+//
+// This function starts recording the latency of the tree's operations, or
+// changes the sampling rate if it is already recording.  The histograms are
+// created empty; ones that already exist are kept.
+//
+// Access: public
+//
+// Input:
+//      sampleEvery [IN]    -- time one operation in this many (1 to time
+//                             them all)
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CLatencyStats::EnableLatencyStats(size_t  sampleEvery)
+{
+    if(m_stats == NULL)
+    {
+        m_stats = new CStatsBlock;
+    }
+    m_stats->m_sampleEvery = (sampleEvery < 1) ? 1 : sampleEvery;
+    m_stats->m_sampleCount = 0;
+
+}  // end of "CLatencyStats::EnableLatencyStats"
+
+
+
+// ==== CLatencyStats::ResetLatencyStats ======================================
+//
+// This function empties every latency histogram, if the stats are enabled.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CLatencyStats::ResetLatencyStats()
+{
+    if(m_stats == NULL)
+    {
+        return;
+    }
+
+    for(int op = 0; op < NUM_LATENCY_OPS; ++op)
+    {
+        m_stats->m_latency[op].Reset();
+    }
+    m_stats->m_sampleCount = 0;
+
+}  // end of "CLatencyStats::ResetLatencyStats"
+
+
+
+// ==== CLatencyStats::SampleLatency ==========================================
+//
+// This function decides whether the operation about to start is timed.
+//
+// Access: protected
+//
+// Input:
+//      op [IN]         -- the operation
+//
+// Output:
+//      A pointer to the histogram for the operation if it is to be timed, or
+//      NULL if the stats are disabled or this operation is not sampled.
+//
+// ============================================================================
+
+inline  CLatencyHistogram*  CLatencyStats::SampleLatency(LatencyOp  op) const
+{
+    if(m_stats == NULL || ++m_stats->m_sampleCount < m_stats->m_sampleEvery)
+    {
+        return NULL;
+    }
+
+    m_stats->m_sampleCount = 0;
+    return &m_stats->m_latency[op];
+
+}  // end of "CLatencyStats::SampleLatency"
+
+
+
+// ==== CSmallSet::MakeEmpty ==================================================
+//
+// This function leaves the tree empty, as a small set with no block.  If the
+// tree is using its nodes, they must have been freed already; the shared word
+// is then handed over to an empty array.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+void    CSmallSet<NodeType, TreeNode>::MakeEmpty()
+{
+    if(m_bSmallSet)
+    {
+        m_smallItems.Release();
+    }
+    else
+    {
+        new(&m_smallItems) CSmallArray<NodeType>();
+        m_bSmallSet = true;
+    }
+
+}  // end of "CSmallSet<NodeType, TreeNode>::MakeEmpty"
+
+
+
+// ==== CSmallSet::SwitchToNodes ==============================================
+//
+// This function hands the shared word over from the small set to the root of
+// the tree's nodes, which starts out NULL.  The array's items are destroyed
+// and its block is freed, so the caller must have copied them into nodes
+// first.  A tree that is using its nodes already is left alone.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+void    CSmallSet<NodeType, TreeNode>::SwitchToNodes()
+{
+    if(!m_bSmallSet)
+    {
+        return;
+    }
+
+    m_smallItems.~CSmallArray();
+    m_root = NULL;
+    m_bSmallSet = false;
+
+}  // end of "CSmallSet<NodeType, TreeNode>::SwitchToNodes"
@@ -0,0 +1,529 @@
+// ============================================================================
+// File: cbstreepolicy.h
+// ============================================================================
+// This header file contains the policy classes that CBSTree takes as template
+// parameters, one for each feature that can be chosen at compile time:
+//
+//  BalancePolicy   -- CRuntimeBalance (the default) stores the balance mode,
+//                     which SetBalanceMode may change at any time.
+//                     CFixedBalance<Mode> fixes the mode for the life of the
+//                     tree; it stores nothing, and every test of the mode is
+//                     a test of a constant, so the code for the other modes
+//                     is compiled out.
+//
+//  AllocPolicy     -- CHeapNodeAlloc (the default) takes every node from the
+//                     heap with new.  CPoolNodeAlloc carves nodes out of
+//                     chunks of ChunkSize nodes owned by the tree and keeps
+//                     freed nodes on a free list; nodes are cheaper to
+//                     allocate and sit closer together, but they can only be
+//                     freed by the tree that owns them, so async release (see
+//                     CBSTree::SetAsyncRelease) frees them on the calling
+//                     thread.
+//
+//  StatsPolicy     -- CLatencyStats (the default) provides the latency
+//                     histograms of EnableLatencyStats and its companions.
+//                     CNoStats provides the same calls doing nothing; it
+//                     stores nothing, and its SampleLatency always returns
+//                     NULL, so the timers in CBSTree's operations compile
+//                     to nothing.  CLatencyStats itself is one pointer,
+//                     which is NULL until the stats are enabled.
+//
+//  FeaturePolicy   -- CTreeFeatures<NodeType, Features> picks which of the
+//                     features in TreeFeature the tree is built with.  Each
+//                     feature keeps its state in a mixin of its own, and a
+//                     feature that is left out is replaced by a mixin whose
+//                     members are static CNoState and CNoVector constants
+//                     (see cnostate.h), so it costs no space and its code
+//                     folds away.  The default, FEATURE_DEFAULT, covers what
+//                     a tree does unasked (counting, finger search, spines,
+//                     scapegoat mode and small sets); lazy deletion, the
+//                     filter, CompactLayout and async release are opt-in.
+//                     Only with FEATURE_LAZY_DELETE do the nodes carry a
+//                     tombstone flag (they are CTombstoneNodes rather than
+//                     CTreeNodes), and with FEATURE_NONE a tree is laid out
+//                     just like a plain binary search tree: a root pointer,
+//                     and nodes of a value and two links.
+//                     The root pointer lives in the small-set mixin, in a
+//                     union with the small set's array.
+//
+// CBSTree derives from its four policies, so a policy without data members
+// adds nothing to the size of the tree, and the calls into a policy are
+// resolved and inlined at compile time.  The public members of the balance and
+// stats policies are part of CBSTree's interface.
+// ============================================================================
+
+#ifndef CBSTREE_POLICY_HEADER
+#define CBSTREE_POLICY_HEADER
+
+#include    <memory>
+#include    <type_traits>
+#include    <vector>
+using namespace std;
+#include    "ctreenode.h"
+#include    "cnostate.h"
+#include    "csmallarray.h"
+#include    "cbloomfilter.h"
+#include    "clatencyhistogram.h"
+
+// the ways a CBSTree can restructure itself during normal operations
+enum    BalanceMode { BALANCE_NONE, BALANCE_SPLAY, BALANCE_SCAPEGOAT };
+
+// the CBSTree operations whose latency can be recorded (LATENCY_FIND covers
+// ItemInTree and LATENCY_POP covers PopMin and PopMax)
+enum    LatencyOp { LATENCY_INSERT, LATENCY_DELETE, LATENCY_FIND
+                    , LATENCY_DELETE_RANGE, LATENCY_POP, LATENCY_REBALANCE
+                    , NUM_LATENCY_OPS };
+
+// the features a CBSTree can be built with (see CTreeFeatures); they are bit
+// flags, to be combined with |
+enum    TreeFeature { FEATURE_NONE = 0
+                    , FEATURE_COUNT = 0x001         // O(1) GetNumItems
+                    , FEATURE_FINGER = 0x002        // finger search
+                    , FEATURE_SPINES = 0x004        // cached spines
+                    , FEATURE_SCAPEGOAT = 0x008     // BALANCE_SCAPEGOAT
+                    , FEATURE_SMALL_SET = 0x010     // small trees as arrays
+                    , FEATURE_LAZY_DELETE = 0x020   // SetLazyDelete
+                    , FEATURE_FILTER = 0x040        // EnableFilter
+                    , FEATURE_COMPACT_LAYOUT = 0x080    // CompactLayout
+                    , FEATURE_ASYNC_RELEASE = 0x100     // SetAsyncRelease
+                    , FEATURE_DEFAULT = 0x01F
+                    , FEATURE_ALL = 0x1FF };
+
+// class declaration
+class   CRuntimeBalance
+{
+public:
+    // constructor
+    CRuntimeBalance() : m_balanceMode(BALANCE_NONE) {}
+
+    // member functions
+    BalanceMode GetBalanceMode() const { return m_balanceMode; }
+
+protected:
+    // member functions
+    bool    SelectBalanceMode(BalanceMode  mode) { m_balanceMode = mode;
+                                                            return true; }
+
+    // data members
+    BalanceMode     m_balanceMode;
+};
+
+// class declaration
+template    <BalanceMode  Mode>
+class   CFixedBalance
+{
+public:
+    // member functions
+    static constexpr BalanceMode    GetBalanceMode() { return Mode; }
+
+protected:
+    // member functions
+    static bool     SelectBalanceMode(BalanceMode  mode)
+                                                    { return (Mode == mode); }
+};
+
+// class declaration
+template    <typename  NodeType>
+class   CHeapNodeAlloc
+{
+protected:
+    // nodes come from the heap, so any thread may delete them
+    static const bool   IS_HEAP = true;
+
+    // member functions (TreeNode is the tree's node type, see CTreeFeatures)
+    template    <typename  TreeNode>
+    TreeNode*   NewNode(const NodeType  &newItem)
+                                { return new TreeNode(newItem); }
+    template    <typename  TreeNode>
+    void        DeleteNode(TreeNode  *nodePtr) { delete nodePtr; }
+};
+
+// class declaration
+template    <typename  NodeType, size_t  ChunkSize = 256>
+class   CPoolNodeAlloc
+{
+public:
+    // constructors and destructor (a copy starts with a pool of its own,
+    // and assignment leaves each tree's pool where it is)
+    CPoolNodeAlloc() : m_freeNodes(NULL), m_numUsed(ChunkSize) {}
+    CPoolNodeAlloc(const CPoolNodeAlloc&) : m_freeNodes(NULL)
+                                            , m_numUsed(ChunkSize) {}
+    ~CPoolNodeAlloc();
+
+    // operators
+    CPoolNodeAlloc&     operator=(const CPoolNodeAlloc&) { return *this; }
+
+protected:
+    // nodes belong to the pool, so only its owner may free them
+    static const bool   IS_HEAP = false;
+
+    // member functions (a pool only ever holds one TreeNode type, the one
+    // its tree uses)
+    template    <typename  TreeNode>
+    void        DeleteNode(TreeNode  *nodePtr);
+    template    <typename  TreeNode>
+    TreeNode*   NewNode(const NodeType  &newItem);
+
+    // data members
+    vector<char*>       m_chunks;
+    void                *m_freeNodes;
+    size_t              m_numUsed;
+};
+
+// class declaration
+class   CLatencyStats
+{
+public:
+    // constructors and destructor (stats belong to one tree object, so a
+    // copy starts without any, and assignment leaves them as they are)
+    CLatencyStats() : m_stats(NULL) {}
+    CLatencyStats(const CLatencyStats&) : m_stats(NULL) {}
+    ~CLatencyStats() { delete m_stats; }
+
+    // member functions
+    void    DisableLatencyStats() { delete m_stats; m_stats = NULL; }
+    void    EnableLatencyStats(size_t  sampleEvery = 1);
+    const CLatencyHistogram*    GetLatencyStats(LatencyOp  op) const
+            { return (NULL == m_stats) ? NULL : &m_stats->m_latency[op]; }
+    void    ResetLatencyStats();
+
+    // operators
+    CLatencyStats&  operator=(const CLatencyStats&) { return *this; }
+
+protected:
+    // member functions
+    CLatencyHistogram*  SampleLatency(LatencyOp  op) const;
+
+    // the histograms and the sampling counters, in one block that is only
+    // allocated while the stats are enabled
+    struct  CStatsBlock
+    {
+        CLatencyHistogram   m_latency[NUM_LATENCY_OPS];
+        size_t              m_sampleEvery;
+        size_t              m_sampleCount;
+    };
+
+    // data members
+    CStatsBlock         *m_stats;
+};
+
+// class declaration
+class   CNoStats
+{
+public:
+    // member functions
+    void    DisableLatencyStats() {}
+    void    EnableLatencyStats(size_t = 1) {}
+    const CLatencyHistogram*    GetLatencyStats(LatencyOp) const
+                                                        { return NULL; }
+    void    ResetLatencyStats() {}
+
+protected:
+    // member functions
+    CLatencyHistogram*  SampleLatency(LatencyOp) const { return NULL; }
+};
+
+// the state of each feature, and the stand-in for it when it is left out;
+// the member names are shared, so CBSTree can use either (see cnostate.h)
+
+// class declaration
+class   CNodeCount
+{
+protected:
+    // constructor
+    CNodeCount() : m_numNodes(0) {}
+
+    // data members (tombstones included)
+    size_t          m_numNodes;
+};
+
+// class declaration
+class   CNoNodeCount
+{
+protected:
+    // data members
+    static constexpr CNoState<size_t>   m_numNodes = CNoState<size_t>();
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CFingerSearch
+{
+public:
+    // one node on the finger path; the bound members are the positions on
+    // the path of the nearest ancestors whose values bound this node's
+    // subtree from below and from above (CBSTree::FINGER_NONE if there is
+    // no bound)
+    struct  CFingerStep
+    {
+        TreeNode    *m_node;
+        size_t      m_loBound;
+        size_t      m_hiBound;
+    };
+
+protected:
+    // constructor
+    CFingerSearch() : m_bUseFinger(true) {}
+
+    // data members
+    vector<CFingerStep>     m_finger;
+    bool                    m_bUseFinger;
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CNoFingerSearch
+{
+protected:
+    typedef typename CFingerSearch<TreeNode>::CFingerStep     CFingerStep;
+
+    // data members
+    static constexpr CNoVector<CFingerStep>     m_finger
+                                                = CNoVector<CFingerStep>();
+    static constexpr CNoState<bool>             m_bUseFinger
+                                                = CNoState<bool>();
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CSpineCache
+{
+protected:
+    // constructor
+    CSpineCache() : m_bSpinesValid(false) {}
+
+    // data members
+    mutable CSmallArray<TreeNode*>  m_minSpine;
+    mutable CSmallArray<TreeNode*>  m_maxSpine;
+    mutable bool                    m_bSpinesValid;
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CNoSpineCache
+{
+protected:
+    // data members
+    static constexpr CNoVector<TreeNode*>   m_minSpine
+                                            = CNoVector<TreeNode*>();
+    static constexpr CNoVector<TreeNode*>   m_maxSpine
+                                            = CNoVector<TreeNode*>();
+    static constexpr CNoState<bool>         m_bSpinesValid = CNoState<bool>();
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CScapegoatState
+{
+protected:
+    // constructor
+    CScapegoatState() : m_alpha(0.7), m_maxNodes(0) {}
+
+    // data members
+    double                  m_alpha;
+    size_t                  m_maxNodes;
+    vector<TreeNode**>      m_path;
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CNoScapegoatState
+{
+protected:
+    // data members
+    static constexpr CNoState<double>       m_alpha = CNoState<double>();
+    static constexpr CNoState<size_t>       m_maxNodes = CNoState<size_t>();
+    static constexpr CNoVector<TreeNode**>  m_path = CNoVector<TreeNode**>();
+};
+
+// the root of the tree's nodes is kept with the small set, since the two
+// share one word: m_bSmallSet tells which of them the tree is using
+
+// class declaration
+template    <typename  NodeType, typename  TreeNode>
+class   CSmallSet
+{
+protected:
+    // constructor and destructor (the items are the tree's to free)
+    CSmallSet() : m_smallItems(), m_bSmallSet(true) {}
+    ~CSmallSet() { if(m_bSmallSet) m_smallItems.~CSmallArray(); }
+
+    // member functions (for MakeEmpty, the nodes must be freed already)
+    void    MakeEmpty();
+    void    SwitchToNodes();
+
+    // data members (the root is mutable so that a splaying lookup can
+    // move the node it finds to the top of the tree)
+    union
+    {
+        mutable TreeNode        *m_root;
+        CSmallArray<NodeType>   m_smallItems;
+    };
+    bool                        m_bSmallSet;
+};
+
+// class declaration
+template    <typename  NodeType, typename  TreeNode>
+class   CNoSmallSet
+{
+protected:
+    // constructor
+    CNoSmallSet() : m_root(NULL) {}
+
+    // member functions
+    void    MakeEmpty() { m_root = NULL; }
+    void    SwitchToNodes() {}
+
+    // data members
+    mutable TreeNode                        *m_root;
+    static constexpr CNoVector<NodeType>    m_smallItems
+                                            = CNoVector<NodeType>();
+    static constexpr CNoState<bool>         m_bSmallSet = CNoState<bool>();
+};
+
+// class declaration
+class   CLazyDelete
+{
+protected:
+    // constructor
+    CLazyDelete() : m_bLazyDelete(false), m_maxTombstoneRatio(0.25)
+                                        , m_numTombstones(0) {}
+
+    // data members
+    bool            m_bLazyDelete;
+    double          m_maxTombstoneRatio;
+    size_t          m_numTombstones;
+};
+
+// class declaration
+class   CNoLazyDelete
+{
+protected:
+    // data members
+    static constexpr CNoState<bool>     m_bLazyDelete = CNoState<bool>();
+    static constexpr CNoState<double>   m_maxTombstoneRatio
+                                                    = CNoState<double>();
+    static constexpr CNoState<size_t>   m_numTombstones = CNoState<size_t>();
+};
+
+// class declaration
+template    <typename  NodeType>
+class   CItemFilter
+{
+protected:
+    // constructor
+    CItemFilter() : m_filter(NULL) {}
+
+    // data members
+    CCountingBloomFilter<NodeType>  *m_filter;
+};
+
+// class declaration
+template    <typename  NodeType>
+class   CNoItemFilter
+{
+protected:
+    // data members
+    static constexpr CNoState<CCountingBloomFilter<NodeType>*>   m_filter
+                            = CNoState<CCountingBloomFilter<NodeType>*>();
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CNodeArena
+{
+protected:
+    // constructor
+    CNodeArena() : m_arena(NULL), m_arenaSize(0) {}
+
+    // data members
+    TreeNode                *m_arena;
+    size_t                  m_arenaSize;
+    vector<TreeNode*>       m_freeSlots;
+};
+
+// class declaration
+template    <typename  TreeNode>
+class   CNoNodeArena
+{
+protected:
+    // data members
+    static constexpr CNoState<TreeNode*>    m_arena = CNoState<TreeNode*>();
+    static constexpr CNoState<size_t>       m_arenaSize = CNoState<size_t>();
+    static constexpr CNoVector<TreeNode*>   m_freeSlots
+                                            = CNoVector<TreeNode*>();
+};
+
+// class declaration
+class   CAsyncRelease
+{
+protected:
+    // constructor
+    CAsyncRelease() : m_bAsyncRelease(false) {}
+
+    // data members
+    bool            m_bAsyncRelease;
+};
+
+// class declaration
+class   CNoAsyncRelease
+{
+protected:
+    // data members
+    static constexpr CNoState<bool>     m_bAsyncRelease = CNoState<bool>();
+};
+
+// the node type of a tree of NodeType values built with the given features
+template    <typename  NodeType, unsigned  Features>
+using   CFeatureNode = typename conditional<
+                                (Features & FEATURE_LAZY_DELETE) != 0
+                                , CTombstoneNode<NodeType>
+                                , CTreeNode<NodeType> >::type;
+
+// class declaration
+template    <typename  NodeType, unsigned  Features = FEATURE_DEFAULT>
+class   CTreeFeatures
+    : public conditional<(Features & FEATURE_COUNT) != 0
+                    , CNodeCount, CNoNodeCount>::type
+    , public conditional<(Features & FEATURE_FINGER) != 0
+                    , CFingerSearch<CFeatureNode<NodeType, Features> >
+                    , CNoFingerSearch<CFeatureNode<NodeType, Features> >
+                    >::type
+    , public conditional<(Features & FEATURE_SPINES) != 0
+                    , CSpineCache<CFeatureNode<NodeType, Features> >
+                    , CNoSpineCache<CFeatureNode<NodeType, Features> >
+                    >::type
+    , public conditional<(Features & FEATURE_SCAPEGOAT) != 0
+                    , CScapegoatState<CFeatureNode<NodeType, Features> >
+                    , CNoScapegoatState<CFeatureNode<NodeType, Features> >
+                    >::type
+    , public conditional<(Features & FEATURE_SMALL_SET) != 0
+                    , CSmallSet<NodeType, CFeatureNode<NodeType, Features> >
+                    , CNoSmallSet<NodeType, CFeatureNode<NodeType, Features> >
+                    >::type
+    , public conditional<(Features & FEATURE_LAZY_DELETE) != 0
+                    , CLazyDelete, CNoLazyDelete>::type
+    , public conditional<(Features & FEATURE_FILTER) != 0
+                    , CItemFilter<NodeType>, CNoItemFilter<NodeType> >::type
+    , public conditional<(Features & FEATURE_COMPACT_LAYOUT) != 0
+                    , CNodeArena<CFeatureNode<NodeType, Features> >
+                    , CNoNodeArena<CFeatureNode<NodeType, Features> >
+                    >::type
+    , public conditional<(Features & FEATURE_ASYNC_RELEASE) != 0
+                    , CAsyncRelease, CNoAsyncRelease>::type
+{
+    // the features that work from the number of nodes need it kept
+    static_assert((Features & FEATURE_COUNT) != 0
+                        || (Features & (FEATURE_SCAPEGOAT | FEATURE_SMALL_SET
+                                        | FEATURE_LAZY_DELETE)) == 0
+                        , "FEATURE_SCAPEGOAT, FEATURE_SMALL_SET and "
+                          "FEATURE_LAZY_DELETE need FEATURE_COUNT");
+
+public:
+    // the features, and the node type that goes with them
+    static const unsigned   FEATURES = Features;
+    typedef CFeatureNode<NodeType, Features>    TreeNode;
+};
+
+#include    "cbstreepolicy.cpp"
+#endif  // CBSTREE_POLICY_HEADER
@@ -0,0 +1,619 @@
+// ============================================================================
+// File: cbufferpool.cpp
+// ============================================================================
+// This file contains the implementation of the CBufferPool class.
+// ============================================================================
+
+#include    <cerrno>
+#include    <cstring>
+#include    <fcntl.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
+using namespace std;
+#include    "cbufferpool.h"
+
+
+// ==== CBufferPool::CBufferPool ==============================================
+//
+// This is the constructor for the CBufferPool class.  The pool has no file
+// and no frames until Open is called.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// ============================================================================
+
+inline  CBufferPool::CBufferPool() : m_fd(-1)
+                                    , m_pageSize(0)
+                                    , m_maxFrames(0)
+                                    , m_numPages(0)
+                                    , m_clockHand(0)
+                                    , m_numDirty(0)
+                                    , m_numHits(0)
+                                    , m_numMisses(0)
+                                    , m_bFailed(false)
+                                    , m_bWakeWriter(false)
+                                    , m_bWriterBusy(false)
+                                    , m_bStopping(false)
+{
+}  // end of "CBufferPool::CBufferPool"
+
+
+
+// ==== CBufferPool::Close ====================================================
+//
+// This function writes every dirty page back, stops the writer thread, frees
+// the frames and closes the file.  No page may be pinned.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CBufferPool::Close()
+{
+    if(m_fd < 0)
+    {
+        return;
+    }
+
+    Sync();
+    {
+        lock_guard<mutex>   lock(m_mutex);
+        m_bStopping = true;
+    }
+    m_writerCond.notify_one();
+    m_writer.join();
+
+    for(size_t i = 0; i < m_frames.size(); ++i)
+    {
+        delete [] m_frames[i].m_data;
+    }
+    m_frames.clear();
+    m_pageTable.clear();
+    close(m_fd);
+    m_fd = -1;
+
+}  // end of "CBufferPool::Close"
+
+
+
+// ==== CBufferPool::FetchPage ================================================
+//
+// This function returns the frame holding a page, pinned.  If the page is not
+// resident a frame is found for it with CBufferPool::FindFrame and the page is
+// read from the file; a page that cannot be read is returned zeroed, and the
+// failure is reported by the next Sync.
+//
+// Access: public
+//
+// Input:
+//      pageNo [IN]     -- the number of the page, which must be less than
+//                         GetNumPages()
+//
+// Output:
+//      A pointer to the page's GetPageSize() bytes, valid until the page is
+//      unpinned.
+//
+// ============================================================================
+
+inline  char*   CBufferPool::FetchPage(uint64_t  pageNo)
+{
+    lock_guard<mutex>   lock(m_mutex);
+    unordered_map<uint64_t, size_t>::iterator   iter;
+    size_t              index;
+
+    iter = m_pageTable.find(pageNo);
+    if(iter != m_pageTable.end())
+    {
+        CFrame  &frame = m_frames[iter->second];
+
+        ++frame.m_pinCount;
+        frame.m_bReferenced = true;
+        ++m_numHits;
+        return frame.m_data;
+    }
+
+    ++m_numMisses;
+    index = FindFrame();
+
+    CFrame  &frame = m_frames[index];
+    if(pread(m_fd, frame.m_data, m_pageSize
+                    , static_cast<off_t>(pageNo * m_pageSize))
+                                    != static_cast<ssize_t>(m_pageSize))
+    {
+        memset(frame.m_data, 0, m_pageSize);
+        m_bFailed = true;
+    }
+    frame.m_pageNo = pageNo;
+    frame.m_pinCount = 1;
+    frame.m_bReferenced = true;
+    m_pageTable[pageNo] = index;
+    return frame.m_data;
+
+}  // end of "CBufferPool::FetchPage"
+
+
+
+// ==== CBufferPool::FindFrame ================================================
+//
+// This function finds a frame for a page that is about to be brought in.
+// Until the pool holds its full number of frames a new one is allocated;
+// after that the CLOCK hand sweeps the frames for an unpinned one that has
+// not been used since the hand last passed it.  A dirty page in the chosen
+// frame is written back first.  Two sweeps clear every use bit, so if they
+// find nothing then every frame is pinned, and the pool grows instead.  The
+// caller holds the lock.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The index of an empty, unpinned frame.
+//
+// ============================================================================
+
+inline  size_t  CBufferPool::FindFrame()
+{
+    if(m_frames.size() >= m_maxFrames)
+    {
+        for(size_t n = 0; n < 2 * m_frames.size(); ++n)
+        {
+            size_t  index = m_clockHand;
+            CFrame  &frame = m_frames[index];
+
+            m_clockHand = (m_clockHand + 1) % m_frames.size();
+            if(frame.m_pinCount > 0)
+            {
+                continue;
+            }
+            if(frame.m_bReferenced)
+            {
+                frame.m_bReferenced = false;
+                continue;
+            }
+
+            if(frame.m_bDirty)
+            {
+                if(!WritePage(frame.m_pageNo, frame.m_data))
+                {
+                    m_bFailed = true;
+                }
+                frame.m_bDirty = false;
+                --m_numDirty;
+            }
+            if(frame.m_pageNo != NO_PAGE)
+            {
+                m_pageTable.erase(frame.m_pageNo);
+                frame.m_pageNo = NO_PAGE;
+            }
+            return index;
+        }
+    }
+
+    CFrame  frame = { new char[m_pageSize], NO_PAGE, 0, false, false };
+    m_frames.push_back(frame);
+    return m_frames.size() - 1;
+
+}  // end of "CBufferPool::FindFrame"
+
+
+
+// ==== CBufferPool::MarkDirty ================================================
+//
+// This function marks a frame dirty, and wakes the writer thread once a
+// quarter of the frames are dirty.  The caller holds the lock.
+//
+// Access: protected
+//
+// Input:
+//      frame [IN/OUT]  -- the frame
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CBufferPool::MarkDirty(CFrame  &frame)
+{
+    if(frame.m_bDirty)
+    {
+        return;
+    }
+
+    frame.m_bDirty = true;
+    if(++m_numDirty * 4 >= m_maxFrames)
+    {
+        m_bWakeWriter = true;
+        m_writerCond.notify_one();
+    }
+
+}  // end of "CBufferPool::MarkDirty"
+
+
+
+// ==== CBufferPool::NewPage ==================================================
+//
+// This function adds a page to the end of the file.  The page is created in
+// a frame, zeroed, pinned and dirty; it reaches the file when it is written
+// back.
+//
+// Access: public
+//
+// Input:
+//      pageNo [OUT]    -- receives the number of the new page
+//
+// Output:
+//      A pointer to the new page's bytes, valid until the page is unpinned.
+//
+// ============================================================================
+
+inline  char*   CBufferPool::NewPage(uint64_t  &pageNo)
+{
+    lock_guard<mutex>   lock(m_mutex);
+    size_t              index = FindFrame();
+    CFrame              &frame = m_frames[index];
+
+    pageNo = m_numPages++;
+    memset(frame.m_data, 0, m_pageSize);
+    frame.m_pageNo = pageNo;
+    frame.m_pinCount = 1;
+    frame.m_bReferenced = true;
+    MarkDirty(frame);
+    m_pageTable[pageNo] = index;
+    return frame.m_data;
+
+}  // end of "CBufferPool::NewPage"
+
+
+
+// ==== CBufferPool::Open =====================================================
+//
+// This function opens (or creates) the file the pool caches, closing the
+// file it had open, and starts the writer thread.
+//
+// Access: public
+//
+// Input:
+//      path [IN]           -- the name of the file
+//
+//      pageSize [IN]       -- the size of a page in bytes
+//
+//      memoryBudget [IN]   -- the number of bytes the frames may take up; the
+//                             pool holds at least MIN_FRAMES frames
+//
+// Output:
+//      A value of true if the file was opened, false otherwise.
+//
+// ============================================================================
+
+inline  bool    CBufferPool::Open(const string  &path, size_t  pageSize
+                                                    , size_t  memoryBudget)
+{
+    struct stat fileInfo;
+
+    Close();
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(m_fd < 0)
+    {
+        return false;
+    }
+    if(fstat(m_fd, &fileInfo) != 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_pageSize = pageSize;
+    m_maxFrames = memoryBudget / pageSize;
+    if(m_maxFrames < MIN_FRAMES)
+    {
+        m_maxFrames = MIN_FRAMES;
+    }
+    m_numPages = static_cast<uint64_t>(fileInfo.st_size) / pageSize;
+    m_clockHand = 0;
+    m_numDirty = 0;
+    m_numHits = 0;
+    m_numMisses = 0;
+    m_bFailed = false;
+    m_bWakeWriter = false;
+    m_bWriterBusy = false;
+    m_bStopping = false;
+    m_writer = thread(&CBufferPool::RunWriter, this);
+    return true;
+
+}  // end of "CBufferPool::Open"
+
+
+
+// ==== CBufferPool::RunWriter ================================================
+//
+// This function is the body of the writer thread.  Each time it is woken it
+// sweeps the frames, copying up to WRITE_BATCH dirty, unpinned pages at a
+// time under the lock and writing the copies with the lock released.  Each
+// copied page is marked clean and pinned until its write is done, so a page
+// dirtied again meanwhile is simply written again later.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CBufferPool::RunWriter()
+{
+    vector<char>        buffer(WRITE_BATCH * m_pageSize);
+    vector<size_t>      batch;
+    vector<uint64_t>    pageNos;
+    vector<bool>        written;
+    unique_lock<mutex>  lock(m_mutex);
+
+    for(;;)
+    {
+        m_writerCond.wait(lock, [this] { return m_bWakeWriter
+                                                    || m_bStopping; });
+        if(m_bStopping)
+        {
+            break;
+        }
+        m_bWakeWriter = false;
+        m_bWriterBusy = true;
+
+        size_t  next = 0;
+        while(next < m_frames.size())
+        {
+            batch.clear();
+            pageNos.clear();
+            for(; next < m_frames.size() && batch.size() < WRITE_BATCH
+                                                                    ; ++next)
+            {
+                CFrame  &frame = m_frames[next];
+                if(frame.m_bDirty && 0 == frame.m_pinCount)
+                {
+                    memcpy(&buffer[batch.size() * m_pageSize], frame.m_data
+                                                            , m_pageSize);
+                    frame.m_bDirty = false;
+                    --m_numDirty;
+                    ++frame.m_pinCount;
+                    batch.push_back(next);
+                    pageNos.push_back(frame.m_pageNo);
+                }
+            }
+
+            lock.unlock();
+            written.assign(batch.size(), false);
+            for(size_t i = 0; i < batch.size(); ++i)
+            {
+                written[i] = WritePage(pageNos[i], &buffer[i * m_pageSize]);
+            }
+            lock.lock();
+
+            for(size_t i = 0; i < batch.size(); ++i)
+            {
+                if(!written[i])
+                {
+                    m_bFailed = true;
+                }
+                --m_frames[batch[i]].m_pinCount;
+            }
+        }
+
+        m_bWriterBusy = false;
+        m_idleCond.notify_all();
+    }
+
+}  // end of "CBufferPool::RunWriter"
+
+
+
+// ==== CBufferPool::Sync =====================================================
+//
+// This function waits for the writer thread to finish its pass, writes every
+// page that is still dirty and flushes the file to disk.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if everything was written and no earlier read or write
+//      has failed, false otherwise (or if no file is open).
+//
+// ============================================================================
+
+inline  bool    CBufferPool::Sync()
+{
+    if(m_fd < 0)
+    {
+        return false;
+    }
+
+    unique_lock<mutex>  lock(m_mutex);
+
+    WaitForWriter(lock);
+    for(size_t i = 0; i < m_frames.size(); ++i)
+    {
+        CFrame  &frame = m_frames[i];
+        if(frame.m_bDirty)
+        {
+            if(!WritePage(frame.m_pageNo, frame.m_data))
+            {
+                m_bFailed = true;
+            }
+            frame.m_bDirty = false;
+            --m_numDirty;
+        }
+    }
+    if(fsync(m_fd) != 0)
+    {
+        m_bFailed = true;
+    }
+    return !m_bFailed;
+
+}  // end of "CBufferPool::Sync"
+
+
+
+// ==== CBufferPool::Truncate =================================================
+//
+// This function cuts the file down to a number of pages, dropping without
+// writing them any resident pages past the new end.  None of those pages may
+// be pinned.
+//
+// Access: public
+//
+// Input:
+//      numPages [IN]   -- the number of pages to keep
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CBufferPool::Truncate(uint64_t  numPages)
+{
+    unique_lock<mutex>  lock(m_mutex);
+
+    WaitForWriter(lock);
+    for(size_t i = 0; i < m_frames.size(); ++i)
+    {
+        CFrame  &frame = m_frames[i];
+        if(frame.m_pageNo != NO_PAGE && frame.m_pageNo >= numPages)
+        {
+            m_pageTable.erase(frame.m_pageNo);
+            if(frame.m_bDirty)
+            {
+                frame.m_bDirty = false;
+                --m_numDirty;
+            }
+            frame.m_pageNo = NO_PAGE;
+            frame.m_bReferenced = false;
+        }
+    }
+
+    if(ftruncate(m_fd, static_cast<off_t>(numPages * m_pageSize)) != 0)
+    {
+        m_bFailed = true;
+    }
+    m_numPages = numPages;
+
+}  // end of "CBufferPool::Truncate"
+
+
+
+// ==== CBufferPool::UnpinPage ================================================
+//
+// This function releases one pin on a page fetched with FetchPage or created
+// with NewPage.
+//
+// Access: public
+//
+// Input:
+//      pageNo [IN]     -- the number of the page
+//
+//      bDirty [IN]     -- true if the page was changed while pinned
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CBufferPool::UnpinPage(uint64_t  pageNo, bool  bDirty)
+{
+    lock_guard<mutex>   lock(m_mutex);
+    unordered_map<uint64_t, size_t>::iterator   iter;
+
+    iter = m_pageTable.find(pageNo);
+    if(iter == m_pageTable.end())
+    {
+        return;
+    }
+
+    CFrame  &frame = m_frames[iter->second];
+    if(bDirty)
+    {
+        MarkDirty(frame);
+    }
+    --frame.m_pinCount;
+
+}  // end of "CBufferPool::UnpinPage"
+
+
+
+// ==== CBufferPool::WaitForWriter ============================================
+//
+// This function blocks until the writer thread is between passes, so that
+// the caller can touch every frame without racing one of its writes.
+//
+// Access: protected
+//
+// Input:
+//      lock [IN/OUT]   -- the caller's lock on the pool's mutex
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CBufferPool::WaitForWriter(unique_lock<mutex>  &lock)
+{
+    m_idleCond.wait(lock, [this] { return !m_bWriterBusy; });
+
+}  // end of "CBufferPool::WaitForWriter"
+
+
+
+// ==== CBufferPool::WritePage ================================================
+//
+// This function writes one page to its place in the file, retrying after a
+// partial write or an interrupted call.
+//
+// Access: protected
+//
+// Input:
+//      pageNo [IN]     -- the number of the page
+//
+//      data [IN]       -- the page's bytes
+//
+// Output:
+//      A value of true if the whole page was written, false otherwise.
+//
+// ============================================================================
+
+inline  bool    CBufferPool::WritePage(uint64_t  pageNo, const char  *data)
+{
+    size_t  done = 0;
+    ssize_t numWritten;
+
+    while(done < m_pageSize)
+    {
+        numWritten = pwrite(m_fd, data + done, m_pageSize - done
+                        , static_cast<off_t>(pageNo * m_pageSize + done));
+        if(numWritten < 0)
+        {
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(numWritten);
+    }
+    return true;
+
+}  // end of "CBufferPool::WritePage"
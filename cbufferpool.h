@@ -0,0 +1,154 @@
+// ============================================================================
+// File: cbufferpool.h
+// ============================================================================
+// This header file contains the declarations of the CBufferPool and
+// CPageHandle classes, which cache the fixed-size pages of a file in memory.
+//
+// The pool holds at most a given number of page frames, set from a memory
+// budget when the file is opened; frames are allocated as they are first
+// needed.  FetchPage returns a frame holding the page, reading it from the
+// file if it is not resident, and pins the frame so that it stays put until
+// UnpinPage is called.  A page that was changed is unpinned as dirty, and is
+// written back before its frame is reused.  When every frame is in use the
+// one to reuse is chosen by the CLOCK algorithm: the frames form a ring, each
+// with a bit set when its page is used, and a hand sweeps the ring clearing
+// the bits until it finds an unpinned frame whose bit is already clear.  That
+// approximates LRU at the cost of one store per access.  If every frame is
+// pinned the pool grows by one frame rather than fail.
+//
+// Writing back a dirty page from inside FetchPage would put a disk write in
+// the middle of a lookup, so a background thread writes dirty pages ahead of
+// time: once a quarter of the frames are dirty, it copies every dirty page
+// that is not pinned and writes the copies out with the pool unlocked.  A
+// page is kept pinned while its copy is being written, so that it can be
+// neither reused nor read back in before the write lands.  Sync writes
+// whatever is still dirty and flushes the file.  A failed read or write is
+// remembered and reported by the next Sync.
+//
+// A CPageHandle fetches a page when it is created and unpins it when it goes
+// out of scope, as dirty if SetDirty was called, so that no path out of a
+// function can leave a page pinned.
+//
+// The pool may be used by one thread at a time (apart from its own writer).
+// The file is accessed with POSIX calls.  The classes are not templates, so
+// their functions are declared inline to let the header be included by more
+// than one source file.
+// ============================================================================
+
+#ifndef CBUFFER_POOL_HEADER
+#define CBUFFER_POOL_HEADER
+
+#include    <condition_variable>
+#include    <cstdint>
+#include    <mutex>
+#include    <string>
+#include    <thread>
+#include    <unordered_map>
+#include    <vector>
+using namespace std;
+
+// class declaration
+class   CBufferPool
+{
+public:
+    // constructor and destructor
+    CBufferPool();
+    ~CBufferPool() { Close(); }
+
+    // member functions
+    void        Close();
+    char*       FetchPage(uint64_t  pageNo);
+    size_t      GetNumFrames() const { return m_frames.size(); }
+    size_t      GetNumHits() const { return m_numHits; }
+    size_t      GetNumMisses() const { return m_numMisses; }
+    uint64_t    GetNumPages() const { return m_numPages; }
+    size_t      GetPageSize() const { return m_pageSize; }
+    bool        IsOpen() const { return (m_fd >= 0); }
+    char*       NewPage(uint64_t  &pageNo);
+    bool        Open(const string  &path, size_t  pageSize
+                                        , size_t  memoryBudget);
+    bool        Sync();
+    void        Truncate(uint64_t  numPages);
+    void        UnpinPage(uint64_t  pageNo, bool  bDirty);
+
+    // the pool owns an open file and a thread, so it cannot be copied
+    CBufferPool(const CBufferPool  &other) = delete;
+    CBufferPool&    operator=(const CBufferPool  &rhs) = delete;
+
+protected:
+    // one page frame; m_pageNo is NO_PAGE while the frame is unused
+    struct  CFrame
+    {
+        char        *m_data;
+        uint64_t    m_pageNo;
+        unsigned    m_pinCount;
+        bool        m_bDirty;
+        bool        m_bReferenced;
+    };
+
+    static const uint64_t   NO_PAGE = UINT64_MAX;
+
+    // the fewest frames a pool is given, whatever the budget
+    static const size_t     MIN_FRAMES = 16;
+
+    // the most pages the writer copies out in one pass over the frames
+    static const size_t     WRITE_BATCH = 32;
+
+    // member functions
+    size_t      FindFrame();
+    void        MarkDirty(CFrame  &frame);
+    void        RunWriter();
+    void        WaitForWriter(unique_lock<mutex>  &lock);
+    bool        WritePage(uint64_t  pageNo, const char  *data);
+
+    // data members
+    int                             m_fd;
+    size_t                          m_pageSize;
+    size_t                          m_maxFrames;
+    uint64_t                        m_numPages;
+    vector<CFrame>                  m_frames;
+    unordered_map<uint64_t, size_t> m_pageTable;
+    size_t                          m_clockHand;
+    size_t                          m_numDirty;
+    size_t                          m_numHits;
+    size_t                          m_numMisses;
+    bool                            m_bFailed;
+    mutex                           m_mutex;
+    condition_variable              m_writerCond;
+    condition_variable              m_idleCond;
+    thread                          m_writer;
+    bool                            m_bWakeWriter;
+    bool                            m_bWriterBusy;
+    bool                            m_bStopping;
+};
+
+// class declaration
+class   CPageHandle
+{
+public:
+    // constructor and destructor
+    CPageHandle(CBufferPool  *poolPtr, uint64_t  pageNo) : m_pool(poolPtr)
+                                        , m_pageNo(pageNo)
+                                        , m_data(poolPtr->FetchPage(pageNo))
+                                        , m_bDirty(false) {}
+    ~CPageHandle() { m_pool->UnpinPage(m_pageNo, m_bDirty); }
+
+    // member functions
+    char*       GetData() const { return m_data; }
+    uint64_t    GetPageNo() const { return m_pageNo; }
+    void        SetDirty() { m_bDirty = true; }
+
+    // a handle holds one pin, so it cannot be copied
+    CPageHandle(const CPageHandle  &other) = delete;
+    CPageHandle&    operator=(const CPageHandle  &rhs) = delete;
+
+protected:
+    // data members
+    CBufferPool     *m_pool;
+    uint64_t        m_pageNo;
+    char            *m_data;
+    bool            m_bDirty;
+};
+
+#include    "cbufferpool.cpp"
+#endif  // CBUFFER_POOL_HEADER
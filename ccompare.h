@@ -0,0 +1,126 @@
+// ============================================================================
+// File: ccompare.h
+// ============================================================================
+// This file contains the definition of the CThreeWayCompare function object,
+// the default comparator for CBSTree.  Instead of answering "is lhs less than
+// rhs?" it returns a negative, zero or positive int, so a tree search needs
+// only one comparison per level to decide whether to go left, go right or
+// stop.  When the compiler supports operator<=> the result comes from a single
+// call to it; otherwise operator< is called in both directions.
+//
+// CThreeWayCompare<> (that is, CThreeWayCompare<void>) is transparent: it
+// accepts any pair of comparable types, which lets a tree of std::string be
+// searched with a string_view or a C string without building a temporary.
+//
+// A CCompareHolder keeps the comparator inside a tree.  An empty comparator,
+// such as CThreeWayCompare, is held as a base class rather than as a member,
+// so that it takes no space in the tree.
+// ============================================================================
+
+#ifndef CTHREE_WAY_COMPARE_HEADER
+#define CTHREE_WAY_COMPARE_HEADER
+
+// <compare> defines __cpp_lib_three_way_comparison, so it is included before
+// the test rather than on the strength of it
+#if __cplusplus >= 202002L
+#include    <compare>
+#endif
+
+#if defined(__cpp_impl_three_way_comparison) \
+                                && defined(__cpp_lib_three_way_comparison)
+#define     CCOMPARE_HAS_SPACESHIP
+#endif
+
+#include    <type_traits>
+
+// ==== ThreeWayCompare =======================================================
+//
+// This function compares two values and returns the result as an int.
+//
+// Input:
+//      lhs [IN]    -- a const reference to the left-hand value
+//
+//      rhs [IN]    -- a const reference to the right-hand value
+//
+// Output:
+//      A negative value if lhs orders before rhs, a positive value if it
+//      orders after rhs, and zero if the two are equivalent.
+//
+// ============================================================================
+
+template    <typename  LhsType, typename  RhsType>
+inline  int     ThreeWayCompare(const LhsType  &lhs, const RhsType  &rhs)
+{
+#ifdef  CCOMPARE_HAS_SPACESHIP
+    if constexpr (std::three_way_comparable_with<LhsType, RhsType>)
+    {
+        auto result = (lhs <=> rhs);
+        return (result < 0) ? -1 : ((result > 0) ? 1 : 0);
+    }
+    else
+#endif  // CCOMPARE_HAS_SPACESHIP
+    {
+        return (lhs < rhs) ? -1 : ((rhs < lhs) ? 1 : 0);
+    }
+
+}  // end of "ThreeWayCompare"
+
+
+
+// the comparator for a single value type
+template    <typename  ValueType = void>
+struct  CThreeWayCompare
+{
+    int operator()(const ValueType  &lhs, const ValueType  &rhs) const
+    {
+        return ThreeWayCompare(lhs, rhs);
+    }
+};
+
+// the transparent comparator for heterogeneous lookup
+template    <>
+struct  CThreeWayCompare<void>
+{
+    typedef void    is_transparent;
+
+    template    <typename  LhsType, typename  RhsType>
+    int operator()(const LhsType  &lhs, const RhsType  &rhs) const
+    {
+        return ThreeWayCompare(lhs, rhs);
+    }
+};
+
+// class declaration
+template    <typename  Compare, bool  bEmpty = std::is_empty<Compare>::value
+                                        && !std::is_final<Compare>::value>
+class   CCompareHolder
+{
+protected:
+    // constructors
+    CCompareHolder() : m_compare() {}
+    explicit CCompareHolder(const Compare  &comp) : m_compare(comp) {}
+
+    // member functions
+    Compare&        GetCompare() { return m_compare; }
+    const Compare&  GetCompare() const { return m_compare; }
+
+private:
+    // data members
+    Compare         m_compare;
+};
+
+// class declaration
+template    <typename  Compare>
+class   CCompareHolder<Compare, true> : private Compare
+{
+protected:
+    // constructors
+    CCompareHolder() {}
+    explicit CCompareHolder(const Compare  &comp) : Compare(comp) {}
+
+    // member functions
+    Compare&        GetCompare() { return *this; }
+    const Compare&  GetCompare() const { return *this; }
+};
+
+#endif  // CTHREE_WAY_COMPARE_HEADER
@@ -0,0 +1,883 @@
+// ============================================================================
+// File: cdurablebstree.cpp
+// ============================================================================
+// This file contains the implementation of the CDurableBSTree class. It uses
+// the template parameter "NodeType" for the type of values that are stored in
+// the tree, and the template parameter "Compare" for the function object that
+// orders them.  The log is kept in the file "<path>.log" and the checkpoint in
+// "<path>.ckpt".
+// ============================================================================
+
+#include    <cerrno>
+#include    <cstdio>
+#include    <cstring>
+#include    <fcntl.h>
+#include    <unistd.h>
+using namespace std;
+#include    "cdurablebstree.h"
+
+// the tag at the start of a checkpoint file
+static  const   char    CHECKPOINT_MAGIC[8] = { 'C', 'B', 'S', 'T'
+                                                , 'C', 'K', 'P', '1' };
+
+
+// ==== CDurableBSTree::CDurableBSTree ========================================
+//
+// These are the default constructor and the constructor that takes a Compare
+// object.  The tree starts out empty and is not durable until Open is called.
+//
+// Access: public
+//
+// Input:
+//      comp [IN]   -- the Compare object that orders the values (second
+//                     constructor only)
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+CDurableBSTree<NodeType, Compare>::CDurableBSTree() : m_logFd(-1)
+                                        , m_logLength(0)
+                                        , m_numBuffered(0)
+                                        , m_groupSize(1)
+                                        , m_checkpointInterval(0)
+                                        , m_numSinceCheckpoint(0)
+                                        , m_bAutoCheckpoint(true)
+                                        , m_bLogFailed(false)
+{
+}  // end of "CDurableBSTree<NodeType>::CDurableBSTree"
+
+template    <typename  NodeType, typename  Compare>
+CDurableBSTree<NodeType, Compare>::CDurableBSTree(const Compare  &comp)
+                                        : BaseTree(comp)
+                                        , m_logFd(-1)
+                                        , m_logLength(0)
+                                        , m_numBuffered(0)
+                                        , m_groupSize(1)
+                                        , m_checkpointInterval(0)
+                                        , m_numSinceCheckpoint(0)
+                                        , m_bAutoCheckpoint(true)
+                                        , m_bLogFailed(false)
+{
+}  // end of "CDurableBSTree<NodeType>::CDurableBSTree"
+
+
+
+// ==== CDurableBSTree::AppendRecord ==========================================
+//
+// This function adds a record to the in-memory log buffer.  A full group is
+// written out by CDurableBSTree::FlushLog, and once the log has grown past
+// both the checkpoint interval and the size of the tree, a checkpoint is
+// taken, unless automatic checkpoints are off.  Tying checkpoints to the size
+// of the tree keeps their O(n) cost down to O(1) amortized per update, but
+// the update that triggers one waits for all of it.
+//
+// Access: protected
+//
+// Input:
+//      kind [IN]       -- RECORD_INSERT, RECORD_DELETE, RECORD_DELETE_RANGE
+//                         or RECORD_DESTROY
+//
+//      value [IN]      -- the value that was inserted or deleted, or the
+//                         lower end of the range that was deleted (for a
+//                         RECORD_DESTROY record, any value)
+//
+//      hiPtr [IN]      -- a pointer to the upper end of the range for a
+//                         RECORD_DELETE_RANGE record, NULL otherwise
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CDurableBSTree<NodeType, Compare>::AppendRecord(char  kind
+                                                , const NodeType  &value
+                                                , const NodeType  *hiPtr)
+{
+    size_t      start = m_logBuffer.size();
+    size_t      length = 1 + sizeof(NodeType);
+    uint32_t    checksum;
+
+    if(hiPtr != NULL)
+    {
+        length += sizeof(NodeType);
+    }
+    m_logBuffer.resize(start + length + sizeof(checksum));
+    m_logBuffer[start] = kind;
+    memcpy(&m_logBuffer[start + 1], &value, sizeof(NodeType));
+    if(hiPtr != NULL)
+    {
+        memcpy(&m_logBuffer[start + 1 + sizeof(NodeType)], hiPtr
+                                                    , sizeof(NodeType));
+    }
+    checksum = Checksum(&m_logBuffer[start], length);
+    memcpy(&m_logBuffer[start + length], &checksum, sizeof(checksum));
+
+    ++m_numSinceCheckpoint;
+    if(++m_numBuffered >= m_groupSize)
+    {
+        FlushLog();
+    }
+
+    if(m_bAutoCheckpoint && m_numSinceCheckpoint >= m_checkpointInterval
+                        && m_numSinceCheckpoint > BaseTree::GetNumItems())
+    {
+        Checkpoint();
+    }
+
+}  // end of "CDurableBSTree<NodeType>::AppendRecord"
+
+
+
+// ==== CDurableBSTree::Checkpoint ============================================
+//
+// This function writes the sorted contents of the tree to a new checkpoint
+// file and then empties the log.  The snapshot goes to a temporary file that
+// is synced and then renamed over the old checkpoint, so a crash at any point
+// leaves either the old or the new checkpoint intact.  The file holds a tag,
+// the number of values, the values themselves and a checksum of the values.
+// The whole snapshot is taken and written on the calling thread, in time
+// proportional to the size of the tree.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if the checkpoint was written and no earlier write has
+//      failed, false otherwise (or if the tree is not open).
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::Checkpoint()
+{
+    if(m_logFd < 0 || !FlushLog())
+    {
+        return false;
+    }
+
+    uint64_t            count = BaseTree::GetNumItems();
+    vector<NodeType>    values(count);
+    vector<char>        image;
+    uint32_t            checksum;
+
+    BaseTree::SaveToArray(values.data());
+
+    image.resize(sizeof(CHECKPOINT_MAGIC) + sizeof(count)
+                    + count * sizeof(NodeType) + sizeof(checksum));
+    memcpy(&image[0], CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    memcpy(&image[sizeof(CHECKPOINT_MAGIC)], &count, sizeof(count));
+    if(count > 0)
+    {
+        memcpy(&image[sizeof(CHECKPOINT_MAGIC) + sizeof(count)]
+                                , values.data(), count * sizeof(NodeType));
+    }
+    checksum = Checksum(&image[sizeof(CHECKPOINT_MAGIC) + sizeof(count)]
+                                , count * sizeof(NodeType));
+    memcpy(&image[image.size() - sizeof(checksum)], &checksum
+                                                    , sizeof(checksum));
+
+    string  checkpointName = m_path + ".ckpt";
+    string  tempName = checkpointName + ".tmp";
+    int     fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        m_bLogFailed = true;
+        return false;
+    }
+
+    bool bWritten = WriteAll(fd, image.data(), image.size(), 0)
+                                                        && fsync(fd) == 0;
+    bWritten = (close(fd) == 0) && bWritten;
+    if(!bWritten || rename(tempName.c_str(), checkpointName.c_str()) != 0)
+    {
+        m_bLogFailed = true;
+        return false;
+    }
+
+    // make the rename itself durable before the log is thrown away
+    size_t  slash = m_path.rfind('/');
+    string  dirName = (slash == string::npos) ? string(".")
+                        : m_path.substr(0, (slash == 0) ? 1 : slash);
+    int     dirFd = open(dirName.c_str(), O_RDONLY);
+    if(dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+
+    if(ftruncate(m_logFd, 0) != 0 || fsync(m_logFd) != 0)
+    {
+        m_bLogFailed = true;
+        return false;
+    }
+
+    m_logLength = 0;
+    m_numSinceCheckpoint = 0;
+    return !m_bLogFailed;
+
+}  // end of "CDurableBSTree<NodeType>::Checkpoint"
+
+
+
+// ==== CDurableBSTree::Checksum ==============================================
+//
+// This function computes the 32-bit FNV-1a hash of a block of bytes, which is
+// used to recognize torn or corrupt records.
+//
+// Access: protected
+//
+// Input:
+//      bytes [IN]      -- the start of the block
+//
+//      length [IN]     -- the number of bytes in the block
+//
+// Output:
+//      The checksum of the block.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+uint32_t    CDurableBSTree<NodeType, Compare>::Checksum(const char  *bytes
+                                                        , size_t  length)
+{
+    uint32_t    hash = 2166136261u;
+
+    for(size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+
+}  // end of "CDurableBSTree<NodeType>::Checksum"
+
+
+
+// ==== CDurableBSTree::Close =================================================
+//
+// This function writes out any buffered log records and closes the log.  The
+// tree keeps its contents but is no longer durable.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CDurableBSTree<NodeType, Compare>::Close()
+{
+    if(m_logFd >= 0)
+    {
+        FlushLog();
+        close(m_logFd);
+        m_logFd = -1;
+    }
+
+}  // end of "CDurableBSTree<NodeType>::Close"
+
+
+
+// ==== CDurableBSTree::DeleteItem ============================================
+//
+// This function deletes a target item from the tree and logs the deletion if
+// it succeeded.
+//
+// Access: public
+//
+// Input:
+//      target [IN]      -- a const reference to a NodeType object
+//
+// Output:
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::DeleteItem(const NodeType  &target)
+{
+    bool    bItemDeleted = BaseTree::DeleteItem(target);
+
+    if(bItemDeleted && m_logFd >= 0)
+    {
+        AppendRecord(RECORD_DELETE, target);
+    }
+    return bItemDeleted;
+
+}  // end of "CDurableBSTree<NodeType>::DeleteItem"
+
+
+
+// ==== CDurableBSTree::DeleteRange ===========================================
+//
+// This function deletes every item from lo to hi (inclusive) from the tree
+// and, if any were deleted, logs the range with a single record, so the cost
+// of logging does not grow with the number of items removed.  Replaying the
+// record deletes the same range again.
+//
+// Access: public
+//
+// Input:
+//      lo [IN]         -- the smallest item to delete
+//
+//      hi [IN]         -- the largest item to delete
+//
+// Output:
+//      The number of items deleted.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+size_t  CDurableBSTree<NodeType, Compare>::DeleteRange(const NodeType  &lo
+                                                    , const NodeType  &hi)
+{
+    size_t  numDeleted = BaseTree::DeleteRange(lo, hi);
+
+    if(numDeleted > 0 && m_logFd >= 0)
+    {
+        AppendRecord(RECORD_DELETE_RANGE, lo, &hi);
+    }
+    return numDeleted;
+
+}  // end of "CDurableBSTree<NodeType>::DeleteRange"
+
+
+
+// ==== CDurableBSTree::DestroyTree ===========================================
+//
+// This function releases every node in the tree.  Rather than logging one
+// deletion per item, it logs a single destroy record and then records the
+// now empty tree with a checkpoint, which empties the log.  The records
+// still buffered are left for the checkpoint to flush ahead of the destroy
+// record, so if the checkpoint fails the log still ends with the destroy,
+// and the records that follow it describe the tree as it is in memory.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CDurableBSTree<NodeType, Compare>::DestroyTree()
+{
+    BaseTree::DestroyTree();
+    if(m_logFd >= 0)
+    {
+        AppendRecord(RECORD_DESTROY, NodeType());
+
+        // appending the record may have taken the checkpoint already
+        if(m_numSinceCheckpoint > 0)
+        {
+            Checkpoint();
+        }
+    }
+
+}  // end of "CDurableBSTree<NodeType>::DestroyTree"
+
+
+
+// ==== CDurableBSTree::ExtractRange ==========================================
+//
+// This function moves every item from lo to hi (inclusive) into another tree
+// (see CBSTree::ExtractRange) and, if any were moved, logs their removal
+// from this tree as a deleted range.  The other tree is not made durable.
+//
+// Access: public
+//
+// Input:
+//      lo [IN]         -- the smallest item to move
+//
+//      hi [IN]         -- the largest item to move
+//
+//      dest [OUT]      -- the tree that receives the items
+//
+// Output:
+//      The number of items moved.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+size_t  CDurableBSTree<NodeType, Compare>::ExtractRange(const NodeType  &lo
+                                        , const NodeType  &hi
+                                        , CBSTree<NodeType, Compare>  &dest)
+{
+    size_t  numMoved = BaseTree::ExtractRange(lo, hi, dest);
+
+    if(numMoved > 0 && m_logFd >= 0)
+    {
+        AppendRecord(RECORD_DELETE_RANGE, lo, &hi);
+    }
+    return numMoved;
+
+}  // end of "CDurableBSTree<NodeType>::ExtractRange"
+
+
+
+// ==== CDurableBSTree::FlushLog ==============================================
+//
+// This function writes the buffered log records to the log with one write()
+// and makes them durable with one fsync().  The records are written at the
+// end of the last group known to be on disk, not appended to whatever the
+// file holds.  If the write or the sync fails, the file is cut back to that
+// point and the records stay buffered, so the next flush writes them again
+// over any torn bytes; otherwise the torn bytes would fail their checksum
+// on recovery and every record after them would be lost.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if the records (if any) reached the disk, false if
+//      the write or the sync failed.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::FlushLog()
+{
+    if(m_logBuffer.empty())
+    {
+        return true;
+    }
+
+    if(!WriteAll(m_logFd, m_logBuffer.data(), m_logBuffer.size()
+                                                            , m_logLength)
+                                                    || fsync(m_logFd) != 0)
+    {
+        m_bLogFailed = true;
+        if(ftruncate(m_logFd, m_logLength) != 0)
+        {
+            // the next flush still writes over the torn bytes, since it
+            // starts at the same offset
+        }
+        return false;
+    }
+
+    m_logLength += static_cast<off_t>(m_logBuffer.size());
+    m_logBuffer.clear();
+    m_numBuffered = 0;
+    return true;
+
+}  // end of "CDurableBSTree<NodeType>::FlushLog"
+
+
+
+// ==== CDurableBSTree::InsertItem ============================================
+//
+// This function inserts a new item into the tree and logs the insertion if
+// it succeeded.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree,
+//      false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::InsertItem(const NodeType  &newItem)
+{
+    bool    bInserted = BaseTree::InsertItem(newItem);
+
+    if(bInserted && m_logFd >= 0)
+    {
+        AppendRecord(RECORD_INSERT, newItem);
+    }
+    return bInserted;
+
+}  // end of "CDurableBSTree<NodeType>::InsertItem"
+
+
+
+// ==== CDurableBSTree::Open ==================================================
+//
+// This function recovers the tree from the files at the given path and then
+// keeps logging to them.  Whatever the tree held before is replaced.  If the
+// files do not exist yet the tree starts out empty.
+//
+// Access: public
+//
+// Input:
+//      path [IN]               -- the path the file names are based on
+//
+//      groupSize [IN]          -- the number of log records written (and
+//                                 synced) together
+//
+//      checkpointInterval [IN] -- the fewest log records between checkpoints
+//
+// Output:
+//      A value of true if the tree was recovered and the log is open, false
+//      if a file could not be read or written or the checkpoint is corrupt.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::Open(const string  &path
+                                                , size_t  groupSize
+                                                , size_t  checkpointInterval)
+{
+    Close();
+    m_path = path;
+    m_groupSize = (groupSize < 1) ? 1 : groupSize;
+    m_checkpointInterval = checkpointInterval;
+    m_numSinceCheckpoint = 0;
+    m_bLogFailed = false;
+
+    if(!ReadCheckpoint() || !ReplayLog())
+    {
+        return false;
+    }
+
+    return (m_logFd >= 0);
+
+}  // end of "CDurableBSTree<NodeType>::Open"
+
+
+
+// ==== CDurableBSTree::PopMax ================================================
+//
+// This function removes the largest item from the tree and logs its removal
+// as a deletion.
+//
+// Access: public
+//
+// Input:
+//      item [OUT]      -- a reference to the NodeType object that receives the
+//                         largest item
+//
+// Output:
+//      A value of false if the tree is empty, otherwise a value of true is
+//      returned and the item is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::PopMax(NodeType  &item)
+{
+    bool    bPopped = BaseTree::PopMax(item);
+
+    if(bPopped && m_logFd >= 0)
+    {
+        AppendRecord(RECORD_DELETE, item);
+    }
+    return bPopped;
+
+}  // end of "CDurableBSTree<NodeType>::PopMax"
+
+
+
+// ==== CDurableBSTree::PopMin ================================================
+//
+// This function removes the smallest item from the tree and logs its removal
+// as a deletion.
+//
+// Access: public
+//
+// Input:
+//      item [OUT]      -- a reference to the NodeType object that receives the
+//                         smallest item
+//
+// Output:
+//      A value of false if the tree is empty, otherwise a value of true is
+//      returned and the item is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::PopMin(NodeType  &item)
+{
+    bool    bPopped = BaseTree::PopMin(item);
+
+    if(bPopped && m_logFd >= 0)
+    {
+        AppendRecord(RECORD_DELETE, item);
+    }
+    return bPopped;
+
+}  // end of "CDurableBSTree<NodeType>::PopMin"
+
+
+
+// ==== CDurableBSTree::ReadCheckpoint ========================================
+//
+// This function loads the checkpoint file, if there is one, and bulk-builds
+// the tree from it with CBSTree::BuildFromSorted.  With no checkpoint the tree
+// is emptied.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if the tree was loaded (or there was no checkpoint),
+//      false if the file could not be read or fails its checks.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::ReadCheckpoint()
+{
+    string          checkpointName = m_path + ".ckpt";
+    vector<char>    image;
+    char            buffer[65536];
+    ssize_t         numRead;
+    uint64_t        count;
+    uint32_t        checksum;
+    size_t          header = sizeof(CHECKPOINT_MAGIC) + sizeof(count);
+
+    int fd = open(checkpointName.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        BaseTree::DestroyTree();
+        return (errno == ENOENT);
+    }
+
+    while((numRead = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        image.insert(image.end(), buffer, buffer + numRead);
+    }
+    close(fd);
+
+    if(numRead < 0 || image.size() < header + sizeof(checksum)
+            || memcmp(&image[0], CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)))
+    {
+        return false;
+    }
+
+    memcpy(&count, &image[sizeof(CHECKPOINT_MAGIC)], sizeof(count));
+    if((image.size() - header - sizeof(checksum)) / sizeof(NodeType) != count
+            || image.size() != header + count * sizeof(NodeType)
+                                                    + sizeof(checksum))
+    {
+        return false;
+    }
+
+    memcpy(&checksum, &image[image.size() - sizeof(checksum)]
+                                                    , sizeof(checksum));
+    if(checksum != Checksum(&image[header], count * sizeof(NodeType)))
+    {
+        return false;
+    }
+
+    vector<NodeType>    values(count);
+    if(count > 0)
+    {
+        memcpy(values.data(), &image[header], count * sizeof(NodeType));
+    }
+    BaseTree::BuildFromSorted(values.data(), values.size());
+    return true;
+
+}  // end of "CDurableBSTree<NodeType>::ReadCheckpoint"
+
+
+
+// ==== CDurableBSTree::ReplayLog =============================================
+//
+// This function applies the log records written since the last checkpoint,
+// stopping at the first record that is incomplete or fails its checksum (the
+// tail a crash can leave behind).  The log is then opened for writing and
+// cut back to the last good record, so new records follow straight on.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if the log was replayed and opened, false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::ReplayLog()
+{
+    string          logName = m_path + ".log";
+    vector<char>    records;
+    char            buffer[65536];
+    ssize_t         numRead = 0;
+    size_t          goodLength = 0;
+    NodeType        value;
+    NodeType        hiValue;
+    uint32_t        checksum;
+
+    int fd = open(logName.c_str(), O_RDONLY);
+    if(fd >= 0)
+    {
+        while((numRead = read(fd, buffer, sizeof(buffer))) > 0)
+        {
+            records.insert(records.end(), buffer, buffer + numRead);
+        }
+        close(fd);
+    }
+    else if(errno != ENOENT)
+    {
+        return false;
+    }
+
+    if(numRead < 0)
+    {
+        return false;
+    }
+
+    while(goodLength < records.size())
+    {
+        const char  *record = &records[goodLength];
+        size_t      recordSize = (RECORD_DELETE_RANGE == record[0])
+                                            ? RANGE_RECORD_SIZE : RECORD_SIZE;
+        size_t      length = recordSize - sizeof(checksum);
+
+        if(goodLength + recordSize > records.size())
+        {
+            break;
+        }
+        memcpy(&checksum, record + length, sizeof(checksum));
+        if(checksum != Checksum(record, length))
+        {
+            break;
+        }
+
+        memcpy(&value, record + 1, sizeof(NodeType));
+        if(RECORD_INSERT == record[0])
+        {
+            BaseTree::InsertItem(value);
+        }
+        else if(RECORD_DELETE == record[0])
+        {
+            BaseTree::DeleteItem(value);
+        }
+        else if(RECORD_DELETE_RANGE == record[0])
+        {
+            memcpy(&hiValue, record + 1 + sizeof(NodeType), sizeof(NodeType));
+            BaseTree::DeleteRange(value, hiValue);
+        }
+        else if(RECORD_DESTROY == record[0])
+        {
+            BaseTree::DestroyTree();
+        }
+        else
+        {
+            break;
+        }
+
+        goodLength += recordSize;
+        ++m_numSinceCheckpoint;
+    }
+
+    m_logFd = open(logName.c_str(), O_WRONLY | O_CREAT, 0644);
+    if(m_logFd < 0)
+    {
+        return false;
+    }
+
+    if(ftruncate(m_logFd, static_cast<off_t>(goodLength)) != 0
+                                                    || fsync(m_logFd) != 0)
+    {
+        close(m_logFd);
+        m_logFd = -1;
+        return false;
+    }
+
+    m_logLength = static_cast<off_t>(goodLength);
+    return true;
+
+}  // end of "CDurableBSTree<NodeType>::ReplayLog"
+
+
+
+// ==== CDurableBSTree::Sync ==================================================
+//
+// This function writes out any buffered log records, so every update made so
+// far will survive a crash.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if every update so far is on disk, false if the tree
+//      is not open or some write (this one or an earlier one) failed.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::Sync()
+{
+    if(m_logFd < 0)
+    {
+        return false;
+    }
+
+    return FlushLog() && !m_bLogFailed;
+
+}  // end of "CDurableBSTree<NodeType>::Sync"
+
+
+
+// ==== CDurableBSTree::WriteAll ==============================================
+//
+// This function writes a block of bytes to a file at a given offset,
+// retrying after short writes and interrupted calls.
+//
+// Access: protected
+//
+// Input:
+//      fd [IN]         -- the file descriptor to write to
+//
+//      bytes [IN]      -- the start of the block
+//
+//      length [IN]     -- the number of bytes in the block
+//
+//      offset [IN]     -- the position in the file to write the block at
+//
+// Output:
+//      A value of true if every byte was written, false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CDurableBSTree<NodeType, Compare>::WriteAll(int  fd, const char  *bytes
+                                                    , size_t  length
+                                                    , off_t  offset)
+{
+    while(length > 0)
+    {
+        ssize_t numWritten = pwrite(fd, bytes, length, offset);
+        if(numWritten < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+
+        bytes += numWritten;
+        offset += numWritten;
+        length -= static_cast<size_t>(numWritten);
+    }
+
+    return true;
+
+}  // end of "CDurableBSTree<NodeType>::WriteAll"
@@ -0,0 +1,131 @@
+// ============================================================================
+// File: cdurablebstree.h
+// ============================================================================
+// This header file contains the declaration of the CDurableBSTree class, a
+// CBSTree that keeps an on-disk copy of its contents so that it can be
+// recovered after the process is lost.  It uses the template parameters
+// "NodeType" and "Compare" exactly as CBSTree does; NodeType must be
+// trivially copyable, since values are written to disk byte for byte.
+//
+// Every successful InsertItem and DeleteItem appends a record to a write-ahead
+// log, and DeleteRange and ExtractRange append one record holding both ends
+// of the range they removed; DestroyTree appends one that empties the tree.
+// Records are gathered in memory and written
+// with a single write() and fsync() once a group of them has built up (a
+// "group commit"), so the cost of the disk flush is shared by the whole
+// group.  Sync forces out a partial group.  Every record ends with a
+// checksum, so a record torn by a crash is recognized and dropped.
+//
+// Once the log holds more records than the tree holds items (and at least the
+// checkpoint interval), the tree is checkpointed: its sorted contents, from
+// CBSTree::SaveToArray, are written to a new snapshot file that atomically
+// replaces the old one, and the log is emptied.  Open recovers the tree by
+// bulk-building it from the snapshot in O(n) with CBSTree::BuildFromSorted,
+// then replaying the log.  Replaying a record that the snapshot already
+// reflects leaves each key as its last record in the log says, so a crash
+// between writing the snapshot and emptying the log is harmless.
+//
+// An automatic checkpoint runs inside the InsertItem or DeleteItem (or other
+// logged update) whose record crosses the threshold, and that call stalls
+// for the whole O(n) snapshot, its write and two fsync() calls, although the
+// average cost per update stays O(1).  Callers that cannot afford such a
+// stall can turn automatic checkpoints off with SetAutoCheckpoint and call
+// Checkpoint themselves at a quiet moment; until they do, the log keeps
+// growing and recovery replays all of it.
+//
+// The logging versions of InsertItem, DeleteItem, DeleteRange, ExtractRange,
+// PopMin, PopMax and DestroyTree hide the CBSTree ones (a pop is logged as a
+// deletion of the item it returned); calls made through a pointer or
+// reference to the base class are not logged.  A failed write is
+// remembered, and reported by the next Sync or Checkpoint; the records it
+// held stay buffered and the next flush writes them again over the torn
+// bytes, so the records that follow are not lost behind them.  The log and
+// snapshot are written with POSIX calls.
+// ============================================================================
+
+#ifndef CDURABLE_BIN_SEARCH_TREE_HEADER
+#define CDURABLE_BIN_SEARCH_TREE_HEADER
+
+#include    <cstdint>
+#include    <string>
+#include    <sys/types.h>
+#include    <type_traits>
+#include    <vector>
+using namespace std;
+#include    "cbstree.h"
+
+// class declaration
+template    <typename  NodeType, typename  Compare = CThreeWayCompare<NodeType> >
+class   CDurableBSTree : public CBSTree<NodeType, Compare>
+{
+    static_assert(is_trivially_copyable<NodeType>::value
+                    , "CDurableBSTree values must be trivially copyable");
+
+public:
+    // constructors and destructor
+    CDurableBSTree();
+    explicit CDurableBSTree(const Compare  &comp);
+    virtual ~CDurableBSTree() { Close(); }
+
+    // member functions
+    bool    Checkpoint();
+    void    Close();
+    bool    DeleteItem(const NodeType  &target);
+    size_t  DeleteRange(const NodeType  &lo, const NodeType  &hi);
+    void    DestroyTree();
+    size_t  ExtractRange(const NodeType  &lo, const NodeType  &hi
+                                        , CBSTree<NodeType, Compare>  &dest);
+    bool    GetAutoCheckpoint() const { return m_bAutoCheckpoint; }
+    bool    InsertItem(const NodeType  &newItem);
+    bool    IsOpen() const { return (m_logFd >= 0); }
+    bool    Open(const string  &path, size_t  groupSize = 64
+                                        , size_t  checkpointInterval = 4096);
+    bool    PopMax(NodeType  &item);
+    bool    PopMin(NodeType  &item);
+    void    SetAutoCheckpoint(bool  bAuto) { m_bAutoCheckpoint = bAuto; }
+    bool    Sync();
+
+    // the tree owns an open file, so it cannot be copied
+    CDurableBSTree(const CDurableBSTree  &other) = delete;
+    CDurableBSTree&  operator=(const CDurableBSTree  &rhs) = delete;
+
+protected:
+    typedef CBSTree<NodeType, Compare>  BaseTree;
+
+    // the kinds of log record
+    enum    { RECORD_INSERT = 'I', RECORD_DELETE = 'D'
+                , RECORD_DELETE_RANGE = 'R', RECORD_DESTROY = 'X' };
+
+    // the size of one log record: the kind, the value and a checksum; a
+    // range record holds two values, the ends of the range, and the value
+    // of a destroy record is unused
+    static const size_t     RECORD_SIZE = 1 + sizeof(NodeType)
+                                                    + sizeof(uint32_t);
+    static const size_t     RANGE_RECORD_SIZE = RECORD_SIZE
+                                                    + sizeof(NodeType);
+
+    // member functions
+    void                    AppendRecord(char  kind, const NodeType  &value
+                                        , const NodeType  *hiPtr = NULL);
+    static uint32_t         Checksum(const char  *bytes, size_t  length);
+    bool                    FlushLog();
+    bool                    ReadCheckpoint();
+    bool                    ReplayLog();
+    static bool             WriteAll(int  fd, const char  *bytes
+                                        , size_t  length, off_t  offset);
+
+    // data members
+    string          m_path;
+    int             m_logFd;
+    off_t           m_logLength;
+    vector<char>    m_logBuffer;
+    size_t          m_numBuffered;
+    size_t          m_groupSize;
+    size_t          m_checkpointInterval;
+    size_t          m_numSinceCheckpoint;
+    bool            m_bAutoCheckpoint;
+    bool            m_bLogFailed;
+};
+
+#include    "cdurablebstree.cpp"
+#endif  // CDURABLE_BIN_SEARCH_TREE_HEADER
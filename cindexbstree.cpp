@@ -0,0 +1,898 @@
+// ============================================================================
+// File: cindexbstree.cpp
+// ============================================================================
+// This file contains the implementation of the CIndexBSTree class. It uses the
+// template parameter "NodeType" for the type of values that are stored in the
+// tree.
+// ============================================================================
+
+#include    <iostream>
+#include    <cstdlib>
+#include    <utility>
+using namespace std;
+#include    "cindexbstree.h"
+
+
+// ==== CIndexBSTree::AllocSlot ===============================================
+//
+// This function takes a slot for a new node, reusing the head of the free list
+// if there is one and appending to the arrays otherwise.  The new node has no
+// children.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference to the value for the new node
+//
+// Output:
+//      The index of the new node.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint32_t    CIndexBSTree<NodeType>::AllocSlot(const NodeType  &newItem)
+{
+    uint32_t    index;
+
+    if(m_freeList != INDEX_NULL)
+    {
+        index = m_freeList;
+        m_freeList = m_links[index].m_left;
+        m_values[index] = newItem;
+        m_links[index] = CIndexLinks();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_values.size());
+        m_values.push_back(newItem);
+        m_links.push_back(CIndexLinks());
+    }
+
+    ++m_numNodes;
+    return index;
+
+}  // end of "CIndexBSTree<NodeType>::AllocSlot"
+
+
+
+// ==== CIndexBSTree::BuildBalanced ===========================================
+//
+// This function links the slots first..last, whose values are already in
+// sorted ascending order, into a balanced subtree.  The middle slot of each
+// range becomes the root of its subtree and the two halves are linked below
+// it.  The ranges still to be linked are kept on an explicit stack, each with
+// the address of the link that is to hold its root; the link array is not
+// resized here, so those addresses stay valid.
+//
+// Access: protected
+//
+// Input:
+//      first [IN]      -- the index of the first slot
+//
+//      last [IN]       -- the index of the last slot
+//
+// Output:
+//      The index of the root of the new subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint32_t    CIndexBSTree<NodeType>::BuildBalanced(uint32_t  first
+                                                        , uint32_t  last)
+{
+    vector<pair<uint32_t*, pair<uint32_t, uint32_t> > > pending;
+    uint32_t                                            root = INDEX_NULL;
+
+    pending.push_back(make_pair(&root, make_pair(first, last)));
+    while(!pending.empty())
+    {
+        uint32_t    *link = pending.back().first;
+        first = pending.back().second.first;
+        last = pending.back().second.second;
+        pending.pop_back();
+
+        uint32_t    mid = first + (last - first) / 2;
+        *link = mid;
+        m_links[mid].m_left = INDEX_NULL;
+        m_links[mid].m_right = INDEX_NULL;
+        if(mid > first)
+        {
+            pending.push_back(make_pair(&m_links[mid].m_left
+                                        , make_pair(first, mid - 1)));
+        }
+        if(mid < last)
+        {
+            pending.push_back(make_pair(&m_links[mid].m_right
+                                        , make_pair(mid + 1, last)));
+        }
+    }
+
+    return root;
+
+}  // end of "CIndexBSTree<NodeType>::BuildBalanced"
+
+
+
+// ==== CIndexBSTree::CountNodes ==============================================
+//
+// This function derives the height and number of nodes of the subtree rooted
+// at the index parameter.  The height is the length of the longest path from
+// the subtree root to a leaf (counting the edges, not the nodes).  The nodes
+// are visited with an explicit stack that holds each pending node with its
+// depth, so the tree may be as deep as it likes.
+//
+// Access: protected
+//
+// Input:
+//      index [IN]          -- the index of a node; initially this is the root
+//
+//      numNodes [OUT]      -- a reference to a size_t that is set to the
+//                             number of nodes in the subtree
+//
+// Output:
+//      The height of the subtree, or zero if the subtree is empty.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+size_t  CIndexBSTree<NodeType>::CountNodes(uint32_t  index
+                                            , size_t  &numNodes) const
+{
+    vector<pair<uint32_t, size_t> > pending;
+    size_t                          height = 0;
+
+    numNodes = 0;
+    if(index != INDEX_NULL)
+    {
+        pending.push_back(make_pair(index, 0));
+    }
+    while(!pending.empty())
+    {
+        size_t  depth = pending.back().second;
+        index = pending.back().first;
+        pending.pop_back();
+        ++numNodes;
+        if(depth > height)
+        {
+            height = depth;
+        }
+        if(m_links[index].m_right != INDEX_NULL)
+        {
+            pending.push_back(make_pair(m_links[index].m_right, depth + 1));
+        }
+        if(m_links[index].m_left != INDEX_NULL)
+        {
+            pending.push_back(make_pair(m_links[index].m_left, depth + 1));
+        }
+    }
+
+    return height;
+
+}  // end of "CIndexBSTree<NodeType>::CountNodes"
+
+
+
+// ==== CIndexBSTree::DeleteItem ==============================================
+//
+// This function allows the caller to delete a target node from the tree.  The
+// node is unlinked by CIndexBSTree::RemoveSlot and its slot is returned to the
+// free list.
+//
+// Access: public
+//
+// Input:
+//      target [IN]      -- a const reference to a NodeType object
+//
+// Output:
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CIndexBSTree<NodeType>::DeleteItem(const NodeType  &target)
+{
+    uint32_t    index = RemoveSlot(target);
+
+    if(index == INDEX_NULL)
+    {
+        return false;
+    }
+
+    FreeSlot(index);
+    return true;
+
+}  // end of "CIndexBSTree<NodeType>::DeleteItem"
+
+
+
+// ==== CIndexBSTree::DestroyTree =============================================
+//
+// This function releases every node in the tree along with the memory held by
+// the node arrays.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::DestroyTree()
+{
+    vector<NodeType>().swap(m_values);
+    vector<CIndexLinks>().swap(m_links);
+    m_root = INDEX_NULL;
+    m_freeList = INDEX_NULL;
+    m_numNodes = 0;
+
+}  // end of "CIndexBSTree<NodeType>::DestroyTree"
+
+
+
+// ==== CIndexBSTree::FreeSlot ================================================
+//
+// This function returns the slot of an unlinked node to the free list.  The
+// slot's value is reset so that any resources it owns are released now rather
+// than when the slot is reused.
+//
+// Access: protected
+//
+// Input:
+//      index [IN]      -- the index of a node that is no longer in the tree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::FreeSlot(uint32_t  index)
+{
+    m_values[index] = NodeType();
+    m_links[index].m_left = m_freeList;
+    m_links[index].m_right = INDEX_NULL;
+    m_freeList = index;
+    --m_numNodes;
+
+}  // end of "CIndexBSTree<NodeType>::FreeSlot"
+
+
+
+// ==== CIndexBSTree::GetTreeInfo =============================================
+//
+// This function allows the caller to get the current number of nodes and the
+// height of the tree by calling the CIndexBSTree::CountNodes member function.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- a reference to a size_t that will contain the total
+//                         number of nodes currently in the tree
+//
+//      height [OUT]    -- a reference to a size_t that will contain the height
+//                         of the tree; this is the number of edges on the
+//                         longest path from the root to a leaf, and is zero
+//                         for a tree of one node or an empty tree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::GetTreeInfo(size_t  &numNodes
+                                                , size_t  &height) const
+{
+    height = CountNodes(m_root, numNodes);
+
+}  // end of "CIndexBSTree<NodeType>::GetTreeInfo"
+
+
+
+// ==== CIndexBSTree::InOrder =================================================
+//
+// This function performs an in-order traversal through the tree, calling the
+// "fPtr" parameter for each node.  The nodes whose left subtrees are still
+// being visited are kept on an explicit stack, so the depth of the tree does
+// not matter.
+//
+// Access: protected
+//
+// Input:
+//      index [IN]      -- the index of a tree node (initially this is the
+//                         root)
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference to a NodeType object as input, and
+//                         returns nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::InOrder(uint32_t  index
+                                    , void (*fPtr)(const NodeType&)) const
+{
+    vector<uint32_t>    pending;
+
+    while(index != INDEX_NULL || !pending.empty())
+    {
+        while(index != INDEX_NULL)
+        {
+            pending.push_back(index);
+            index = m_links[index].m_left;
+        }
+
+        index = pending.back();
+        pending.pop_back();
+        (*fPtr)(m_values[index]);
+        index = m_links[index].m_right;
+    }
+
+}  // end of "CIndexBSTree<NodeType>::InOrder"
+
+
+
+// ==== CIndexBSTree::InOrderTraverse =========================================
+//
+// This function allows the caller to execute an in-order traversal through the
+// tree, and have the "fPtr" parameter called for each node in the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a NodeType object as input, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::InOrderTraverse(
+                                    void  (*fPtr)(const NodeType&)) const
+{
+    InOrder(m_root, fPtr);
+
+}  // end of "CIndexBSTree<NodeType>::InOrderTraverse"
+
+
+
+// ==== CIndexBSTree::InsertItem ==============================================
+//
+// This function allows the caller to insert a new node into the tree.  The
+// input parameter is a const reference to the item to insert.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree,
+//      false if it was already in the tree or the tree is full.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CIndexBSTree<NodeType>::InsertItem(const NodeType  &newItem)
+{
+    bool    bInserted;
+
+    InsertSlot(newItem, bInserted);
+    return bInserted;
+
+}  // end of "CIndexBSTree<NodeType>::InsertItem"
+
+
+
+// ==== CIndexBSTree::InsertSlot ==============================================
+//
+// This function inserts a new node into the tree.  It walks down from the root
+// to the correct location and links a new slot there.  The parent is tracked
+// by index rather than by the address of its link, because taking a new slot
+// may grow (and so move) the link array.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]    -- a const reference to the NodeType object to insert
+//
+//      bInserted [OUT] -- a reference to a bool that is set to true if a new
+//                         node was added, and false if the item was already in
+//                         the tree or every index is in use
+//
+// Output:
+//      The index of the node holding the item, or INDEX_NULL if the tree is
+//      full.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint32_t    CIndexBSTree<NodeType>::InsertSlot(const NodeType  &newItem
+                                                        , bool  &bInserted)
+{
+    uint32_t    parent = INDEX_NULL;
+    uint32_t    index = m_root;
+    bool        bLeft = false;
+
+    while(index != INDEX_NULL)
+    {
+        parent = index;
+        if(newItem < m_values[index])
+        {
+            bLeft = true;
+            index = m_links[index].m_left;
+        }
+        else if(m_values[index] < newItem)
+        {
+            bLeft = false;
+            index = m_links[index].m_right;
+        }
+        else
+        {
+            bInserted = false;
+            return index;
+        }
+    }
+
+    // INDEX_NULL is reserved, so the last usable index is one below it
+    if(m_numNodes == INDEX_NULL)
+    {
+        bInserted = false;
+        return INDEX_NULL;
+    }
+
+    index = AllocSlot(newItem);
+    if(parent == INDEX_NULL)
+    {
+        m_root = index;
+    }
+    else if(bLeft)
+    {
+        m_links[parent].m_left = index;
+    }
+    else
+    {
+        m_links[parent].m_right = index;
+    }
+
+    bInserted = true;
+    return index;
+
+}  // end of "CIndexBSTree<NodeType>::InsertSlot"
+
+
+
+// ==== CIndexBSTree::ItemInTree ==============================================
+//
+// This function allows the caller to determine if a target item is in the
+// tree by calling CIndexBSTree::Retrieve.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object that contains
+//                         the target key value to search for
+//
+// Output:
+//      A value of true if the target item is found, false if not.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CIndexBSTree<NodeType>::ItemInTree(const NodeType  &target) const
+{
+    return (Retrieve(target) != INDEX_NULL);
+
+}  // end of "CIndexBSTree<NodeType>::ItemInTree"
+
+
+
+// ==== CIndexBSTree::PostOrder ===============================================
+//
+// This function performs a post-order traversal through the tree, calling the
+// "fPtr" parameter for each node.  The path down to the current node is kept
+// on an explicit stack, and a node is visited once its right subtree is done,
+// which is known when the node last visited is its right child (or it has
+// none).
+//
+// Access: protected
+//
+// Input:
+//      index [IN]      -- the index of a tree node (initially this is the
+//                         root)
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference to a NodeType object as input and
+//                         returns nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::PostOrder(uint32_t  index
+                                    , void (*fPtr)(const NodeType&)) const
+{
+    vector<uint32_t>    pending;
+    uint32_t            last = INDEX_NULL;
+
+    while(index != INDEX_NULL || !pending.empty())
+    {
+        while(index != INDEX_NULL)
+        {
+            pending.push_back(index);
+            index = m_links[index].m_left;
+        }
+
+        index = pending.back();
+        if(m_links[index].m_right != INDEX_NULL
+                                        && m_links[index].m_right != last)
+        {
+            index = m_links[index].m_right;
+            continue;
+        }
+
+        pending.pop_back();
+        (*fPtr)(m_values[index]);
+        last = index;
+        index = INDEX_NULL;
+    }
+
+}  // end of "CIndexBSTree<NodeType>::PostOrder"
+
+
+
+// ==== CIndexBSTree::PostOrderTraverse =======================================
+//
+// This function allows the caller to execute a post-order traversal through
+// the tree, and have the "fPtr" parameter called for each node in the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a NodeType object as input, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::PostOrderTraverse(
+                                    void  (*fPtr)(const NodeType&)) const
+{
+    PostOrder(m_root, fPtr);
+
+}  // end of "CIndexBSTree<NodeType>::PostOrderTraverse"
+
+
+
+// ==== CIndexBSTree::PreOrder ================================================
+//
+// This function performs a pre-order traversal through the tree, calling the
+// "fPtr" parameter for each node.  It runs down the left links visiting each
+// node, and keeps the right children it passes on an explicit stack to be
+// visited after the left subtree.
+//
+// Access: protected
+//
+// Input:
+//      index [IN]      -- the index of a tree node (initially this is the
+//                         root)
+//
+//      fPtr [IN]       -- a pointer to a non-member function that takes a
+//                         const reference NodeType object as input, and returns
+//                         nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::PreOrder(uint32_t  index
+                                    , void  (*fPtr)(const NodeType&)) const
+{
+    vector<uint32_t>    pending;
+
+    for(;;)
+    {
+        while(index != INDEX_NULL)
+        {
+            (*fPtr)(m_values[index]);
+            if(m_links[index].m_right != INDEX_NULL)
+            {
+                pending.push_back(m_links[index].m_right);
+            }
+            index = m_links[index].m_left;
+        }
+
+        if(pending.empty())
+        {
+            break;
+        }
+        index = pending.back();
+        pending.pop_back();
+    }
+
+}  // end of "CIndexBSTree<NodeType>::PreOrder"
+
+
+
+// ==== CIndexBSTree::PreOrderTraverse ========================================
+//
+// This function allows the caller to execute a pre-order traversal through the
+// tree, and have the "fPtr" parameter called for each node in the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a NodeType object as input, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::PreOrderTraverse(
+                                    void (*fPtr)(const NodeType&)) const
+{
+    PreOrder(m_root, fPtr);
+
+}  // end of "CIndexBSTree<NodeType>::PreOrderTraverse"
+
+
+
+// ==== CIndexBSTree::RebalanceTree ===========================================
+//
+// This function rebalances the tree to an optimal height.  It saves the node
+// indices in sorted order by calling CIndexBSTree::SaveToArray, then rewrites
+// the value array so that slot i holds the i-th smallest value.  The links are
+// rebuilt over the sorted slots by CIndexBSTree::BuildBalanced.  Free slots are
+// dropped along the way, so afterwards the arrays are dense and the values are
+// stored in order.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::RebalanceTree()
+{
+    vector<uint32_t>    order;
+    vector<NodeType>    sorted;
+
+    order.reserve(m_numNodes);
+    SaveToArray(m_root, order);
+
+    sorted.reserve(order.size());
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        sorted.push_back(std::move(m_values[order[i]]));
+    }
+
+    m_values.swap(sorted);
+    m_links.assign(m_values.size(), CIndexLinks());
+    m_freeList = INDEX_NULL;
+    m_root = m_values.empty() ? INDEX_NULL
+                : BuildBalanced(0, static_cast<uint32_t>(m_values.size() - 1));
+
+}  // end of "CIndexBSTree<NodeType>::RebalanceTree"
+
+
+
+// ==== CIndexBSTree::RemoveSlot ==============================================
+//
+// This function unlinks the node holding the target value from the tree.  The
+// node's slot is not released.  If the node has two children, its inorder
+// successor is relinked into its place, so each value stays in the slot it
+// was inserted into.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType item that contains
+//                         the target search key value
+//
+// Output:
+//      The index of the unlinked node, or INDEX_NULL if the target is not in
+//      the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint32_t    CIndexBSTree<NodeType>::RemoveSlot(const NodeType  &target)
+{
+    uint32_t    *link = &m_root;
+    uint32_t    *succLink;
+    uint32_t    index;
+    uint32_t    succ;
+
+    // no slots are added here, so addresses into the link array stay valid
+    while(*link != INDEX_NULL)
+    {
+        index = *link;
+        if(target < m_values[index])
+        {
+            link = &m_links[index].m_left;
+        }
+        else if(m_values[index] < target)
+        {
+            link = &m_links[index].m_right;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    index = *link;
+    if(index == INDEX_NULL)
+    {
+        return INDEX_NULL;
+    }
+
+    CIndexLinks &node = m_links[index];
+    if(node.m_left == INDEX_NULL)
+    {
+        *link = node.m_right;
+    }
+    else if(node.m_right == INDEX_NULL)
+    {
+        *link = node.m_left;
+    }
+    else
+    {
+        succLink = &node.m_right;
+        while(m_links[*succLink].m_left != INDEX_NULL)
+        {
+            succLink = &m_links[*succLink].m_left;
+        }
+
+        succ = *succLink;
+        *succLink = m_links[succ].m_right;
+        m_links[succ].m_left = node.m_left;
+        m_links[succ].m_right = node.m_right;
+        *link = succ;
+    }
+
+    return index;
+
+}  // end of "CIndexBSTree<NodeType>::RemoveSlot"
+
+
+
+// ==== CIndexBSTree::Reserve =================================================
+//
+// This function grows the node arrays ahead of time so that the next numNodes
+// insertions do not have to reallocate them.
+//
+// Access: public
+//
+// Input:
+//      numNodes [IN]   -- the number of nodes to make room for
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::Reserve(uint32_t  numNodes)
+{
+    m_values.reserve(numNodes);
+    m_links.reserve(numNodes);
+
+}  // end of "CIndexBSTree<NodeType>::Reserve"
+
+
+
+// ==== CIndexBSTree::Retrieve ================================================
+//
+// This function finds the node in the tree whose value equals that of the
+// target parameter.  The search loops down from the root, reading only the
+// value and link arrays.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a reference to a NodeType object; it is assumed that
+//                         the object is fully initialized so a search can be
+//                         performed
+//
+// Output:
+//      The index of the node holding the target value, or INDEX_NULL if the
+//      target is not in the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint32_t    CIndexBSTree<NodeType>::Retrieve(const NodeType  &target) const
+{
+    uint32_t    index = m_root;
+
+    while(index != INDEX_NULL)
+    {
+        if(target < m_values[index])
+        {
+            index = m_links[index].m_left;
+        }
+        else if(m_values[index] < target)
+        {
+            index = m_links[index].m_right;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return index;
+
+}  // end of "CIndexBSTree<NodeType>::Retrieve"
+
+
+
+// ==== CIndexBSTree::SaveToArray =============================================
+//
+// This function performs an inorder traversal of the tree, appending the
+// index of each node to the caller's vector so that the indices are in
+// sorted ascending order of their values.  As in CIndexBSTree::InOrder, the
+// pending nodes are kept on an explicit stack.
+//
+// Access: protected
+//
+// Input:
+//      index [IN]      -- the index of a tree node, initially the root
+//
+//      order [IN/OUT]  -- a reference to the caller's vector of indices
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CIndexBSTree<NodeType>::SaveToArray(uint32_t  index
+                                        , vector<uint32_t>  &order) const
+{
+    vector<uint32_t>    pending;
+
+    while(index != INDEX_NULL || !pending.empty())
+    {
+        while(index != INDEX_NULL)
+        {
+            pending.push_back(index);
+            index = m_links[index].m_left;
+        }
+
+        index = pending.back();
+        pending.pop_back();
+        order.push_back(index);
+        index = m_links[index].m_right;
+    }
+
+}  // end of "CIndexBSTree<NodeType>::SaveToArray"
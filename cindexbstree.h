@@ -0,0 +1,73 @@
+// ============================================================================
+// File: cindexbstree.h
+// ============================================================================
+// This header file contains the declaration of the CIndexBSTree class. It uses
+// the template parameter "NodeType" for the type of values that are stored in
+// the tree.
+//
+// The tree offers the same interface as CBSTree, but its nodes live in two
+// contiguous, growable arrays: one for the values and one for the child links
+// (see cindexnode.h).  A node is identified by its index in those arrays, and
+// the children are 32-bit indices rather than pointers.  Because there are no
+// pointers, the whole tree can be copied, moved or written out as plain
+// arrays.  Released slots are chained into a free list and reused by later
+// insertions.
+// ============================================================================
+
+#ifndef CINDEX_BIN_SEARCH_TREE_HEADER
+#define CINDEX_BIN_SEARCH_TREE_HEADER
+
+#include    <vector>
+using namespace std;
+#include    "cindexnode.h"
+
+// class declaration
+template    <typename  NodeType>
+class   CIndexBSTree
+{
+public:
+    // constructor (the compiler-generated copy constructor, assignment
+    // operator and destructor copy and release the arrays directly)
+    CIndexBSTree() : m_root(INDEX_NULL), m_freeList(INDEX_NULL), m_numNodes(0)
+                                                                        {}
+
+    // member functions
+    bool    DeleteItem(const NodeType  &target);
+    void    DestroyTree();
+    void    GetTreeInfo(size_t  &numNodes, size_t  &height) const;
+    void    InOrderTraverse(void  (*fPtr)(const NodeType&)) const;
+    bool    InsertItem(const NodeType  &newItem);
+    bool    IsTreeEmpty() const { return (INDEX_NULL == m_root); }
+    bool    ItemInTree(const NodeType  &target) const;
+    void    PostOrderTraverse(void (*fPtr)(const NodeType&)) const;
+    void    PreOrderTraverse(void (*fPtr)(const NodeType&)) const;
+    void    RebalanceTree();
+    void    Reserve(uint32_t  numNodes);
+
+protected:
+    // member functions
+    uint32_t    AllocSlot(const NodeType  &newItem);
+    uint32_t    BuildBalanced(uint32_t  first, uint32_t  last);
+    size_t      CountNodes(uint32_t  index, size_t  &numNodes) const;
+    void        FreeSlot(uint32_t  index);
+    void        InOrder(uint32_t  index
+                            , void (*fPtr)(const NodeType&)) const;
+    uint32_t    InsertSlot(const NodeType  &newItem, bool  &bInserted);
+    void        PostOrder(uint32_t  index
+                            , void (*fPtr)(const NodeType&)) const;
+    void        PreOrder(uint32_t  index
+                            , void (*fPtr)(const NodeType&)) const;
+    uint32_t    RemoveSlot(const NodeType  &target);
+    uint32_t    Retrieve(const NodeType  &target) const;
+    void        SaveToArray(uint32_t  index, vector<uint32_t>  &order) const;
+
+    // data members
+    vector<NodeType>        m_values;
+    vector<CIndexLinks>     m_links;
+    uint32_t                m_root;
+    uint32_t                m_freeList;
+    uint32_t                m_numNodes;
+};
+
+#include    "cindexbstree.cpp"
+#endif  // CINDEX_BIN_SEARCH_TREE_HEADER
@@ -0,0 +1,29 @@
+// ============================================================================
+// File: cindexnode.h
+// ============================================================================
+// This file contains the definition of the CIndexLinks struct, which holds the
+// child links of a node in a CIndexBSTree.  Instead of pointers, the links are
+// 32-bit indices into the tree's node arrays, so a pair of links takes eight
+// bytes on every host.  The node's value is kept in a separate array by the
+// tree, so a search only touches the keys and the links.
+// ============================================================================
+
+#ifndef CINDEX_NODE_HEADER
+#define CINDEX_NODE_HEADER
+
+#include    <cstdint>
+
+// the index value that stands in for a NULL child link
+const   uint32_t    INDEX_NULL = 0xFFFFFFFFu;
+
+struct  CIndexLinks
+{
+    // constructor
+    CIndexLinks() : m_left(INDEX_NULL), m_right(INDEX_NULL) {}
+
+    // data members
+    uint32_t    m_left;
+    uint32_t    m_right;
+};
+
+#endif  // CINDEX_NODE_HEADER
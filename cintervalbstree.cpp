@@ -0,0 +1,887 @@
+// ============================================================================
+// File: cintervalbstree.cpp
+// ============================================================================
+// This file contains the implementation of the CIntervalBSTree class. It uses
+// the template parameter "IntType" for the type of keys that are stored in the
+// tree.
+// ============================================================================
+
+#include    <utility>
+using namespace std;
+#include    "cintervalbstree.h"
+
+
+// ==== CIntervalBSTree::CIntervalBSTree ======================================
+//
+// This is the copy constructor for the CIntervalBSTree class, it just makes a
+// call to the CopyTree member function and saves the return value in the root
+// member of the calling object.
+//
+// Access: public
+//
+// Input:
+//      other [IN]  -- a constant reference to a CIntervalBSTree object.
+//
+// ============================================================================
+
+template    <typename  IntType>
+CIntervalBSTree<IntType>::CIntervalBSTree(const CIntervalBSTree<IntType>  &other)
+                                    : m_root(NULL)
+                                    , m_numKeys(other.m_numKeys)
+                                    , m_numIntervals(other.m_numIntervals)
+{
+    m_root = CopyTree(other.m_root);
+
+}  // end of "CIntervalBSTree<IntType>::CIntervalBSTree"
+
+
+
+// ==== CIntervalBSTree::BuildBalanced ========================================
+//
+// This function links the nodes first..last, which are already in sorted
+// ascending order, into a balanced subtree.  The middle node becomes the
+// subtree root and the two halves are linked by recursive calls, so the
+// recursion depth is only logarithmic in the number of nodes.
+//
+// Access: protected
+//
+// Input:
+//      nodes [IN]      -- the nodes of the tree in sorted order
+//
+//      first [IN]      -- the index of the first node
+//
+//      last [IN]       -- the index of the last node
+//
+// Output:
+//      A pointer to the root of the new subtree.
+//
+// ============================================================================
+
+template    <typename  IntType>
+CIntervalNode<IntType>*  CIntervalBSTree<IntType>::BuildBalanced(
+                                const vector<CIntervalNode<IntType>*>  &nodes
+                                , size_t  first, size_t  last)
+{
+    size_t                  mid = first + (last - first) / 2;
+    CIntervalNode<IntType>  *nodePtr = nodes[mid];
+
+    nodePtr->m_left = (mid > first) ? BuildBalanced(nodes, first, mid - 1)
+                                    : NULL;
+    nodePtr->m_right = (mid < last) ? BuildBalanced(nodes, mid + 1, last)
+                                    : NULL;
+    return nodePtr;
+
+}  // end of "CIntervalBSTree<IntType>::BuildBalanced"
+
+
+
+// ==== CIntervalBSTree::CopyTree =============================================
+//
+// This function copies the contents of the sourcePtr tree into a new tree
+// and returns a pointer to the root of the copy.  The nodes are copied in
+// preorder: the function runs down the left links copying each node, and
+// keeps on an explicit stack the right children it passes along with the
+// links their copies belong in, so a tree of any depth can be copied.
+//
+// Access: private
+//
+// Input:
+//      sourcePtr [IN]  -- a pointer to the root of the subtree to copy
+//
+// Output:
+//      A pointer to the root of the new subtree, or NULL if sourcePtr is NULL.
+//
+// ============================================================================
+
+template    <typename  IntType>
+CIntervalNode<IntType>*  CIntervalBSTree<IntType>::CopyTree(
+                                    const CIntervalNode<IntType>  *sourcePtr)
+{
+    vector<pair<const CIntervalNode<IntType>*, CIntervalNode<IntType>**> >
+                            pending;
+    CIntervalNode<IntType>  *rootPtr = NULL;
+    CIntervalNode<IntType>  **link = &rootPtr;
+
+    for(;;)
+    {
+        while(sourcePtr != NULL)
+        {
+            *link = new CIntervalNode<IntType>(sourcePtr->m_low
+                                                    , sourcePtr->m_high);
+            if(sourcePtr->m_right != NULL)
+            {
+                pending.push_back(make_pair(sourcePtr->m_right
+                                                , &(*link)->m_right));
+            }
+            link = &(*link)->m_left;
+            sourcePtr = sourcePtr->m_left;
+        }
+
+        if(pending.empty())
+        {
+            break;
+        }
+        sourcePtr = pending.back().first;
+        link = pending.back().second;
+        pending.pop_back();
+    }
+
+    return rootPtr;
+
+}  // end of "CIntervalBSTree<IntType>::CopyTree"
+
+
+
+// ==== CIntervalBSTree::DeleteItem ===========================================
+//
+// This function allows the caller to delete a target key from the tree.  The
+// interval holding the key loses its node if the key was all it held, is
+// trimmed if the key is one of its ends, and is split in two otherwise.  The
+// upper half of a split goes in as the leftmost node of the right subtree,
+// the only place where it keeps the tree in order.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to the key to delete
+//
+// Output:
+//      A value of false if the target key is not in the tree, otherwise a
+//      value of true is returned and the key is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  IntType>
+bool    CIntervalBSTree<IntType>::DeleteItem(const IntType  &target)
+{
+    CIntervalNode<IntType> **link = &m_root;
+    CIntervalNode<IntType> *nodePtr;
+
+    while(*link != NULL)
+    {
+        nodePtr = *link;
+        if(target < nodePtr->m_low)
+        {
+            link = &nodePtr->m_left;
+        }
+        else if(nodePtr->m_high < target)
+        {
+            link = &nodePtr->m_right;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if(*link == NULL)
+    {
+        return false;
+    }
+
+    --m_numKeys;
+    if(nodePtr->m_low == nodePtr->m_high)
+    {
+        RemoveNode(link);
+    }
+    else if(target == nodePtr->m_low)
+    {
+        ++nodePtr->m_low;
+    }
+    else if(target == nodePtr->m_high)
+    {
+        --nodePtr->m_high;
+    }
+    else
+    {
+        IntType     upperLow = target;
+        IntType     lowerHigh = target;
+        ++upperLow;
+        --lowerHigh;
+
+        link = &nodePtr->m_right;
+        while(*link != NULL)
+        {
+            link = &(*link)->m_left;
+        }
+        *link = new CIntervalNode<IntType>(upperLow, nodePtr->m_high);
+        nodePtr->m_high = lowerHigh;
+        ++m_numIntervals;
+    }
+
+    return true;
+
+}  // end of "CIntervalBSTree<IntType>::DeleteItem"
+
+
+
+// ==== CIntervalBSTree::DestroyNodes =========================================
+//
+// This function releases the nodes of a subtree without recursion: while the
+// current node has a left child, that child is rotated up in its place, and
+// once it has none, the node is released and its right child becomes
+// current.  No stack is needed however deep the subtree is.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::DestroyNodes(CIntervalNode<IntType>  *nodePtr)
+{
+    CIntervalNode<IntType>  *childPtr;
+
+    while(nodePtr != NULL)
+    {
+        childPtr = nodePtr->m_left;
+        if(childPtr != NULL)
+        {
+            nodePtr->m_left = childPtr->m_right;
+            childPtr->m_right = nodePtr;
+        }
+        else
+        {
+            childPtr = nodePtr->m_right;
+            delete nodePtr;
+        }
+        nodePtr = childPtr;
+    }
+
+}  // end of "CIntervalBSTree<IntType>::DestroyNodes"
+
+
+
+// ==== CIntervalBSTree::GetTreeInfo ==========================================
+//
+// This function allows the caller to get the current number of keys and the
+// height of the tree.  The key count is kept up to date by the insert and
+// delete functions; the height is found by CIntervalBSTree::Height.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- a reference to a size_t that will contain the total
+//                         number of keys currently in the tree
+//
+//      height [OUT]    -- a reference to a size_t that will contain the height
+//                         of the tree of intervals; this is the number of
+//                         edges on the longest path from the root to a leaf,
+//                         and is zero for a tree of one node or an empty tree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::GetTreeInfo(size_t  &numNodes
+                                                , size_t  &height) const
+{
+    numNodes = m_numKeys;
+    height = Height(m_root);
+
+}  // end of "CIntervalBSTree<IntType>::GetTreeInfo"
+
+
+
+// ==== CIntervalBSTree::Height ===============================================
+//
+// This function finds the height of the subtree rooted at nodePtr, counting
+// edges.  The nodes are visited with an explicit stack that holds each
+// pending node with its depth, so the tree may be as deep as it likes.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+// Output:
+//      The height of the subtree, or zero if the subtree is empty.
+//
+// ============================================================================
+
+template    <typename  IntType>
+size_t  CIntervalBSTree<IntType>::Height(const CIntervalNode<IntType>  *nodePtr)
+                                                                        const
+{
+    vector<pair<const CIntervalNode<IntType>*, size_t> >    pending;
+    size_t                                                  height = 0;
+
+    if(nodePtr != NULL)
+    {
+        pending.push_back(make_pair(nodePtr, 0));
+    }
+    while(!pending.empty())
+    {
+        size_t  depth = pending.back().second;
+        nodePtr = pending.back().first;
+        pending.pop_back();
+        if(depth > height)
+        {
+            height = depth;
+        }
+        if(nodePtr->m_right != NULL)
+        {
+            pending.push_back(make_pair(nodePtr->m_right, depth + 1));
+        }
+        if(nodePtr->m_left != NULL)
+        {
+            pending.push_back(make_pair(nodePtr->m_left, depth + 1));
+        }
+    }
+
+    return height;
+
+}  // end of "CIntervalBSTree<IntType>::Height"
+
+
+
+// ==== CIntervalBSTree::InOrder ==============================================
+//
+// This function visits the intervals in order, and the keys of each interval
+// in increasing order, so every key in the tree is visited in order.  The
+// nodes whose left subtrees are still being visited are kept on an explicit
+// stack, so the depth of the tree does not matter.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::InOrder(const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const
+{
+    vector<const CIntervalNode<IntType>*>   pending;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+
+        nodePtr = pending.back();
+        pending.pop_back();
+        VisitKeys(nodePtr, fPtr);
+        nodePtr = nodePtr->m_right;
+    }
+
+}  // end of "CIntervalBSTree<IntType>::InOrder"
+
+
+
+// ==== CIntervalBSTree::InOrderTraverse ======================================
+//
+// This function visits every key in the tree in increasing order by calling
+// CIntervalBSTree::InOrder.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::InOrderTraverse(
+                                void  (*fPtr)(const IntType&)) const
+{
+    InOrder(m_root, fPtr);
+
+}  // end of "CIntervalBSTree<IntType>::InOrderTraverse"
+
+
+
+// ==== CIntervalBSTree::InsertItem ===========================================
+//
+// This function allows the caller to insert a new key into the tree.  The
+// search for the key passes both the nearest interval below it and the
+// nearest interval above it.  If the key is next to both, the two intervals
+// are joined (the upper one's node is released); if it is next to one, that
+// interval grows by one; otherwise a new single-key node is added where the
+// search ended.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- a const reference to the key to insert
+//
+// Output:
+//      A value of true if the key was successfully inserted into the tree,
+//      false if it was already there.
+//
+// ============================================================================
+
+template    <typename  IntType>
+bool    CIntervalBSTree<IntType>::InsertItem(const IntType  &newItem)
+{
+    CIntervalNode<IntType> **link = &m_root;
+    CIntervalNode<IntType> **succLink = NULL;
+    CIntervalNode<IntType> *predPtr = NULL;
+    CIntervalNode<IntType> *nodePtr;
+    bool                   bJoinsPred;
+    bool                   bJoinsSucc;
+
+    while(*link != NULL)
+    {
+        nodePtr = *link;
+        if(newItem < nodePtr->m_low)
+        {
+            succLink = link;
+            link = &nodePtr->m_left;
+        }
+        else if(nodePtr->m_high < newItem)
+        {
+            predPtr = nodePtr;
+            link = &nodePtr->m_right;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // the key lies strictly between the two neighbours, so stepping one
+    // past either end of them cannot overflow
+    bJoinsPred = false;
+    if(predPtr != NULL)
+    {
+        IntType next = predPtr->m_high;
+        bJoinsPred = (++next == newItem);
+    }
+    bJoinsSucc = false;
+    if(succLink != NULL)
+    {
+        IntType prev = (*succLink)->m_low;
+        bJoinsSucc = (--prev == newItem);
+    }
+
+    if(bJoinsPred && bJoinsSucc)
+    {
+        predPtr->m_high = (*succLink)->m_high;
+        RemoveNode(succLink);
+    }
+    else if(bJoinsPred)
+    {
+        predPtr->m_high = newItem;
+    }
+    else if(bJoinsSucc)
+    {
+        (*succLink)->m_low = newItem;
+    }
+    else
+    {
+        *link = new CIntervalNode<IntType>(newItem, newItem);
+        ++m_numIntervals;
+    }
+
+    ++m_numKeys;
+    return true;
+
+}  // end of "CIntervalBSTree<IntType>::InsertItem"
+
+
+
+// ==== CIntervalBSTree::ItemInTree ===========================================
+//
+// This function allows the caller to determine if a target key is in the
+// tree, by searching for the interval that would hold it.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to the key to search for
+//
+// Output:
+//      A value of true if the target key is found, false if not.
+//
+// ============================================================================
+
+template    <typename  IntType>
+bool    CIntervalBSTree<IntType>::ItemInTree(const IntType  &target) const
+{
+    const CIntervalNode<IntType>   *nodePtr = m_root;
+
+    while(nodePtr != NULL)
+    {
+        if(target < nodePtr->m_low)
+        {
+            nodePtr = nodePtr->m_left;
+        }
+        else if(nodePtr->m_high < target)
+        {
+            nodePtr = nodePtr->m_right;
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    return false;
+
+}  // end of "CIntervalBSTree<IntType>::ItemInTree"
+
+
+
+// ==== CIntervalBSTree::PostOrder ============================================
+//
+// This function visits the intervals in post-order, and the keys of each
+// interval in increasing order.  The path down to the current node is kept
+// on an explicit stack, and a node is visited once its right subtree is done,
+// which is known when the node last visited is its right child (or it has
+// none).
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::PostOrder(
+                                        const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const
+{
+    vector<const CIntervalNode<IntType>*>   pending;
+    const CIntervalNode<IntType>            *lastPtr = NULL;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+
+        nodePtr = pending.back();
+        if(nodePtr->m_right != NULL && nodePtr->m_right != lastPtr)
+        {
+            nodePtr = nodePtr->m_right;
+            continue;
+        }
+
+        pending.pop_back();
+        VisitKeys(nodePtr, fPtr);
+        lastPtr = nodePtr;
+        nodePtr = NULL;
+    }
+
+}  // end of "CIntervalBSTree<IntType>::PostOrder"
+
+
+
+// ==== CIntervalBSTree::PostOrderTraverse ====================================
+//
+// This function visits every key in the tree by calling
+// CIntervalBSTree::PostOrder.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::PostOrderTraverse(
+                                void (*fPtr)(const IntType&)) const
+{
+    PostOrder(m_root, fPtr);
+
+}  // end of "CIntervalBSTree<IntType>::PostOrderTraverse"
+
+
+
+// ==== CIntervalBSTree::PreOrder =============================================
+//
+// This function visits the intervals in pre-order, and the keys of each
+// interval in increasing order.  It runs down the left links visiting each
+// node, and keeps the right children it passes on an explicit stack to be
+// visited after the left subtree.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::PreOrder(
+                                        const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const
+{
+    vector<const CIntervalNode<IntType>*>   pending;
+
+    for(;;)
+    {
+        while(nodePtr != NULL)
+        {
+            VisitKeys(nodePtr, fPtr);
+            if(nodePtr->m_right != NULL)
+            {
+                pending.push_back(nodePtr->m_right);
+            }
+            nodePtr = nodePtr->m_left;
+        }
+
+        if(pending.empty())
+        {
+            break;
+        }
+        nodePtr = pending.back();
+        pending.pop_back();
+    }
+
+}  // end of "CIntervalBSTree<IntType>::PreOrder"
+
+
+
+// ==== CIntervalBSTree::PreOrderTraverse =====================================
+//
+// This function visits every key in the tree by calling
+// CIntervalBSTree::PreOrder.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::PreOrderTraverse(
+                                void (*fPtr)(const IntType&)) const
+{
+    PreOrder(m_root, fPtr);
+
+}  // end of "CIntervalBSTree<IntType>::PreOrderTraverse"
+
+
+
+// ==== CIntervalBSTree::RebalanceTree ========================================
+//
+// This function rebalances the tree of intervals to an optimal height.  The
+// nodes are collected in sorted order by CIntervalBSTree::SaveToArray and then
+// relinked by CIntervalBSTree::BuildBalanced; no node is allocated or freed.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::RebalanceTree()
+{
+    vector<CIntervalNode<IntType>*>    nodes;
+
+    nodes.reserve(m_numIntervals);
+    SaveToArray(m_root, nodes);
+    m_root = nodes.empty() ? NULL : BuildBalanced(nodes, 0, nodes.size() - 1);
+
+}  // end of "CIntervalBSTree<IntType>::RebalanceTree"
+
+
+
+// ==== CIntervalBSTree::RemoveNode ===========================================
+//
+// This function unlinks and releases the node that a link points to.  A node
+// with two children is replaced by the leftmost node of its right subtree.
+//
+// Access: protected
+//
+// Input:
+//      link [IN/OUT]   -- the address of the link (the root or a child
+//                         pointer) that points to the node to remove
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::RemoveNode(CIntervalNode<IntType>  **link)
+{
+    CIntervalNode<IntType> *nodePtr = *link;
+
+    if(nodePtr->m_left == NULL)
+    {
+        *link = nodePtr->m_right;
+    }
+    else if(nodePtr->m_right == NULL)
+    {
+        *link = nodePtr->m_left;
+    }
+    else
+    {
+        CIntervalNode<IntType> **minLink = &nodePtr->m_right;
+        while((*minLink)->m_left != NULL)
+        {
+            minLink = &(*minLink)->m_left;
+        }
+
+        CIntervalNode<IntType> *minPtr = *minLink;
+        *minLink = minPtr->m_right;
+        minPtr->m_left = nodePtr->m_left;
+        minPtr->m_right = nodePtr->m_right;
+        *link = minPtr;
+    }
+
+    delete nodePtr;
+    --m_numIntervals;
+
+}  // end of "CIntervalBSTree<IntType>::RemoveNode"
+
+
+
+// ==== CIntervalBSTree::SaveToArray ==========================================
+//
+// This function appends the nodes of a subtree to an array in sorted order,
+// with an in-order walk that keeps the pending nodes on an explicit stack.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+//      nodes [OUT]     -- the array the nodes are appended to
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::SaveToArray(CIntervalNode<IntType>  *nodePtr
+                                , vector<CIntervalNode<IntType>*>  &nodes)
+{
+    vector<CIntervalNode<IntType>*>     pending;
+
+    while(nodePtr != NULL || !pending.empty())
+    {
+        while(nodePtr != NULL)
+        {
+            pending.push_back(nodePtr);
+            nodePtr = nodePtr->m_left;
+        }
+
+        nodePtr = pending.back();
+        pending.pop_back();
+        nodes.push_back(nodePtr);
+        nodePtr = nodePtr->m_right;
+    }
+
+}  // end of "CIntervalBSTree<IntType>::SaveToArray"
+
+
+
+// ==== CIntervalBSTree::VisitKeys ============================================
+//
+// This function calls fPtr for each key of one interval, in increasing order.
+// The loop stops on reaching the upper end rather than when the key passes
+// it, so an interval that ends at the largest IntType value is handled.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the node holding the interval
+//
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  IntType>
+void    CIntervalBSTree<IntType>::VisitKeys(
+                                        const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const
+{
+    IntType     key = nodePtr->m_low;
+
+    for(;;)
+    {
+        fPtr(key);
+        if(key == nodePtr->m_high)
+        {
+            break;
+        }
+        ++key;
+    }
+
+}  // end of "CIntervalBSTree<IntType>::VisitKeys"
+
+
+
+// ==== CIntervalBSTree::operator= ============================================
+//
+// This is the overloaded assignment operator for the CIntervalBSTree class.
+// It first checks for assignment to self, then releases all of the nodes in
+// the calling object and replicates the parameter's tree with CopyTree.
+//
+// Access: public
+//
+// Input:
+//      rhs [IN]    -- a const reference to an existing CIntervalBSTree object
+//
+// Output:
+//      A reference to the calling object.
+//
+// ============================================================================
+
+template    <typename  IntType>
+CIntervalBSTree<IntType>&  CIntervalBSTree<IntType>::operator=(
+                                    const CIntervalBSTree<IntType>  &rhs)
+{
+    if(this != &rhs)
+    {
+        DestroyTree();
+        m_root = CopyTree(rhs.m_root);
+        m_numKeys = rhs.m_numKeys;
+        m_numIntervals = rhs.m_numIntervals;
+    }
+    return *this;
+
+}  // end of "CIntervalBSTree<IntType>::operator="
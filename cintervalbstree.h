@@ -0,0 +1,96 @@
+// ============================================================================
+// File: cintervalbstree.h
+// ============================================================================
+// This header file contains the declaration of the CIntervalBSTree class. It
+// uses the template parameter "IntType", which must be an integral type, for
+// the type of keys that are stored in the tree.
+//
+// The tree offers the same interface as CBSTree, but each node holds a closed
+// interval of consecutive keys (see cintervalnode.h) rather than one key.  The
+// intervals never overlap or touch: InsertItem extends a neighbouring interval
+// or joins two of them when the new key fills the gap between, and DeleteItem
+// trims an interval or splits it in two.  A dense set of keys such as 1 to
+// 10,000,000 is therefore held in a single node.
+//
+// ItemInTree and the traversals work with keys, exactly as in CBSTree; the
+// traversals visit the keys of each interval in increasing order, taking the
+// intervals in in-order, pre-order or post-order.  GetTreeInfo reports the
+// number of keys, and the height of the tree of intervals.
+//
+// The tree does not balance itself unless RebalanceTree is called, so sparse
+// keys inserted in order leave it as deep as it is long.  No operation
+// recurses on the height: the walks keep their pending nodes on an explicit
+// stack, and DestroyTree frees the nodes by rotating them into a vine.
+// ============================================================================
+
+#ifndef CINTERVAL_BIN_SEARCH_TREE_HEADER
+#define CINTERVAL_BIN_SEARCH_TREE_HEADER
+
+#include    <type_traits>
+#include    <vector>
+using namespace std;
+#include    "cintervalnode.h"
+
+// class declaration
+template    <typename  IntType>
+class   CIntervalBSTree
+{
+    static_assert(is_integral<IntType>::value
+                            , "CIntervalBSTree keys must be of integral type");
+
+public:
+    // constructors and destructor
+    CIntervalBSTree() : m_root(NULL), m_numKeys(0), m_numIntervals(0) {}
+    CIntervalBSTree(const CIntervalBSTree  &other);
+    virtual ~CIntervalBSTree() { DestroyTree(); }
+
+    // member functions
+    bool    DeleteItem(const IntType  &target);
+    void    DestroyTree() { DestroyNodes(m_root); m_root = NULL;
+                                        m_numKeys = m_numIntervals = 0; }
+    size_t  GetNumIntervals() const { return m_numIntervals; }
+    void    GetTreeInfo(size_t  &numNodes, size_t  &height) const;
+    void    InOrderTraverse(void  (*fPtr)(const IntType&)) const;
+    bool    InsertItem(const IntType  &newItem);
+    bool    IsTreeEmpty() const { return (NULL == m_root); }
+    bool    ItemInTree(const IntType  &target) const;
+    void    PostOrderTraverse(void (*fPtr)(const IntType&)) const;
+    void    PreOrderTraverse(void (*fPtr)(const IntType&)) const;
+    void    RebalanceTree();
+
+    // operators
+    CIntervalBSTree<IntType>&  operator=(const CIntervalBSTree<IntType> &rhs);
+
+protected:
+    // member functions
+    CIntervalNode<IntType>* BuildBalanced(const vector<CIntervalNode<IntType>*>
+                                                                    &nodes
+                                        , size_t  first, size_t  last);
+    void                    DestroyNodes(CIntervalNode<IntType>  *nodePtr);
+    size_t                  Height(const CIntervalNode<IntType>  *nodePtr)
+                                                                    const;
+    void                    InOrder(const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const;
+    void                    PostOrder(const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const;
+    void                    PreOrder(const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const;
+    void                    RemoveNode(CIntervalNode<IntType>  **link);
+    void                    SaveToArray(CIntervalNode<IntType>  *nodePtr
+                                        , vector<CIntervalNode<IntType>*>
+                                                                    &nodes);
+    void                    VisitKeys(const CIntervalNode<IntType>  *nodePtr
+                                        , void (*fPtr)(const IntType&)) const;
+
+private:
+    // member functions
+    CIntervalNode<IntType>* CopyTree(const CIntervalNode<IntType>  *sourcePtr);
+
+    // data members
+    CIntervalNode<IntType>  *m_root;
+    size_t                  m_numKeys;
+    size_t                  m_numIntervals;
+};
+
+#include    "cintervalbstree.cpp"
+#endif  // CINTERVAL_BIN_SEARCH_TREE_HEADER
@@ -0,0 +1,31 @@
+// ============================================================================
+// File: cintervalnode.h
+// ============================================================================
+// This file contains the definition of the CIntervalNode class, the node type
+// of a CIntervalBSTree.  Instead of a single value it holds a closed interval
+// [m_low, m_high] of consecutive integers, all of which are in the tree.
+// ============================================================================
+
+#ifndef CINTERVAL_NODE_HEADER
+#define CINTERVAL_NODE_HEADER
+
+#include    <iostream>
+using namespace std;
+
+template    <typename  IntType>
+class   CIntervalNode
+{
+public:
+    // constructor
+    CIntervalNode(IntType  low, IntType  high) : m_low(low), m_high(high)
+                                    , m_left(NULL), m_right(NULL) {}
+    ~CIntervalNode() { m_left = m_right = NULL; }
+
+    // data members
+    IntType             m_low;
+    IntType             m_high;
+    CIntervalNode       *m_left;
+    CIntervalNode       *m_right;
+};
+
+#endif  // CINTERVAL_NODE_HEADER
@@ -0,0 +1,264 @@
+// ============================================================================
+// File: ckeyvaluebstree.cpp
+// ============================================================================
+// This file contains the implementation of the CKeyValueBSTree class. It uses
+// the template parameter "KeyType" for the type of the keys and the template
+// parameter "ValueType" for the type of the values stored with them.
+// ============================================================================
+
+#include    "ckeyvaluebstree.h"
+
+
+// ==== CKeyValueBSTree::DeleteItem ===========================================
+//
+// This function removes a key and its value from the tree.  The key's node is
+// unlinked by CIndexBSTree::RemoveSlot, its value is reset and the slot is
+// returned to the free list.
+//
+// Access: public
+//
+// Input:
+//      key [IN]        -- the key to remove
+//
+// Output:
+//      A value of true if the key was found and removed, false otherwise.
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+bool    CKeyValueBSTree<KeyType, ValueType>::DeleteItem(const KeyType  &key)
+{
+    uint32_t    index = BaseTree::RemoveSlot(key);
+
+    if(index == INDEX_NULL)
+    {
+        return false;
+    }
+
+    m_payloads[index] = ValueType();
+    BaseTree::FreeSlot(index);
+    return true;
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::DeleteItem"
+
+
+
+// ==== CKeyValueBSTree::DestroyTree ==========================================
+//
+// This function releases every key and value in the tree, along with the
+// memory held by the arrays.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+void    CKeyValueBSTree<KeyType, ValueType>::DestroyTree()
+{
+    vector<ValueType>().swap(m_payloads);
+    BaseTree::DestroyTree();
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::DestroyTree"
+
+
+
+// ==== CKeyValueBSTree::FindValue ============================================
+//
+// These functions look a key up with CIndexBSTree::Retrieve, which reads only
+// the key and link arrays, and return the value stored with it.
+//
+// Access: public
+//
+// Input:
+//      key [IN]        -- the key to look for
+//
+// Output:
+//      A pointer to the key's value, or NULL if the key is not in the tree.
+//      The pointer is valid until the next insertion, deletion or rebalance.
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+ValueType*  CKeyValueBSTree<KeyType, ValueType>::FindValue(const KeyType  &key)
+{
+    uint32_t    index = BaseTree::Retrieve(key);
+
+    if(index == INDEX_NULL)
+    {
+        return NULL;
+    }
+    return &m_payloads[index];
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::FindValue"
+
+template    <typename  KeyType, typename  ValueType>
+const ValueType*    CKeyValueBSTree<KeyType, ValueType>::FindValue(
+                                                const KeyType  &key) const
+{
+    uint32_t    index = BaseTree::Retrieve(key);
+
+    if(index == INDEX_NULL)
+    {
+        return NULL;
+    }
+    return &m_payloads[index];
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::FindValue"
+
+
+
+// ==== CKeyValueBSTree::InOrderTraverse ======================================
+//
+// This function visits every key in increasing order, along with its value.
+// It walks the tree with an explicit stack of the nodes whose left subtrees
+// are being visited, which never holds more than the height of the tree.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]   -- a pointer to a non-member function that takes a const
+//                     reference to a key and to its value, and returns
+//                     nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+void    CKeyValueBSTree<KeyType, ValueType>::InOrderTraverse(
+                void  (*fPtr)(const KeyType&, const ValueType&)) const
+{
+    vector<uint32_t>    stack;
+    uint32_t            index = BaseTree::m_root;
+
+    while(index != INDEX_NULL || !stack.empty())
+    {
+        while(index != INDEX_NULL)
+        {
+            stack.push_back(index);
+            index = BaseTree::m_links[index].m_left;
+        }
+
+        index = stack.back();
+        stack.pop_back();
+        (*fPtr)(BaseTree::m_values[index], m_payloads[index]);
+        index = BaseTree::m_links[index].m_right;
+    }
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::InOrderTraverse"
+
+
+
+// ==== CKeyValueBSTree::InsertItem ===========================================
+//
+// This function adds a key and its value to the tree.  The key is linked in
+// by CIndexBSTree::InsertSlot, and the value is stored in the same slot of
+// the value array.  A slot that InsertSlot has appended to the key array is
+// appended to the value array as well, so the two stay the same length.
+//
+// Access: public
+//
+// Input:
+//      key [IN]        -- the key to add
+//
+//      value [IN]      -- the value to store with it
+//
+// Output:
+//      A value of true if the key was added, false if it was already in the
+//      tree (its value is left unchanged; see FindValue) or the tree is full.
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+bool    CKeyValueBSTree<KeyType, ValueType>::InsertItem(const KeyType  &key
+                                                , const ValueType  &value)
+{
+    bool        bInserted;
+    uint32_t    index = BaseTree::InsertSlot(key, bInserted);
+
+    if(!bInserted)
+    {
+        return false;
+    }
+
+    if(index == m_payloads.size())
+    {
+        m_payloads.push_back(value);
+    }
+    else
+    {
+        m_payloads[index] = value;
+    }
+    return true;
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::InsertItem"
+
+
+
+// ==== CKeyValueBSTree::RebalanceTree ========================================
+//
+// This function rebalances the tree with CIndexBSTree::RebalanceTree, which
+// moves the i-th smallest key to slot i.  The values are first moved the same
+// way, using the same in-order list of slots.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+void    CKeyValueBSTree<KeyType, ValueType>::RebalanceTree()
+{
+    vector<uint32_t>    order;
+    vector<ValueType>   sorted;
+
+    order.reserve(BaseTree::m_numNodes);
+    BaseTree::SaveToArray(BaseTree::m_root, order);
+
+    sorted.reserve(order.size());
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        sorted.push_back(std::move(m_payloads[order[i]]));
+    }
+
+    m_payloads.swap(sorted);
+    BaseTree::RebalanceTree();
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::RebalanceTree"
+
+
+
+// ==== CKeyValueBSTree::Reserve ==============================================
+//
+// This function grows the key, link and value arrays ahead of time so that
+// the next numNodes insertions do not have to reallocate them.
+//
+// Access: public
+//
+// Input:
+//      numNodes [IN]   -- the number of nodes to make room for
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  KeyType, typename  ValueType>
+void    CKeyValueBSTree<KeyType, ValueType>::Reserve(uint32_t  numNodes)
+{
+    m_payloads.reserve(numNodes);
+    BaseTree::Reserve(numNodes);
+
+}  // end of "CKeyValueBSTree<KeyType, ValueType>::Reserve"
@@ -0,0 +1,70 @@
+// ============================================================================
+// File: ckeyvaluebstree.h
+// ============================================================================
+// This header file contains the declaration of the CKeyValueBSTree class, a
+// map from keys to values.  It uses the template parameter "KeyType" for the
+// type of the keys, which order the tree, and the template parameter
+// "ValueType" for the type of the values stored with them.
+//
+// The tree is a CIndexBSTree of keys, which already keeps the keys and the
+// child links in two arrays of their own, apart from anything else.  The
+// values are kept in a third array, parallel to those two: the value of the
+// node in slot i is in slot i of the value array.  A search therefore reads
+// only keys and links, however large the values are, and the value of the
+// node it finds is reached by that node's index without any extra link in the
+// node.  With 200-byte records and small keys a search touches a small
+// fraction of the bytes it would if each record sat inline in its node.
+// Since CIndexBSTree never moves a key to another slot except when
+// RebalanceTree sorts them, a value stays in its slot too.
+//
+// CKeyValueBSTree derives privately from CIndexBSTree, so the CIndexBSTree
+// functions that change the tree but know nothing of the values cannot be
+// reached from outside, not even through a pointer or reference to the base
+// class.  Its own InsertItem, DeleteItem, DestroyTree, RebalanceTree and
+// Reserve change both, so the value array always has exactly as many slots
+// as the key array; the functions that only read the keys are made public
+// again with using-declarations.  ValueType must be default-constructible; a
+// freed slot's value is reset, so that any resources it owns are released at
+// once.
+// ============================================================================
+
+#ifndef CKEY_VALUE_BIN_SEARCH_TREE_HEADER
+#define CKEY_VALUE_BIN_SEARCH_TREE_HEADER
+
+#include    <vector>
+using namespace std;
+#include    "cindexbstree.h"
+
+// class declaration
+template    <typename  KeyType, typename  ValueType>
+class   CKeyValueBSTree : private CIndexBSTree<KeyType>
+{
+public:
+    // member functions
+    bool    DeleteItem(const KeyType  &key);
+    void    DestroyTree();
+    ValueType*  FindValue(const KeyType  &key);
+    const ValueType*    FindValue(const KeyType  &key) const;
+    void    InOrderTraverse(void  (*fPtr)(const KeyType&
+                                            , const ValueType&)) const;
+    bool    InsertItem(const KeyType  &key, const ValueType  &value);
+    void    RebalanceTree();
+    void    Reserve(uint32_t  numNodes);
+
+    // the member functions of the base class that only read the keys
+    using   CIndexBSTree<KeyType>::GetTreeInfo;
+    using   CIndexBSTree<KeyType>::InOrderTraverse;
+    using   CIndexBSTree<KeyType>::IsTreeEmpty;
+    using   CIndexBSTree<KeyType>::ItemInTree;
+    using   CIndexBSTree<KeyType>::PostOrderTraverse;
+    using   CIndexBSTree<KeyType>::PreOrderTraverse;
+
+protected:
+    typedef CIndexBSTree<KeyType>   BaseTree;
+
+    // data members
+    vector<ValueType>       m_payloads;
+};
+
+#include    "ckeyvaluebstree.cpp"
+#endif  // CKEY_VALUE_BIN_SEARCH_TREE_HEADER
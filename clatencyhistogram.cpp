@@ -0,0 +1,329 @@
+// ============================================================================
+// File: clatencyhistogram.cpp
+// ============================================================================
+// This file contains the implementation of the CLatencyHistogram class.
+// ============================================================================
+
+#include    <chrono>
+#include    <cmath>
+#if defined(__x86_64__) || defined(__i386__)
+#include    <x86intrin.h>
+#define     CLATENCY_HAS_TSC
+#endif
+using namespace std;
+#include    "clatencyhistogram.h"
+
+
+// ==== CLatencyHistogram::CLatencyHistogram ==================================
+//
+// This is the constructor for the CLatencyHistogram class.  It creates an
+// empty histogram.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// ============================================================================
+
+inline  CLatencyHistogram::CLatencyHistogram() : m_buckets(NUM_BUCKETS, 0)
+                                        , m_count(0)
+                                        , m_min(UINT64_MAX)
+                                        , m_max(0)
+                                        , m_sum(0)
+{
+}  // end of "CLatencyHistogram::CLatencyHistogram"
+
+
+
+// ==== CLatencyHistogram::BucketIndex ========================================
+//
+// This function finds the bucket that holds a value.  Values below twice
+// SUB_BUCKETS each have a bucket of their own.  A larger value is shifted
+// right until it has SUB_BUCKET_BITS + 1 significant bits; the shift picks
+// the power of two and the low bits of what is left pick the bucket within
+// it.  The shift comes from the position of the highest set bit, which GCC
+// and Clang find with a single instruction.
+//
+// Access: protected
+//
+// Input:
+//      ticks [IN]      -- the value
+//
+// Output:
+//      The index of the bucket.
+//
+// ============================================================================
+
+inline  size_t  CLatencyHistogram::BucketIndex(uint64_t  ticks)
+{
+    unsigned    shift = 0;
+
+    if(ticks < 2 * SUB_BUCKETS)
+    {
+        return static_cast<size_t>(ticks);
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    shift = 63 - static_cast<unsigned>(__builtin_clzll(ticks))
+                                                        - SUB_BUCKET_BITS;
+#else
+    while((ticks >> shift) >= 2 * SUB_BUCKETS)
+    {
+        ++shift;
+    }
+#endif
+    return (shift + 1) * SUB_BUCKETS
+                        + static_cast<size_t>(ticks >> shift) - SUB_BUCKETS;
+
+}  // end of "CLatencyHistogram::BucketIndex"
+
+
+
+// ==== CLatencyHistogram::BucketLimit ========================================
+//
+// This function returns the largest value that falls in a bucket.
+//
+// Access: protected
+//
+// Input:
+//      index [IN]      -- the index of the bucket
+//
+// Output:
+//      The largest value the bucket holds.
+//
+// ============================================================================
+
+inline  uint64_t    CLatencyHistogram::BucketLimit(size_t  index)
+{
+    if(index < SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    unsigned    shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    uint64_t    mantissa = SUB_BUCKETS + index % SUB_BUCKETS;
+
+    return ((mantissa + 1) << shift) - 1;
+
+}  // end of "CLatencyHistogram::BucketLimit"
+
+
+
+// ==== CLatencyHistogram::GetMean ============================================
+//
+// This function returns the mean of the recorded values, in ticks.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The mean, or zero if nothing has been recorded.
+//
+// ============================================================================
+
+inline  double  CLatencyHistogram::GetMean() const
+{
+    return (0 == m_count) ? 0.0 : m_sum / static_cast<double>(m_count);
+
+}  // end of "CLatencyHistogram::GetMean"
+
+
+
+// ==== CLatencyHistogram::GetPercentile ======================================
+//
+// This function returns a value that the given percentage of the recorded
+// values do not exceed: the upper limit of the bucket holding the value of
+// that rank (but no more than the largest value recorded).
+//
+// Access: public
+//
+// Input:
+//      percentile [IN] -- the percentage, from 0 to 100 (for example 99.9)
+//
+// Output:
+//      The percentile in ticks, or zero if nothing has been recorded.
+//
+// ============================================================================
+
+inline  uint64_t    CLatencyHistogram::GetPercentile(double  percentile) const
+{
+    size_t  rank;
+    size_t  seen = 0;
+
+    if(0 == m_count)
+    {
+        return 0;
+    }
+
+    rank = static_cast<size_t>(ceil(percentile / 100.0
+                                        * static_cast<double>(m_count)));
+    if(rank < 1)
+    {
+        rank = 1;
+    }
+    for(size_t i = 0; i < NUM_BUCKETS; ++i)
+    {
+        seen += m_buckets[i];
+        if(seen >= rank)
+        {
+            uint64_t    limit = BucketLimit(i);
+            return (limit < m_max) ? limit : m_max;
+        }
+    }
+    return m_max;
+
+}  // end of "CLatencyHistogram::GetPercentile"
+
+
+
+// ==== CLatencyHistogram::MeasureClockRate ===================================
+//
+// This function measures how many ticks of ReadClock pass per nanosecond, by
+// reading it and std::chrono::steady_clock across a short busy wait.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The number of ticks per nanosecond.
+//
+// ============================================================================
+
+inline  double  CLatencyHistogram::MeasureClockRate()
+{
+#ifdef  CLATENCY_HAS_TSC
+    chrono::steady_clock::time_point    startTime;
+    uint64_t                            startTicks;
+    chrono::nanoseconds                 elapsed;
+
+    startTime = chrono::steady_clock::now();
+    startTicks = ReadClock();
+    do
+    {
+        elapsed = chrono::steady_clock::now() - startTime;
+    } while(elapsed < chrono::milliseconds(10));
+
+    return static_cast<double>(ReadClock() - startTicks)
+                                    / static_cast<double>(elapsed.count());
+#else
+    return 1.0;
+#endif  // CLATENCY_HAS_TSC
+
+}  // end of "CLatencyHistogram::MeasureClockRate"
+
+
+
+// ==== CLatencyHistogram::ReadClock ==========================================
+//
+// This function reads the clock that durations are measured with: the
+// time-stamp counter on x86, and steady_clock nanoseconds elsewhere.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      The current clock reading in ticks.
+//
+// ============================================================================
+
+inline  uint64_t    CLatencyHistogram::ReadClock()
+{
+#ifdef  CLATENCY_HAS_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+                    chrono::steady_clock::now().time_since_epoch()).count());
+#endif  // CLATENCY_HAS_TSC
+
+}  // end of "CLatencyHistogram::ReadClock"
+
+
+
+// ==== CLatencyHistogram::Record =============================================
+//
+// This function adds one value to the histogram.
+//
+// Access: public
+//
+// Input:
+//      ticks [IN]      -- the duration to record, in clock ticks
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CLatencyHistogram::Record(uint64_t  ticks)
+{
+    ++m_buckets[BucketIndex(ticks)];
+    ++m_count;
+    m_sum += static_cast<double>(ticks);
+    if(ticks < m_min)
+    {
+        m_min = ticks;
+    }
+    if(ticks > m_max)
+    {
+        m_max = ticks;
+    }
+
+}  // end of "CLatencyHistogram::Record"
+
+
+
+// ==== CLatencyHistogram::Reset ==============================================
+//
+// This function empties the histogram.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+inline  void    CLatencyHistogram::Reset()
+{
+    m_buckets.assign(NUM_BUCKETS, 0);
+    m_count = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+    m_sum = 0;
+
+}  // end of "CLatencyHistogram::Reset"
+
+
+
+// ==== CLatencyHistogram::ToNanoseconds ======================================
+//
+// This function converts a number of clock ticks to nanoseconds.  The clock
+// rate is measured by CLatencyHistogram::MeasureClockRate the first time
+// this function is called.
+//
+// Access: public
+//
+// Input:
+//      ticks [IN]      -- the number of ticks
+//
+// Output:
+//      The same duration in nanoseconds.
+//
+// ============================================================================
+
+inline  double  CLatencyHistogram::ToNanoseconds(double  ticks)
+{
+    static const double     ticksPerNs = MeasureClockRate();
+
+    return ticks / ticksPerNs;
+
+}  // end of "CLatencyHistogram::ToNanoseconds"
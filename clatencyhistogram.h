@@ -0,0 +1,98 @@
+// ============================================================================
+// File: clatencyhistogram.h
+// ============================================================================
+// This header file contains the declarations of the CLatencyHistogram and
+// CLatencyTimer classes, which measure how long operations take.
+//
+// Durations are read from the CPU's time-stamp counter where there is one
+// (x86), which costs a few nanoseconds, and from std::chrono::steady_clock
+// elsewhere.  Either way they are recorded in clock ticks; ToNanoseconds
+// converts a tick count using a rate measured once, the first time it is
+// needed.
+//
+// The histogram is log-bucketed, in the style of an HDR histogram: every
+// power of two is split into SUB_BUCKETS equal buckets, so any recorded value
+// is known to within 1 / SUB_BUCKETS (about 6%) whatever its size, and the
+// whole range of a 64-bit count fits in under a thousand counters.  Recording
+// a value is a couple of shifts and an increment.  GetPercentile answers
+// queries such as p99 or p99.9 from the bucket counts.
+//
+// A CLatencyTimer reads the clock when it is created and records the elapsed
+// ticks in a histogram when it goes out of scope; given a NULL histogram it
+// does nothing, so a caller can decide per call whether to sample.
+//
+// The classes are not templates, so their functions are declared inline to
+// let the header be included by more than one source file.
+// ============================================================================
+
+#ifndef CLATENCY_HISTOGRAM_HEADER
+#define CLATENCY_HISTOGRAM_HEADER
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <vector>
+using namespace std;
+
+// class declaration
+class   CLatencyHistogram
+{
+public:
+    // constructor
+    CLatencyHistogram();
+
+    // member functions
+    size_t      GetCount() const { return m_count; }
+    uint64_t    GetMax() const { return m_max; }
+    double      GetMean() const;
+    uint64_t    GetMin() const { return (0 == m_count) ? 0 : m_min; }
+    uint64_t    GetPercentile(double  percentile) const;
+    void        Record(uint64_t  ticks);
+    void        Reset();
+
+    static uint64_t ReadClock();
+    static double   ToNanoseconds(double  ticks);
+
+protected:
+    // each power of two is split into 2^SUB_BUCKET_BITS buckets
+    static const unsigned   SUB_BUCKET_BITS = 4;
+    static const size_t     SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static const size_t     NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1)
+                                                            * SUB_BUCKETS;
+
+    // member functions
+    static size_t   BucketIndex(uint64_t  ticks);
+    static uint64_t BucketLimit(size_t  index);
+    static double   MeasureClockRate();
+
+    // data members
+    vector<uint64_t>    m_buckets;
+    size_t              m_count;
+    uint64_t            m_min;
+    uint64_t            m_max;
+    double              m_sum;
+};
+
+// class declaration
+class   CLatencyTimer
+{
+public:
+    // constructor and destructor
+    explicit CLatencyTimer(CLatencyHistogram  *histPtr) : m_hist(histPtr)
+                , m_start((histPtr != NULL) ? CLatencyHistogram::ReadClock()
+                                            : 0) {}
+    ~CLatencyTimer() { if(m_hist != NULL)
+                        m_hist->Record(CLatencyHistogram::ReadClock()
+                                                            - m_start); }
+
+    // a timer measures one scope, so it cannot be copied
+    CLatencyTimer(const CLatencyTimer  &other) = delete;
+    CLatencyTimer&  operator=(const CLatencyTimer  &rhs) = delete;
+
+protected:
+    // data members
+    CLatencyHistogram   *m_hist;
+    uint64_t            m_start;
+};
+
+#include    "clatencyhistogram.cpp"
+#endif  // CLATENCY_HISTOGRAM_HEADER
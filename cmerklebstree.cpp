@@ -0,0 +1,1076 @@
+// ============================================================================
+// File: cmerklebstree.cpp
+// ============================================================================
+// This file contains the implementation of the CMerkleBSTree class. It uses
+// the template parameter "NodeType" for the type of values that are stored in
+// the tree.
+// ============================================================================
+
+#include    <climits>
+using namespace std;
+#include    "cmerklebstree.h"
+
+
+// ==== CMerkleBSTree::CMerkleBSTree ==========================================
+//
+// This is the copy constructor for the CMerkleBSTree class, it just makes a
+// call to the CopyTree member function and saves the return value in the root
+// member of the calling object.  The stored hashes are copied along with the
+// values.
+//
+// Access: public
+//
+// Input:
+//      other [IN]  -- a constant reference to a CMerkleBSTree object.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleBSTree<NodeType>::CMerkleBSTree(const CMerkleBSTree<NodeType>  &other)
+                                    : m_root(NULL)
+                                    , m_numNodes(other.m_numNodes)
+{
+    m_root = CopyTree(other.m_root);
+
+}  // end of "CMerkleBSTree<NodeType>::CMerkleBSTree"
+
+
+
+// ==== CMerkleBSTree::BuildFromSorted ========================================
+//
+// This function replaces the contents of the tree with the values of a sorted
+// array, in O(n).  The values are linked into a Cartesian tree: each new
+// value is the largest so far, so it goes on the right spine, below the last
+// spine node that outranks it, and the spine nodes it outranks become its
+// left subtree.  A node's subtree is complete once it leaves the spine, so
+// that is when its hash is computed.  The result is the same tree that
+// inserting the values one at a time would give.
+//
+// Access: public
+//
+// Input:
+//      array [IN]      -- the values in ascending order; a value equal to the
+//                         one before it is skipped
+//
+//      count [IN]      -- the number of values in the array
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::BuildFromSorted(const NodeType  array[]
+                                                , size_t  count)
+{
+    vector<CMerkleNode<NodeType>*>  spine;
+    CMerkleNode<NodeType>           *nodePtr;
+    CMerkleNode<NodeType>           *lastPopped;
+
+    DestroyTree();
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(i > 0 && ThreeWayCompare(array[i - 1], array[i]) >= 0)
+        {
+            continue;
+        }
+
+        nodePtr = new CMerkleNode<NodeType>(array[i], HashValue(array[i]));
+        lastPopped = NULL;
+        while(!spine.empty() && HigherPriority(nodePtr, spine.back()))
+        {
+            lastPopped = spine.back();
+            spine.pop_back();
+            UpdateHash(lastPopped);
+        }
+        nodePtr->m_left = lastPopped;
+        if(spine.empty())
+        {
+            m_root = nodePtr;
+        }
+        else
+        {
+            spine.back()->m_right = nodePtr;
+        }
+        spine.push_back(nodePtr);
+        ++m_numNodes;
+    }
+
+    while(!spine.empty())
+    {
+        UpdateHash(spine.back());
+        spine.pop_back();
+    }
+
+}  // end of "CMerkleBSTree<NodeType>::BuildFromSorted"
+
+
+
+// ==== CMerkleBSTree::CombineHashes ==========================================
+//
+// This function computes the hash of a subtree from the hash of its root's
+// value and the hashes of its two child subtrees (EMPTY_HASH for an empty
+// one).  The two children go in differently, so a mirrored tree hashes
+// differently.
+//
+// Access: protected
+//
+// Input:
+//      leftHash [IN]   -- the hash of the left subtree
+//
+//      valueHash [IN]  -- the hash of the root's value
+//
+//      rightHash [IN]  -- the hash of the right subtree
+//
+// Output:
+//      The hash of the subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint64_t    CMerkleBSTree<NodeType>::CombineHashes(uint64_t  leftHash
+                                                , uint64_t  valueHash
+                                                , uint64_t  rightHash)
+{
+    return Mix(Mix(leftHash + valueHash)
+                                ^ (rightHash * 0x9E3779B97F4A7C15ull));
+
+}  // end of "CMerkleBSTree<NodeType>::CombineHashes"
+
+
+
+// ==== CMerkleBSTree::CopyTree ===============================================
+//
+// This function copies the contents of the sourcePtr tree into a new tree,
+// recursively, and returns a pointer to the root of the copy.
+//
+// Access: private
+//
+// Input:
+//      sourcePtr [IN]  -- a pointer to the root of the subtree to copy
+//
+// Output:
+//      A pointer to the root of the new subtree, or NULL if sourcePtr is NULL.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleNode<NodeType>*  CMerkleBSTree<NodeType>::CopyTree(
+                                    const CMerkleNode<NodeType>  *sourcePtr)
+{
+    if(sourcePtr == NULL)
+    {
+        return NULL;
+    }
+
+    CMerkleNode<NodeType> *nodePtr = new CMerkleNode<NodeType>(
+                                sourcePtr->m_value, sourcePtr->m_valueHash);
+    nodePtr->m_hash = sourcePtr->m_hash;
+    nodePtr->m_left = CopyTree(sourcePtr->m_left);
+    nodePtr->m_right = CopyTree(sourcePtr->m_right);
+    return nodePtr;
+
+}  // end of "CMerkleBSTree<NodeType>::CopyTree"
+
+
+
+// ==== CMerkleBSTree::Delete =================================================
+//
+// This recursive function removes the target from the subtree rooted at
+// nodePtr.  The target's node is replaced by the join of its two subtrees,
+// and the hashes are recomputed on the way back up the search path.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]         -- a const reference to the item to delete
+//
+//      nodePtr [IN]        -- a pointer to the root of the subtree
+//
+//      bItemDeleted [OUT]  -- set to true if the target was found and removed
+//
+// Output:
+//      A pointer to the (potentially new) root of the subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleNode<NodeType>*  CMerkleBSTree<NodeType>::Delete(
+                                        const NodeType  &target
+                                        , CMerkleNode<NodeType>  *nodePtr
+                                        , bool  &bItemDeleted)
+{
+    if(nodePtr == NULL)
+    {
+        bItemDeleted = false;
+        return NULL;
+    }
+
+    int result = ThreeWayCompare(target, nodePtr->m_value);
+    if(result < 0)
+    {
+        nodePtr->m_left = Delete(target, nodePtr->m_left, bItemDeleted);
+    }
+    else if(result > 0)
+    {
+        nodePtr->m_right = Delete(target, nodePtr->m_right, bItemDeleted);
+    }
+    else
+    {
+        CMerkleNode<NodeType> *joined = Join(nodePtr->m_left
+                                                    , nodePtr->m_right);
+        delete nodePtr;
+        bItemDeleted = true;
+        return joined;
+    }
+
+    if(bItemDeleted)
+    {
+        UpdateHash(nodePtr);
+    }
+    return nodePtr;
+
+}  // end of "CMerkleBSTree<NodeType>::Delete"
+
+
+
+// ==== CMerkleBSTree::DeleteItem =============================================
+//
+// This function allows the caller to delete a target item from the tree.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object
+//
+// Output:
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CMerkleBSTree<NodeType>::DeleteItem(const NodeType  &target)
+{
+    bool    bItemDeleted = false;
+
+    m_root = Delete(target, m_root, bItemDeleted);
+    if(bItemDeleted)
+    {
+        --m_numNodes;
+    }
+    return bItemDeleted;
+
+}  // end of "CMerkleBSTree<NodeType>::DeleteItem"
+
+
+
+// ==== CMerkleBSTree::DestroyNodes ===========================================
+//
+// This function performs a recursive postorder descent down the tree,
+// releasing all allocated memory.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a tree node (initially the root)
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::DestroyNodes(CMerkleNode<NodeType>  *nodePtr)
+{
+    if(nodePtr == NULL)
+    {
+        return;
+    }
+
+    DestroyNodes(nodePtr->m_left);
+    DestroyNodes(nodePtr->m_right);
+    delete nodePtr;
+
+}  // end of "CMerkleBSTree<NodeType>::DestroyNodes"
+
+
+
+// ==== CMerkleBSTree::Diff ===================================================
+//
+// This function reports every item that is in only one of this tree and the
+// other tree, by calling CMerkleBSTree::DiffNodes on the two roots.  Within
+// each tree the items are reported in ascending order.
+//
+// Access: public
+//
+// Input:
+//      other [IN]          -- the tree to compare with
+//
+//      fOnlyHere [IN]      -- called with each item that is in this tree but
+//                             not in the other (may be NULL)
+//
+//      fOnlyThere [IN]     -- called with each item that is in the other tree
+//                             but not in this one (may be NULL)
+//
+// Output:
+//      The number of items reported.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+size_t  CMerkleBSTree<NodeType>::Diff(const CMerkleBSTree<NodeType>  &other
+                                , void (*fOnlyHere)(const NodeType&)
+                                , void (*fOnlyThere)(const NodeType&)) const
+{
+    size_t  numDiffs = 0;
+
+    DiffNodes(m_root, other.m_root, NULL, NULL, fOnlyHere, fOnlyThere
+                                                                , numDiffs);
+    return numDiffs;
+
+}  // end of "CMerkleBSTree<NodeType>::Diff"
+
+
+
+// ==== CMerkleBSTree::DiffNodes ==============================================
+//
+// This recursive function reports the items strictly between lo and hi that
+// are in only one of two subtrees; both subtrees must hold every item of
+// their tree that lies in that range.  Each subtree is first narrowed to its
+// topmost node inside the range, which has the highest priority of the items
+// there.  If the two subtrees hash equally they hold the same items, and
+// nothing below them is visited.  If the two top nodes hold the same value,
+// the left and right sides are compared separately.  Otherwise the node that
+// outranks the other cannot be in the other tree at all (it would have been
+// on top there too), so it is reported and the range is split at its value.
+//
+// Access: protected
+//
+// Input:
+//      herePtr [IN]        -- a subtree of this tree
+//
+//      therePtr [IN]       -- a subtree of the other tree
+//
+//      lo [IN]             -- the exclusive lower bound, or NULL for none
+//
+//      hi [IN]             -- the exclusive upper bound, or NULL for none
+//
+//      fOnlyHere [IN]      -- called with each item only in this tree
+//
+//      fOnlyThere [IN]     -- called with each item only in the other tree
+//
+//      numDiffs [IN/OUT]   -- incremented for each item reported
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::DiffNodes(
+                                    const CMerkleNode<NodeType>  *herePtr
+                                    , const CMerkleNode<NodeType>  *therePtr
+                                    , const NodeType  *lo
+                                    , const NodeType  *hi
+                                    , void (*fOnlyHere)(const NodeType&)
+                                    , void (*fOnlyThere)(const NodeType&)
+                                    , size_t  &numDiffs) const
+{
+    herePtr = Narrow(herePtr, lo, hi);
+    therePtr = Narrow(therePtr, lo, hi);
+    if(herePtr == NULL || therePtr == NULL)
+    {
+        ReportRange(herePtr, lo, hi, fOnlyHere, numDiffs);
+        ReportRange(therePtr, lo, hi, fOnlyThere, numDiffs);
+        return;
+    }
+    if(herePtr->m_hash == therePtr->m_hash)
+    {
+        return;
+    }
+
+    if(ThreeWayCompare(herePtr->m_value, therePtr->m_value) == 0)
+    {
+        DiffNodes(herePtr->m_left, therePtr->m_left, lo, &herePtr->m_value
+                                    , fOnlyHere, fOnlyThere, numDiffs);
+        DiffNodes(herePtr->m_right, therePtr->m_right, &herePtr->m_value, hi
+                                    , fOnlyHere, fOnlyThere, numDiffs);
+    }
+    else if(HigherPriority(herePtr, therePtr))
+    {
+        DiffNodes(herePtr->m_left, therePtr, lo, &herePtr->m_value
+                                    , fOnlyHere, fOnlyThere, numDiffs);
+        if(fOnlyHere != NULL)
+        {
+            fOnlyHere(herePtr->m_value);
+        }
+        ++numDiffs;
+        DiffNodes(herePtr->m_right, therePtr, &herePtr->m_value, hi
+                                    , fOnlyHere, fOnlyThere, numDiffs);
+    }
+    else
+    {
+        DiffNodes(herePtr, therePtr->m_left, lo, &therePtr->m_value
+                                    , fOnlyHere, fOnlyThere, numDiffs);
+        if(fOnlyThere != NULL)
+        {
+            fOnlyThere(therePtr->m_value);
+        }
+        ++numDiffs;
+        DiffNodes(herePtr, therePtr->m_right, &therePtr->m_value, hi
+                                    , fOnlyHere, fOnlyThere, numDiffs);
+    }
+
+}  // end of "CMerkleBSTree<NodeType>::DiffNodes"
+
+
+
+// ==== CMerkleBSTree::GetTreeInfo ============================================
+//
+// This function allows the caller to get the current number of items and the
+// height of the tree.  The item count is kept up to date by the insert and
+// delete functions; the height is found by CMerkleBSTree::Height.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- a reference to an int that will contain the total
+//                         number of items currently in the tree (or INT_MAX
+//                         if there are more than an int can hold)
+//
+//      height [OUT]    -- a reference to an int that will contain the height
+//                         of the tree; this is a zero-based value that
+//                         represents the longest path from the root to a
+//                         leaf (counting edges, not the nodes)
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::GetTreeInfo(int  &numNodes
+                                                , int  &height) const
+{
+    numNodes = (m_numNodes > static_cast<size_t>(INT_MAX)) ? INT_MAX
+                                        : static_cast<int>(m_numNodes);
+    height = Height(m_root);
+    if(height < 0)
+    {
+        height = 0;
+    }
+
+}  // end of "CMerkleBSTree<NodeType>::GetTreeInfo"
+
+
+
+// ==== CMerkleBSTree::HashValue ==============================================
+//
+// This function hashes a value with std::hash and mixes the result, since
+// std::hash is the identity for integers on common libraries.
+//
+// Access: protected
+//
+// Input:
+//      value [IN]      -- the value to hash
+//
+// Output:
+//      The 64-bit hash of the value.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint64_t    CMerkleBSTree<NodeType>::HashValue(const NodeType  &value)
+{
+    return Mix(static_cast<uint64_t>(hash<NodeType>()(value)));
+
+}  // end of "CMerkleBSTree<NodeType>::HashValue"
+
+
+
+// ==== CMerkleBSTree::Height =================================================
+//
+// This recursive function finds the height of the subtree rooted at nodePtr,
+// counting edges; an empty subtree has a height of negative one.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+// Output:
+//      The height of the subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+int     CMerkleBSTree<NodeType>::Height(const CMerkleNode<NodeType>  *nodePtr)
+                                                                        const
+{
+    if(nodePtr == NULL)
+    {
+        return -1;
+    }
+
+    int left = Height(nodePtr->m_left);
+    int right = Height(nodePtr->m_right);
+
+    return ((left > right) ? left : right) + 1;
+
+}  // end of "CMerkleBSTree<NodeType>::Height"
+
+
+
+// ==== CMerkleBSTree::HigherPriority =========================================
+//
+// This function decides which of two nodes belongs nearer the root.  Ties in
+// priority are broken by value, so the order is total and the shape of the
+// tree is fully determined by its items.
+//
+// Access: protected
+//
+// Input:
+//      lhs [IN]        -- a pointer to one node
+//
+//      rhs [IN]        -- a pointer to another node, with a different value
+//
+// Output:
+//      A value of true if lhs outranks rhs, false if not.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CMerkleBSTree<NodeType>::HigherPriority(
+                                        const CMerkleNode<NodeType>  *lhs
+                                        , const CMerkleNode<NodeType>  *rhs)
+{
+    uint64_t    lhsPriority = Priority(lhs);
+    uint64_t    rhsPriority = Priority(rhs);
+
+    if(lhsPriority != rhsPriority)
+    {
+        return (lhsPriority > rhsPriority);
+    }
+    return (ThreeWayCompare(lhs->m_value, rhs->m_value) < 0);
+
+}  // end of "CMerkleBSTree<NodeType>::HigherPriority"
+
+
+
+// ==== CMerkleBSTree::InOrder ================================================
+//
+// This function performs an inorder traversal of the tree, calling the
+// function pointed to by fPtr for each value.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a tree node (initially the root)
+//
+//      fPtr [IN]       -- a pointer to a function that takes a const
+//                         reference to a NodeType object
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::InOrder(const CMerkleNode<NodeType>  *nodePtr
+                                    , void (*fPtr)(const NodeType&)) const
+{
+    if(nodePtr != NULL)
+    {
+        InOrder(nodePtr->m_left, fPtr);
+        fPtr(nodePtr->m_value);
+        InOrder(nodePtr->m_right, fPtr);
+    }
+
+}  // end of "CMerkleBSTree<NodeType>::InOrder"
+
+
+
+// ==== CMerkleBSTree::InOrderTraverse ========================================
+//
+// This function calls CMerkleBSTree::InOrder to perform an inorder traversal.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to a function that takes a const
+//                         reference to a NodeType object
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::InOrderTraverse(
+                                    void  (*fPtr)(const NodeType&)) const
+{
+    InOrder(m_root, fPtr);
+
+}  // end of "CMerkleBSTree<NodeType>::InOrderTraverse"
+
+
+
+// ==== CMerkleBSTree::Insert =================================================
+//
+// This recursive function inserts a new item as a leaf of the subtree rooted
+// at nodePtr, then rotates it up past every ancestor it outranks on the way
+// back, recomputing the hashes of the nodes on the path.
+//
+// Access: protected
+//
+// Input:
+//      newItem [IN]        -- a const reference to the item to insert
+//
+//      valueHash [IN]      -- the hash of newItem
+//
+//      nodePtr [IN]        -- a pointer to the root of the subtree
+//
+//      bInserted [OUT]     -- set to true if the item was inserted, false if
+//                             it was already in the tree
+//
+// Output:
+//      A pointer to the (potentially new) root of the subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleNode<NodeType>*  CMerkleBSTree<NodeType>::Insert(
+                                        const NodeType  &newItem
+                                        , uint64_t  valueHash
+                                        , CMerkleNode<NodeType>  *nodePtr
+                                        , bool  &bInserted)
+{
+    if(nodePtr == NULL)
+    {
+        nodePtr = new CMerkleNode<NodeType>(newItem, valueHash);
+        UpdateHash(nodePtr);
+        bInserted = true;
+        return nodePtr;
+    }
+
+    int result = ThreeWayCompare(newItem, nodePtr->m_value);
+    if(result < 0)
+    {
+        nodePtr->m_left = Insert(newItem, valueHash, nodePtr->m_left
+                                                                , bInserted);
+        if(bInserted && HigherPriority(nodePtr->m_left, nodePtr))
+        {
+            nodePtr = RotateRight(nodePtr);
+        }
+    }
+    else if(result > 0)
+    {
+        nodePtr->m_right = Insert(newItem, valueHash, nodePtr->m_right
+                                                                , bInserted);
+        if(bInserted && HigherPriority(nodePtr->m_right, nodePtr))
+        {
+            nodePtr = RotateLeft(nodePtr);
+        }
+    }
+    else
+    {
+        bInserted = false;
+        return nodePtr;
+    }
+
+    if(bInserted)
+    {
+        UpdateHash(nodePtr);
+    }
+    return nodePtr;
+
+}  // end of "CMerkleBSTree<NodeType>::Insert"
+
+
+
+// ==== CMerkleBSTree::InsertItem =============================================
+//
+// This function inserts an item into the tree if it is not already there.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- a const reference to the item to insert
+//
+// Output:
+//      A value of true if the item was inserted, false if it was already in
+//      the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CMerkleBSTree<NodeType>::InsertItem(const NodeType  &newItem)
+{
+    bool    bInserted = false;
+
+    m_root = Insert(newItem, HashValue(newItem), m_root, bInserted);
+    if(bInserted)
+    {
+        ++m_numNodes;
+    }
+    return bInserted;
+
+}  // end of "CMerkleBSTree<NodeType>::InsertItem"
+
+
+
+// ==== CMerkleBSTree::ItemInTree =============================================
+//
+// This function determines if a target item is in the tree.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object that contains
+//                         the target key value to search for
+//
+// Output:
+//      A value of true if the target item is found, false if not.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+bool    CMerkleBSTree<NodeType>::ItemInTree(const NodeType  &target) const
+{
+    const CMerkleNode<NodeType> *nodePtr = m_root;
+
+    while(nodePtr != NULL)
+    {
+        int result = ThreeWayCompare(target, nodePtr->m_value);
+        if(result == 0)
+        {
+            return true;
+        }
+        nodePtr = (result < 0) ? nodePtr->m_left : nodePtr->m_right;
+    }
+    return false;
+
+}  // end of "CMerkleBSTree<NodeType>::ItemInTree"
+
+
+
+// ==== CMerkleBSTree::Join ===================================================
+//
+// This recursive function joins two subtrees, every item of the first
+// ordering before every item of the second, into one.  The root that
+// outranks the other stays on top, and the rest is joined below it, so the
+// priorities stay heap-ordered.  The hashes are recomputed on the way back.
+//
+// Access: protected
+//
+// Input:
+//      leftTree [IN]   -- the root of the subtree with the smaller items
+//
+//      rightTree [IN]  -- the root of the subtree with the larger items
+//
+// Output:
+//      A pointer to the root of the joined subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleNode<NodeType>*  CMerkleBSTree<NodeType>::Join(
+                                        CMerkleNode<NodeType>  *leftTree
+                                        , CMerkleNode<NodeType>  *rightTree)
+{
+    if(leftTree == NULL || rightTree == NULL)
+    {
+        return (leftTree != NULL) ? leftTree : rightTree;
+    }
+
+    if(HigherPriority(leftTree, rightTree))
+    {
+        leftTree->m_right = Join(leftTree->m_right, rightTree);
+        UpdateHash(leftTree);
+        return leftTree;
+    }
+
+    rightTree->m_left = Join(leftTree, rightTree->m_left);
+    UpdateHash(rightTree);
+    return rightTree;
+
+}  // end of "CMerkleBSTree<NodeType>::Join"
+
+
+
+// ==== CMerkleBSTree::Mix ====================================================
+//
+// This function scrambles the bits of a 64-bit value (the finalizer of the
+// SplitMix64 generator), so that values differing in one bit give unrelated
+// results.
+//
+// Access: protected
+//
+// Input:
+//      bits [IN]       -- the value to scramble
+//
+// Output:
+//      The scrambled value.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint64_t    CMerkleBSTree<NodeType>::Mix(uint64_t  bits)
+{
+    bits ^= bits >> 30;
+    bits *= 0xBF58476D1CE4E5B9ull;
+    bits ^= bits >> 27;
+    bits *= 0x94D049BB133111EBull;
+    bits ^= bits >> 31;
+    return bits;
+
+}  // end of "CMerkleBSTree<NodeType>::Mix"
+
+
+
+// ==== CMerkleBSTree::Narrow =================================================
+//
+// This function walks down from a node to the first node whose value lies
+// strictly between lo and hi.  That node is the ancestor of every node of
+// the subtree inside the range, and so the one with the highest priority.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+//      lo [IN]         -- the exclusive lower bound, or NULL for none
+//
+//      hi [IN]         -- the exclusive upper bound, or NULL for none
+//
+// Output:
+//      A pointer to that node, or NULL if no node of the subtree is inside
+//      the range.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+const CMerkleNode<NodeType>*    CMerkleBSTree<NodeType>::Narrow(
+                                        const CMerkleNode<NodeType>  *nodePtr
+                                        , const NodeType  *lo
+                                        , const NodeType  *hi)
+{
+    while(nodePtr != NULL)
+    {
+        if(lo != NULL && ThreeWayCompare(nodePtr->m_value, *lo) <= 0)
+        {
+            nodePtr = nodePtr->m_right;
+        }
+        else if(hi != NULL && ThreeWayCompare(nodePtr->m_value, *hi) >= 0)
+        {
+            nodePtr = nodePtr->m_left;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return nodePtr;
+
+}  // end of "CMerkleBSTree<NodeType>::Narrow"
+
+
+
+// ==== CMerkleBSTree::Priority ===============================================
+//
+// This function returns a node's priority, derived from the hash of its
+// value; a node outranks every node below it.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the node
+//
+// Output:
+//      The node's priority.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+uint64_t    CMerkleBSTree<NodeType>::Priority(
+                                        const CMerkleNode<NodeType>  *nodePtr)
+{
+    return Mix(nodePtr->m_valueHash ^ PRIORITY_SEED);
+
+}  // end of "CMerkleBSTree<NodeType>::Priority"
+
+
+
+// ==== CMerkleBSTree::ReportRange ============================================
+//
+// This recursive function calls fPtr, in order, with each value of a subtree
+// that lies strictly between lo and hi, skipping the parts of the subtree
+// that lie outside the range.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]        -- a pointer to the root of the subtree
+//
+//      lo [IN]             -- the exclusive lower bound, or NULL for none
+//
+//      hi [IN]             -- the exclusive upper bound, or NULL for none
+//
+//      fPtr [IN]           -- the function to call (may be NULL)
+//
+//      numDiffs [IN/OUT]   -- incremented for each value reported
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::ReportRange(
+                                        const CMerkleNode<NodeType>  *nodePtr
+                                        , const NodeType  *lo
+                                        , const NodeType  *hi
+                                        , void (*fPtr)(const NodeType&)
+                                        , size_t  &numDiffs)
+{
+    nodePtr = Narrow(nodePtr, lo, hi);
+    if(nodePtr == NULL)
+    {
+        return;
+    }
+
+    ReportRange(nodePtr->m_left, lo, &nodePtr->m_value, fPtr, numDiffs);
+    if(fPtr != NULL)
+    {
+        fPtr(nodePtr->m_value);
+    }
+    ++numDiffs;
+    ReportRange(nodePtr->m_right, &nodePtr->m_value, hi, fPtr, numDiffs);
+
+}  // end of "CMerkleBSTree<NodeType>::ReportRange"
+
+
+
+// ==== CMerkleBSTree::RotateLeft =============================================
+//
+// This function rotates a node's right child up into its place and
+// recomputes the hash of the node, which is now the child's left child.  The
+// caller recomputes the hash of the new subtree root.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a node that has a right child
+//
+// Output:
+//      A pointer to the new root of the subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleNode<NodeType>*  CMerkleBSTree<NodeType>::RotateLeft(
+                                        CMerkleNode<NodeType>  *nodePtr)
+{
+    CMerkleNode<NodeType>   *child = nodePtr->m_right;
+
+    nodePtr->m_right = child->m_left;
+    child->m_left = nodePtr;
+    UpdateHash(nodePtr);
+    return child;
+
+}  // end of "CMerkleBSTree<NodeType>::RotateLeft"
+
+
+
+// ==== CMerkleBSTree::RotateRight ============================================
+//
+// This function rotates a node's left child up into its place and
+// recomputes the hash of the node, which is now the child's right child.  The
+// caller recomputes the hash of the new subtree root.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to a node that has a left child
+//
+// Output:
+//      A pointer to the new root of the subtree.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleNode<NodeType>*  CMerkleBSTree<NodeType>::RotateRight(
+                                        CMerkleNode<NodeType>  *nodePtr)
+{
+    CMerkleNode<NodeType>   *child = nodePtr->m_left;
+
+    nodePtr->m_left = child->m_right;
+    child->m_right = nodePtr;
+    UpdateHash(nodePtr);
+    return child;
+
+}  // end of "CMerkleBSTree<NodeType>::RotateRight"
+
+
+
+// ==== CMerkleBSTree::UpdateHash =============================================
+//
+// This function recomputes a node's subtree hash from its value's hash and
+// its children's subtree hashes, which must already be up to date.  A
+// missing child counts as EMPTY_HASH, so that a subtree holding a value
+// which happens to hash to zero never looks like an empty one.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN/OUT]    -- a pointer to the node
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType>
+void    CMerkleBSTree<NodeType>::UpdateHash(CMerkleNode<NodeType>  *nodePtr)
+{
+    nodePtr->m_hash = CombineHashes(
+                        (nodePtr->m_left != NULL) ? nodePtr->m_left->m_hash
+                                                  : EMPTY_HASH
+                        , nodePtr->m_valueHash
+                        , (nodePtr->m_right != NULL) ? nodePtr->m_right->m_hash
+                                                     : EMPTY_HASH);
+
+}  // end of "CMerkleBSTree<NodeType>::UpdateHash"
+
+
+
+// ==== CMerkleBSTree::operator= ==============================================
+//
+// This is the overloaded assignment operator for the CMerkleBSTree class. It
+// first checks for assignment to self, then releases all of the nodes in the
+// calling object and replicates the parameter's tree with CopyTree.
+//
+// Access: public
+//
+// Input:
+//      rhs [IN]    -- a const reference to an existing CMerkleBSTree object
+//
+// Output:
+//      A reference to the calling object.
+//
+// ============================================================================
+
+template    <typename  NodeType>
+CMerkleBSTree<NodeType>&  CMerkleBSTree<NodeType>::operator=(
+                                    const CMerkleBSTree<NodeType>  &rhs)
+{
+    if(this != &rhs)
+    {
+        DestroyTree();
+        m_root = CopyTree(rhs.m_root);
+        m_numNodes = rhs.m_numNodes;
+    }
+    return *this;
+
+}  // end of "CMerkleBSTree<NodeType>::operator="
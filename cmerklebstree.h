@@ -0,0 +1,142 @@
+// ============================================================================
+// File: cmerklebstree.h
+// ============================================================================
+// This header file contains the declaration of the CMerkleBSTree class. It
+// uses the template parameter "NodeType" for the type of values that are
+// stored in the tree; values are ordered with ThreeWayCompare (see
+// ccompare.h) and hashed with std::hash, and values that compare equal must
+// hash equally.
+//
+// Every node keeps a hash of its subtree, computed from its own value and the
+// hashes of its two children, so the root hash summarizes the whole tree.
+// InsertItem and DeleteItem recompute the hashes along the path they change.
+//
+// For two trees holding the same items to have the same hashes they must also
+// have the same shape, whatever order the items arrived in.  The tree is
+// therefore a treap whose priorities are not random but derived from the
+// hash of each value: for a given set of items there is exactly one tree that
+// is ordered by value and heap-ordered by priority, so the shape depends only
+// on the set.  The expected height is O(log n), as for a random treap, for
+// any set of values that std::hash spreads well.  BuildFromSorted builds that
+// same shape from a sorted array in O(n).
+//
+// Two trees hold the same items (up to a hash collision) when their sizes and
+// root hashes match, which operator== checks in O(1).  Diff reports the items
+// held by only one of two trees.  It walks both trees together and skips
+// every pair of subtrees whose hashes match, so its cost grows with the
+// number of differences, O(d log n) expected, rather than with the size of
+// the trees.  The hashes are not cryptographic: they detect divergence
+// between replicas, not deliberate tampering.
+// ============================================================================
+
+#ifndef CMERKLE_BIN_SEARCH_TREE_HEADER
+#define CMERKLE_BIN_SEARCH_TREE_HEADER
+
+#include    <cstdint>
+#include    <functional>
+#include    <vector>
+using namespace std;
+#include    "cmerklenode.h"
+#include    "ccompare.h"
+
+// class declaration
+template    <typename  NodeType>
+class   CMerkleBSTree
+{
+public:
+    // constructors and destructor
+    CMerkleBSTree() : m_root(NULL), m_numNodes(0) {}
+    CMerkleBSTree(const CMerkleBSTree  &other);
+    virtual ~CMerkleBSTree() { DestroyTree(); }
+
+    // member functions
+    void    BuildFromSorted(const NodeType  array[], size_t  count);
+    bool    DeleteItem(const NodeType  &target);
+    void    DestroyTree() { DestroyNodes(m_root); m_root = NULL;
+                                                    m_numNodes = 0; }
+    size_t  Diff(const CMerkleBSTree<NodeType>  &other
+                                , void (*fOnlyHere)(const NodeType&)
+                                , void (*fOnlyThere)(const NodeType&)) const;
+    size_t  GetNumItems() const { return m_numNodes; }
+    uint64_t    GetRootHash() const { return (NULL == m_root) ? EMPTY_HASH
+                                                        : m_root->m_hash; }
+    void    GetTreeInfo(int  &numNodes, int  &height) const;
+    void    InOrderTraverse(void  (*fPtr)(const NodeType&)) const;
+    bool    InsertItem(const NodeType  &newItem);
+    bool    IsTreeEmpty() const { return (NULL == m_root); }
+    bool    ItemInTree(const NodeType  &target) const;
+
+    // operators
+    CMerkleBSTree<NodeType>&    operator=(const CMerkleBSTree<NodeType> &rhs);
+    bool    operator==(const CMerkleBSTree<NodeType>  &rhs) const
+                                { return (m_numNodes == rhs.m_numNodes
+                                    && GetRootHash() == rhs.GetRootHash()); }
+    bool    operator!=(const CMerkleBSTree<NodeType>  &rhs) const
+                                { return !(*this == rhs); }
+
+protected:
+    // mixed into a value's hash to give its priority, so that the priority
+    // and the hash that goes into the subtree hashes are independent
+    static const uint64_t   PRIORITY_SEED = 0x5BD1E9955BD1E995ull;
+
+    // the hash of an empty subtree; it must not be zero, since Mix(0) is
+    // zero and a leaf whose value hashes to zero (std::hash gives 0 for the
+    // integer 0) would then hash the same as no subtree at all
+    static const uint64_t   EMPTY_HASH = 0x2545F4914F6CDD1Dull;
+
+    // member functions
+    static uint64_t         CombineHashes(uint64_t  leftHash
+                                        , uint64_t  valueHash
+                                        , uint64_t  rightHash);
+    CMerkleNode<NodeType>*  Delete(const NodeType  &target
+                                        , CMerkleNode<NodeType>  *nodePtr
+                                        , bool  &bItemDeleted);
+    void                    DestroyNodes(CMerkleNode<NodeType>  *nodePtr);
+    void                    DiffNodes(const CMerkleNode<NodeType>  *herePtr
+                                        , const CMerkleNode<NodeType> *therePtr
+                                        , const NodeType  *lo
+                                        , const NodeType  *hi
+                                        , void (*fOnlyHere)(const NodeType&)
+                                        , void (*fOnlyThere)(const NodeType&)
+                                        , size_t  &numDiffs) const;
+    static uint64_t         HashValue(const NodeType  &value);
+    int                     Height(const CMerkleNode<NodeType>  *nodePtr)
+                                                                    const;
+    static bool             HigherPriority(const CMerkleNode<NodeType>  *lhs
+                                        , const CMerkleNode<NodeType>  *rhs);
+    void                    InOrder(const CMerkleNode<NodeType>  *nodePtr
+                                        , void (*fPtr)(const NodeType&)) const;
+    CMerkleNode<NodeType>*  Insert(const NodeType  &newItem
+                                        , uint64_t  valueHash
+                                        , CMerkleNode<NodeType>  *nodePtr
+                                        , bool  &bInserted);
+    CMerkleNode<NodeType>*  Join(CMerkleNode<NodeType>  *leftTree
+                                        , CMerkleNode<NodeType>  *rightTree);
+    static uint64_t         Mix(uint64_t  bits);
+    static const CMerkleNode<NodeType>* Narrow(
+                                        const CMerkleNode<NodeType>  *nodePtr
+                                        , const NodeType  *lo
+                                        , const NodeType  *hi);
+    static uint64_t         Priority(const CMerkleNode<NodeType>  *nodePtr);
+    static void             ReportRange(const CMerkleNode<NodeType>  *nodePtr
+                                        , const NodeType  *lo
+                                        , const NodeType  *hi
+                                        , void (*fPtr)(const NodeType&)
+                                        , size_t  &numDiffs);
+    static CMerkleNode<NodeType>*   RotateLeft(
+                                        CMerkleNode<NodeType>  *nodePtr);
+    static CMerkleNode<NodeType>*   RotateRight(
+                                        CMerkleNode<NodeType>  *nodePtr);
+    static void             UpdateHash(CMerkleNode<NodeType>  *nodePtr);
+
+private:
+    // member functions
+    CMerkleNode<NodeType>*  CopyTree(const CMerkleNode<NodeType>  *sourcePtr);
+
+    // data members
+    CMerkleNode<NodeType>   *m_root;
+    size_t                  m_numNodes;
+};
+
+#include    "cmerklebstree.cpp"
+#endif  // CMERKLE_BIN_SEARCH_TREE_HEADER
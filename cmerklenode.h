@@ -0,0 +1,35 @@
+// ============================================================================
+// File: cmerklenode.h
+// ============================================================================
+// This file contains the definition of the CMerkleNode class, the node type of
+// a CMerkleBSTree.  It uses the "NodeValueType" template parameter to store a
+// copy of a value.  Along with the value and the child links, a node keeps
+// the hash of its own value and the hash of its whole subtree, which the
+// tree recomputes whenever the subtree changes.
+// ============================================================================
+
+#ifndef CMERKLE_NODE_HEADER
+#define CMERKLE_NODE_HEADER
+
+#include    <cstddef>
+#include    <cstdint>
+
+template    <typename  NodeValueType>
+class   CMerkleNode
+{
+public:
+    // constructor
+    CMerkleNode(const NodeValueType  &newValue, uint64_t  valueHash)
+                                    : m_value(newValue), m_left(NULL)
+                                    , m_right(NULL), m_valueHash(valueHash)
+                                    , m_hash(0) {}
+
+    // data members
+    NodeValueType       m_value;
+    CMerkleNode         *m_left;
+    CMerkleNode         *m_right;
+    uint64_t            m_valueHash;
+    uint64_t            m_hash;
+};
+
+#endif  // CMERKLE_NODE_HEADER
@@ -0,0 +1,237 @@
+// ============================================================================
+// File: cnodereclaimer.cpp
+// ============================================================================
+// This file contains the implementation of the CNodeReclaimer class. It uses
+// the template parameter "NodeType" for the type of values held by the nodes
+// it frees.
+// ============================================================================
+
+#include    "cnodereclaimer.h"
+
+
+// ==== CNodeReclaimer::CNodeReclaimer ========================================
+//
+// This is the constructor for the CNodeReclaimer class.  It starts the worker
+// thread and detaches it, since the reclaimer lives until the process ends.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+CNodeReclaimer<NodeType, TreeNode>::CNodeReclaimer() : m_bBusy(false)
+{
+    thread  worker(&CNodeReclaimer<NodeType, TreeNode>::Run, this);
+    worker.detach();
+
+}  // end of "CNodeReclaimer<NodeType>::CNodeReclaimer"
+
+
+
+// ==== CNodeReclaimer::FreeNodes =============================================
+//
+// This function frees every node of a tree without recursion.  While the
+// current node has a left child, that child is rotated up in its place;
+// once it has none, the node is freed and its right child becomes current.
+// Each rotation moves a node off the left spine for good, so the whole tree
+// is freed in O(n) with no stack at all.  Nodes inside the block are only
+// destroyed, and the block is freed at the end.
+//
+// Access: public
+//
+// Input:
+//      rootPtr [IN]    -- the root of the tree to free (may be NULL)
+//
+//      arena [IN]      -- the block holding some of the nodes, or NULL
+//
+//      arenaSize [IN]  -- the number of node slots in the block
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+void    CNodeReclaimer<NodeType, TreeNode>::FreeNodes(TreeNode  *rootPtr
+                                            , TreeNode  *arena
+                                            , size_t  arenaSize)
+{
+    TreeNode *childPtr;
+
+    while(rootPtr != NULL)
+    {
+        childPtr = rootPtr->m_left;
+        if(childPtr != NULL)
+        {
+            rootPtr->m_left = childPtr->m_right;
+            childPtr->m_right = rootPtr;
+        }
+        else
+        {
+            childPtr = rootPtr->m_right;
+            if(arena != NULL && rootPtr >= arena
+                                        && rootPtr < arena + arenaSize)
+            {
+                rootPtr->~TreeNode();
+            }
+            else
+            {
+                delete rootPtr;
+            }
+        }
+        rootPtr = childPtr;
+    }
+
+    if(arena != NULL)
+    {
+        allocator<TreeNode>().deallocate(arena, arenaSize);
+    }
+
+}  // end of "CNodeReclaimer<NodeType>::FreeNodes"
+
+
+
+// ==== CNodeReclaimer::GetInstance ===========================================
+//
+// This function returns the reclaimer for NodeType, creating it (and so
+// starting its thread) the first time it is called.  The reclaimer is
+// allocated and never deleted; see the comment in cnodereclaimer.h.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A reference to the reclaimer.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+CNodeReclaimer<NodeType, TreeNode>&
+                            CNodeReclaimer<NodeType, TreeNode>::GetInstance()
+{
+    static CNodeReclaimer   *instance = new CNodeReclaimer();
+
+    return *instance;
+
+}  // end of "CNodeReclaimer<NodeType>::GetInstance"
+
+
+
+// ==== CNodeReclaimer::Release ===============================================
+//
+// This function hands a detached tree over to the worker thread to be freed.
+// The caller must not touch any of its nodes, or the block, afterwards.
+//
+// Access: public
+//
+// Input:
+//      rootPtr [IN]    -- the root of the tree to free (may be NULL)
+//
+//      arena [IN]      -- the block holding some of the nodes, or NULL
+//
+//      arenaSize [IN]  -- the number of node slots in the block
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+void    CNodeReclaimer<NodeType, TreeNode>::Release(TreeNode  *rootPtr
+                                            , TreeNode  *arena
+                                            , size_t  arenaSize)
+{
+    CPendingTree    tree = { rootPtr, arena, arenaSize };
+
+    if(rootPtr == NULL && arena == NULL)
+    {
+        return;
+    }
+
+    {
+        lock_guard<mutex>   lock(m_mutex);
+        m_pending.push_back(tree);
+    }
+    m_wakeCond.notify_one();
+
+}  // end of "CNodeReclaimer<NodeType>::Release"
+
+
+
+// ==== CNodeReclaimer::Run ===================================================
+//
+// This function is the body of the worker thread.  It sleeps until trees are
+// handed over, takes all of them at once and frees them outside the lock, so
+// Release never waits behind a free in progress.  Whenever it runs out of
+// work it wakes the callers of WaitForIdle.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+void    CNodeReclaimer<NodeType, TreeNode>::Run()
+{
+    vector<CPendingTree>    batch;
+    unique_lock<mutex>      lock(m_mutex);
+
+    for(;;)
+    {
+        m_wakeCond.wait(lock, [this] { return !m_pending.empty(); });
+        batch.swap(m_pending);
+        m_bBusy = true;
+        lock.unlock();
+
+        for(size_t i = 0; i < batch.size(); ++i)
+        {
+            FreeNodes(batch[i].m_root, batch[i].m_arena
+                                                , batch[i].m_arenaSize);
+        }
+        batch.clear();
+
+        lock.lock();
+        m_bBusy = false;
+        if(m_pending.empty())
+        {
+            m_idleCond.notify_all();
+        }
+    }
+
+}  // end of "CNodeReclaimer<NodeType>::Run"
+
+
+
+// ==== CNodeReclaimer::WaitForIdle ===========================================
+//
+// This function blocks until every tree handed to Release so far has been
+// freed.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  TreeNode>
+void    CNodeReclaimer<NodeType, TreeNode>::WaitForIdle()
+{
+    unique_lock<mutex>  lock(m_mutex);
+
+    m_idleCond.wait(lock, [this] { return m_pending.empty() && !m_bBusy; });
+
+}  // end of "CNodeReclaimer<NodeType>::WaitForIdle"
@@ -0,0 +1,81 @@
+// ============================================================================
+// File: cnodereclaimer.h
+// ============================================================================
+// This header file contains the declaration of the CNodeReclaimer class. It
+// uses the template parameter "NodeType" for the type of values held by the
+// nodes it frees, and "TreeNode" for the type of those nodes (a CTreeNode
+// unless the tree stores tombstones; see CTreeFeatures in cbstreepolicy.h).
+//
+// A reclaimer owns one background thread that frees detached trees of nodes,
+// so that the thread which detached them does not have to wait.  Release
+// hands over the root of a tree in O(1); the worker picks it up and frees
+// the tree with CNodeReclaimer::FreeNodes, which rotates each left child up
+// instead of recursing, so it needs no stack however deep the tree is.
+// WaitForIdle blocks until every tree handed over so far has been freed.
+// A tree whose nodes were laid out in one block (see CBSTree::CompactLayout)
+// is handed over along with the block: the nodes in it are destroyed in
+// place, and then the block itself is freed.
+//
+// There is one reclaimer per node type, reached with GetInstance and started
+// the first time it is used.  It is never destroyed, so a tree that is itself
+// destroyed while the program exits can still hand its nodes over; trees
+// still waiting when the program ends are simply dropped with the process.
+// The values' destructors run on the worker thread.
+// ============================================================================
+
+#ifndef CNODE_RECLAIMER_HEADER
+#define CNODE_RECLAIMER_HEADER
+
+#include    <condition_variable>
+#include    <memory>
+#include    <mutex>
+#include    <thread>
+#include    <vector>
+using namespace std;
+#include    "ctreenode.h"
+
+// class declaration
+template    <typename  NodeType, typename  TreeNode = CTreeNode<NodeType> >
+class   CNodeReclaimer
+{
+public:
+    // member functions
+    static void             FreeNodes(TreeNode  *rootPtr
+                                        , TreeNode  *arena = NULL
+                                        , size_t  arenaSize = 0);
+    static CNodeReclaimer&  GetInstance();
+    void                    Release(TreeNode  *rootPtr
+                                        , TreeNode  *arena = NULL
+                                        , size_t  arenaSize = 0);
+    void                    WaitForIdle();
+
+    // the reclaimer is shared, so it cannot be copied
+    CNodeReclaimer(const CNodeReclaimer  &other) = delete;
+    CNodeReclaimer&  operator=(const CNodeReclaimer  &rhs) = delete;
+
+protected:
+    // one tree waiting to be freed, with the block its nodes live in (NULL
+    // if every node came from the heap)
+    struct  CPendingTree
+    {
+        TreeNode    *m_root;
+        TreeNode    *m_arena;
+        size_t      m_arenaSize;
+    };
+
+    // constructor (use GetInstance)
+    CNodeReclaimer();
+
+    // member functions
+    void    Run();
+
+    // data members
+    mutex                           m_mutex;
+    condition_variable              m_wakeCond;
+    condition_variable              m_idleCond;
+    vector<CPendingTree>            m_pending;
+    bool                            m_bBusy;
+};
+
+#include    "cnodereclaimer.cpp"
+#endif  // CNODE_RECLAIMER_HEADER
@@ -0,0 +1,82 @@
+// ============================================================================
+// File: cnostate.h
+// ============================================================================
+// This file contains the definitions of the CNoState and CNoVector classes.
+// They stand in for the data members of a feature that a CBSTree was built
+// without (see TreeFeature in cbstreepolicy.h), so that the tree's code can
+// name the same members whether or not the feature is there.
+//
+// A CNoState reads as a value-initialized ValueType (false, zero or NULL),
+// and assigning to it, or incrementing or decrementing it, does nothing.  A
+// CNoVector is a vector that is always empty: whatever is added to it is
+// dropped.  Its element accessors behave like those of an empty std::vector,
+// and the code that calls them only does so after finding an element there,
+// so they are never reached.
+//
+// Neither class has data, and all of their members are const, so a policy
+// holds them as static constexpr members: they take no space in the tree,
+// and every read of one is a read of a constant, which lets the compiler
+// drop the code that depends on the feature.
+// ============================================================================
+
+#ifndef CNO_STATE_HEADER
+#define CNO_STATE_HEADER
+
+#include    <cstddef>
+using namespace std;
+
+// class declaration
+template    <typename  ValueType>
+class   CNoState
+{
+public:
+    // conversion
+    constexpr operator ValueType() const { return ValueType(); }
+    ValueType   operator->() const { return ValueType(); }
+
+    // operators (all of which leave the state as it is; assigning a value
+    // yields that value, so that a chain of assignments still passes it on)
+    const CNoState&     operator=(const CNoState&) const { return *this; }
+    ValueType           operator=(const ValueType  &value) const
+                                                        { return value; }
+    const CNoState&     operator+=(const ValueType&) const { return *this; }
+    const CNoState&     operator-=(const ValueType&) const { return *this; }
+    const CNoState&     operator++() const { return *this; }
+    const CNoState&     operator--() const { return *this; }
+    ValueType           operator++(int) const { return ValueType(); }
+    ValueType           operator--(int) const { return ValueType(); }
+};
+
+// class declaration
+template    <typename  ItemType>
+class   CNoVector
+{
+public:
+    // member functions that look at the (empty) contents
+    ItemType*   begin() const { return NULL; }
+    ItemType*   data() const { return NULL; }
+    bool        empty() const { return true; }
+    ItemType*   end() const { return NULL; }
+    size_t      size() const { return 0; }
+
+    // operators (assigning leaves the vector empty)
+    const CNoVector&    operator=(const CNoVector&) const { return *this; }
+
+    // member functions that would change the contents
+    void    assign(const ItemType*, const ItemType*) const {}
+    void    clear() const {}
+    void    erase(ItemType*) const {}
+    void    erase(ItemType*, ItemType*) const {}
+    void    insert(ItemType*, const ItemType&) const {}
+    void    pop_back() const {}
+    void    push_back(const ItemType&) const {}
+    void    reserve(size_t) const {}
+    void    resize(size_t) const {}
+
+    // element access (never reached, since there are no elements)
+    ItemType&   back() const { return *data(); }
+    ItemType&   front() const { return *data(); }
+    ItemType&   operator[](size_t  index) const { return data()[index]; }
+};
+
+#endif  // CNO_STATE_HEADER
@@ -0,0 +1,1272 @@
+// ============================================================================
+// File: cpagedbplustree.cpp
+// ============================================================================
+// This file contains the implementation of the CPagedBPlusTree class. It uses
+// the template parameter "NodeType" for the type of values that are stored in
+// the tree, and the template parameter "Compare" for the function object that
+// orders them.
+// ============================================================================
+
+#include    <cstring>
+using namespace std;
+#include    "cpagedbplustree.h"
+
+// the tag at the start of a tree file
+static  const   char    PAGED_TREE_MAGIC[8] = { 'C', 'B', 'P', 'T'
+                                                , 'R', 'E', 'E', '1' };
+
+
+// ==== CPagedBPlusTree::CPagedBPlusTree ======================================
+//
+// These are the default constructor and the constructor that takes a Compare
+// object.  The tree has no file until Open is called.
+//
+// Access: public
+//
+// Input:
+//      comp [IN]   -- the Compare object that orders the values (second
+//                     constructor only)
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+CPagedBPlusTree<NodeType, Compare>::CPagedBPlusTree() : m_root(NO_PAGE)
+                            , m_numItems(0)
+                            , m_numNodes(0)
+                            , m_freeList(NO_PAGE)
+                            , m_height(0)
+                            , m_scratchKeys(2 * LEAF_CAPACITY
+                                                    * sizeof(NodeType))
+                            , m_scratchChildren(2 * INNER_CAPACITY + 2)
+{
+}  // end of "CPagedBPlusTree<NodeType>::CPagedBPlusTree"
+
+template    <typename  NodeType, typename  Compare>
+CPagedBPlusTree<NodeType, Compare>::CPagedBPlusTree(const Compare  &comp)
+                            : m_compare(comp)
+                            , m_root(NO_PAGE)
+                            , m_numItems(0)
+                            , m_numNodes(0)
+                            , m_freeList(NO_PAGE)
+                            , m_height(0)
+                            , m_scratchKeys(2 * LEAF_CAPACITY
+                                                    * sizeof(NodeType))
+                            , m_scratchChildren(2 * INNER_CAPACITY + 2)
+{
+}  // end of "CPagedBPlusTree<NodeType>::CPagedBPlusTree"
+
+
+
+// ==== CPagedBPlusTree::AllocNode ============================================
+//
+// This function creates an empty node, on a page taken from the free list if
+// there is one, and otherwise on a new page at the end of the file.
+//
+// Access: protected
+//
+// Input:
+//      bLeaf [IN]      -- true for a leaf, false for an inner node
+//
+// Output:
+//      The number of the node's page.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+uint64_t    CPagedBPlusTree<NodeType, Compare>::AllocNode(bool  bLeaf)
+{
+    uint64_t    pageNo;
+    char        *page;
+
+    if(m_freeList != NO_PAGE)
+    {
+        pageNo = m_freeList;
+        page = m_pool.FetchPage(pageNo);
+        m_freeList = NodeHeader(page)->m_next;
+        memset(page, 0, PAGE_SIZE);
+    }
+    else
+    {
+        page = m_pool.NewPage(pageNo);
+    }
+
+    NodeHeader(page)->m_bLeaf = bLeaf ? 1 : 0;
+    m_pool.UnpinPage(pageNo, true);
+    ++m_numNodes;
+    return pageNo;
+
+}  // end of "CPagedBPlusTree<NodeType>::AllocNode"
+
+
+
+// ==== CPagedBPlusTree::Children =============================================
+//
+// This function returns the array of child page numbers in an inner node.
+//
+// Access: protected
+//
+// Input:
+//      page [IN]       -- the node's page
+//
+// Output:
+//      A pointer to the first child link.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+uint64_t*   CPagedBPlusTree<NodeType, Compare>::Children(char  *page)
+{
+    return reinterpret_cast<uint64_t*>(page + sizeof(CNodeHeader));
+
+}  // end of "CPagedBPlusTree<NodeType>::Children"
+
+
+
+// ==== CPagedBPlusTree::Close ================================================
+//
+// This function writes the header and every dirty page back and closes the
+// file.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::Close()
+{
+    if(!IsOpen())
+    {
+        return;
+    }
+
+    WriteHeader();
+    m_pool.Close();
+    m_root = NO_PAGE;
+    m_numItems = 0;
+    m_numNodes = 0;
+    m_freeList = NO_PAGE;
+    m_height = 0;
+
+}  // end of "CPagedBPlusTree<NodeType>::Close"
+
+
+
+// ==== CPagedBPlusTree::Compare3 =============================================
+//
+// This function compares two values with the tree's Compare object and
+// returns the result as an int, calling it in both directions if it only
+// answers "is lhs less than rhs?" (as CBSTree::Compare3 does).
+//
+// Access: protected
+//
+// Input:
+//      lhs [IN]    -- a const reference to the left-hand value
+//
+//      rhs [IN]    -- a const reference to the right-hand value
+//
+// Output:
+//      A negative value if lhs orders before rhs, a positive value if it
+//      orders after rhs, and zero if the two are equivalent.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+int     CPagedBPlusTree<NodeType, Compare>::Compare3(const NodeType  &lhs
+                                            , const NodeType  &rhs) const
+{
+    typedef decltype(m_compare(lhs, rhs))   ResultType;
+
+    if constexpr (is_same<typename decay<ResultType>::type, bool>::value)
+    {
+        return m_compare(lhs, rhs) ? -1 : (m_compare(rhs, lhs) ? 1 : 0);
+    }
+    else
+    {
+        ResultType  result = m_compare(lhs, rhs);
+        return (result < 0) ? -1 : ((result > 0) ? 1 : 0);
+    }
+
+}  // end of "CPagedBPlusTree<NodeType>::Compare3"
+
+
+
+// ==== CPagedBPlusTree::Delete ===============================================
+//
+// This function removes a value from the subtree under a node.  In a leaf the
+// value is removed and the values after it are shifted down.  In an inner
+// node the function calls itself on the child that would hold the value, and
+// if that child is left less than half full it is repaired with
+// CPagedBPlusTree::FixChild.  Separators equal to a deleted value are left in
+// place; they still divide the values correctly.
+//
+// Access: protected
+//
+// Input:
+//      pageNo [IN]         -- the number of the node's page
+//
+//      target [IN]         -- the value to remove
+//
+//      bUnderflow [OUT]    -- set to true if the node is left less than half
+//                             full
+//
+// Output:
+//      A value of true if the value was found and removed, false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::Delete(uint64_t  pageNo
+                                                , const NodeType  &target
+                                                , bool  &bUnderflow)
+{
+    CPageHandle     page(&m_pool, pageNo);
+    CNodeHeader     *header = NodeHeader(page.GetData());
+    size_t          count = header->m_count;
+    size_t          index;
+    bool            bFound;
+    bool            bChildUnderflow;
+
+    bUnderflow = false;
+    if(header->m_bLeaf)
+    {
+        NodeType    *keys = LeafKeys(page.GetData());
+
+        index = Search(keys, count, target, bFound);
+        if(!bFound)
+        {
+            return false;
+        }
+
+        memmove(keys + index, keys + index + 1
+                                    , (count - index - 1) * sizeof(NodeType));
+        header->m_count = --count;
+        page.SetDirty();
+        bUnderflow = (count < LEAF_MIN);
+        return true;
+    }
+
+    index = Search(InnerKeys(page.GetData()), count, target, bFound);
+    if(bFound)
+    {
+        ++index;
+    }
+    if(!Delete(Children(page.GetData())[index], target, bChildUnderflow))
+    {
+        return false;
+    }
+
+    if(bChildUnderflow)
+    {
+        FixChild(page.GetData(), index);
+        page.SetDirty();
+    }
+    bUnderflow = (header->m_count < INNER_MIN);
+    return true;
+
+}  // end of "CPagedBPlusTree<NodeType>::Delete"
+
+
+
+// ==== CPagedBPlusTree::DeleteItem ===========================================
+//
+// This function removes a value from the tree with CPagedBPlusTree::Delete.
+// If that leaves the root an inner node with a single child, the child
+// becomes the root and the tree loses a level.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- the value to remove
+//
+// Output:
+//      A value of true if the value was found and removed, false otherwise
+//      (or if the tree is not open).
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::DeleteItem(const NodeType  &target)
+{
+    uint64_t    oldRoot = NO_PAGE;
+    bool        bUnderflow;
+
+    if(!IsOpen() || !Delete(m_root, target, bUnderflow))
+    {
+        return false;
+    }
+    --m_numItems;
+
+    {
+        CPageHandle     root(&m_pool, m_root);
+        CNodeHeader     *header = NodeHeader(root.GetData());
+
+        if(!header->m_bLeaf && 0 == header->m_count)
+        {
+            oldRoot = m_root;
+            m_root = Children(root.GetData())[0];
+            --m_height;
+        }
+    }
+    if(oldRoot != NO_PAGE)
+    {
+        FreeNode(oldRoot);
+    }
+    return true;
+
+}  // end of "CPagedBPlusTree<NodeType>::DeleteItem"
+
+
+
+// ==== CPagedBPlusTree::DestroyTree ==========================================
+//
+// This function empties the tree.  The file is cut back to its header page
+// and a new empty leaf is made the root.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::DestroyTree()
+{
+    if(!IsOpen())
+    {
+        return;
+    }
+
+    m_pool.Truncate(1);
+    m_numItems = 0;
+    m_numNodes = 0;
+    m_freeList = NO_PAGE;
+    m_height = 1;
+    m_root = AllocNode(true);
+    WriteHeader();
+
+}  // end of "CPagedBPlusTree<NodeType>::DestroyTree"
+
+
+
+// ==== CPagedBPlusTree::FindLeaf =============================================
+//
+// This function walks down from the root to the leaf that would hold a
+// value, pinning one page at a time.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- a pointer to the value, or NULL for the leftmost
+//                         leaf
+//
+// Output:
+//      The number of the leaf's page.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+uint64_t    CPagedBPlusTree<NodeType, Compare>::FindLeaf(
+                                        const NodeType  *target) const
+{
+    uint64_t    pageNo = m_root;
+    size_t      index = 0;
+    bool        bFound;
+
+    for(;;)
+    {
+        CPageHandle     page(&m_pool, pageNo);
+        CNodeHeader     *header = NodeHeader(page.GetData());
+
+        if(header->m_bLeaf)
+        {
+            return pageNo;
+        }
+
+        if(target != NULL)
+        {
+            index = Search(InnerKeys(page.GetData()), header->m_count
+                                                        , *target, bFound);
+            if(bFound)
+            {
+                ++index;
+            }
+        }
+        pageNo = Children(page.GetData())[index];
+    }
+
+}  // end of "CPagedBPlusTree<NodeType>::FindLeaf"
+
+
+
+// ==== CPagedBPlusTree::FixChild =============================================
+//
+// This function repairs a child of an inner node that has been left less
+// than half full, together with a neighbour: the child's left sibling, or its
+// right sibling if it is the first child.  If the two fit in one page they
+// are merged into the left one, the right one is freed and its separator is
+// removed from the parent.  Otherwise their contents (and, for inner nodes,
+// the separator between them) are split evenly between them, and the parent
+// takes a new separator.  Either way every node involved ends up at least
+// half full.  The caller marks the parent dirty.
+//
+// Access: protected
+//
+// Input:
+//      parent [IN/OUT] -- the inner node's page, which the caller holds
+//                         pinned
+//
+//      index [IN]      -- the position of the child among the children
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::FixChild(char  *parent
+                                                    , size_t  index)
+{
+    CNodeHeader *parentHeader = NodeHeader(parent);
+    NodeType    *parentKeys = InnerKeys(parent);
+    uint64_t    *parentChildren = Children(parent);
+    size_t      leftIndex = (index > 0) ? index - 1 : 0;
+    uint64_t    rightPageNo = parentChildren[leftIndex + 1];
+    CPageHandle left(&m_pool, parentChildren[leftIndex]);
+    CPageHandle right(&m_pool, rightPageNo);
+    CNodeHeader *leftHeader = NodeHeader(left.GetData());
+    CNodeHeader *rightHeader = NodeHeader(right.GetData());
+    size_t      leftCount = leftHeader->m_count;
+    size_t      rightCount = rightHeader->m_count;
+    NodeType    *allKeys = reinterpret_cast<NodeType*>(m_scratchKeys.data());
+    uint64_t    *allChildren = m_scratchChildren.data();
+    bool        bMerged = false;
+
+    left.SetDirty();
+    right.SetDirty();
+    if(leftHeader->m_bLeaf)
+    {
+        NodeType    *leftKeys = LeafKeys(left.GetData());
+        NodeType    *rightKeys = LeafKeys(right.GetData());
+        size_t      total = leftCount + rightCount;
+
+        if(total <= LEAF_CAPACITY)
+        {
+            memcpy(leftKeys + leftCount, rightKeys
+                                        , rightCount * sizeof(NodeType));
+            leftHeader->m_count = total;
+            leftHeader->m_next = rightHeader->m_next;
+            bMerged = true;
+        }
+        else
+        {
+            memcpy(allKeys, leftKeys, leftCount * sizeof(NodeType));
+            memcpy(allKeys + leftCount, rightKeys
+                                        , rightCount * sizeof(NodeType));
+            leftCount = total / 2;
+            rightCount = total - leftCount;
+            memcpy(leftKeys, allKeys, leftCount * sizeof(NodeType));
+            memcpy(rightKeys, allKeys + leftCount
+                                        , rightCount * sizeof(NodeType));
+            leftHeader->m_count = leftCount;
+            rightHeader->m_count = rightCount;
+            parentKeys[leftIndex] = rightKeys[0];
+        }
+    }
+    else
+    {
+        NodeType    *leftKeys = InnerKeys(left.GetData());
+        NodeType    *rightKeys = InnerKeys(right.GetData());
+        uint64_t    *leftChildren = Children(left.GetData());
+        uint64_t    *rightChildren = Children(right.GetData());
+        size_t      total = leftCount + 1 + rightCount;
+
+        if(total <= INNER_CAPACITY)
+        {
+            leftKeys[leftCount] = parentKeys[leftIndex];
+            memcpy(leftKeys + leftCount + 1, rightKeys
+                                        , rightCount * sizeof(NodeType));
+            memcpy(leftChildren + leftCount + 1, rightChildren
+                                        , (rightCount + 1) * sizeof(uint64_t));
+            leftHeader->m_count = total;
+            bMerged = true;
+        }
+        else
+        {
+            memcpy(allKeys, leftKeys, leftCount * sizeof(NodeType));
+            allKeys[leftCount] = parentKeys[leftIndex];
+            memcpy(allKeys + leftCount + 1, rightKeys
+                                        , rightCount * sizeof(NodeType));
+            memcpy(allChildren, leftChildren
+                                        , (leftCount + 1) * sizeof(uint64_t));
+            memcpy(allChildren + leftCount + 1, rightChildren
+                                        , (rightCount + 1) * sizeof(uint64_t));
+
+            leftCount = total / 2;
+            rightCount = total - leftCount - 1;
+            memcpy(leftKeys, allKeys, leftCount * sizeof(NodeType));
+            memcpy(leftChildren, allChildren
+                                        , (leftCount + 1) * sizeof(uint64_t));
+            parentKeys[leftIndex] = allKeys[leftCount];
+            memcpy(rightKeys, allKeys + leftCount + 1
+                                        , rightCount * sizeof(NodeType));
+            memcpy(rightChildren, allChildren + leftCount + 1
+                                        , (rightCount + 1) * sizeof(uint64_t));
+            leftHeader->m_count = leftCount;
+            rightHeader->m_count = rightCount;
+        }
+    }
+
+    if(bMerged)
+    {
+        size_t  numAfter = parentHeader->m_count - leftIndex - 1;
+
+        memmove(parentKeys + leftIndex, parentKeys + leftIndex + 1
+                                        , numAfter * sizeof(NodeType));
+        memmove(parentChildren + leftIndex + 1
+                                        , parentChildren + leftIndex + 2
+                                        , numAfter * sizeof(uint64_t));
+        --parentHeader->m_count;
+        FreeNode(rightPageNo);
+    }
+
+}  // end of "CPagedBPlusTree<NodeType>::FixChild"
+
+
+
+// ==== CPagedBPlusTree::FreeNode =============================================
+//
+// This function puts a node's page on the free list, to be reused by
+// CPagedBPlusTree::AllocNode.
+//
+// Access: protected
+//
+// Input:
+//      pageNo [IN]     -- the number of the node's page
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::FreeNode(uint64_t  pageNo)
+{
+    CPageHandle     page(&m_pool, pageNo);
+    CNodeHeader     *header = NodeHeader(page.GetData());
+
+    memset(header, 0, sizeof(CNodeHeader));
+    header->m_next = m_freeList;
+    page.SetDirty();
+    m_freeList = pageNo;
+    --m_numNodes;
+
+}  // end of "CPagedBPlusTree<NodeType>::FreeNode"
+
+
+
+// ==== CPagedBPlusTree::GetPageInfo ==========================================
+//
+// This function returns the number of pages in the tree, not counting the
+// header page or the free pages, and the number of levels of pages, a lone
+// leaf being one level.
+//
+// Access: public
+//
+// Input:
+//      numPages [OUT]  -- receives the number of pages
+//
+//      numLevels [OUT] -- receives the number of levels
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::GetPageInfo(size_t  &numPages
+                                                , size_t  &numLevels) const
+{
+    numPages = static_cast<size_t>(m_numNodes);
+    numLevels = static_cast<size_t>(m_height);
+
+}  // end of "CPagedBPlusTree<NodeType>::GetPageInfo"
+
+
+
+// ==== CPagedBPlusTree::GetTreeInfo ==========================================
+//
+// This function returns the number of items in the tree and its height, with
+// the same meanings as CBSTree::GetTreeInfo: the height is the number of
+// edges from the root page down to a leaf, and is zero for a tree whose root
+// is a leaf or that is not open.  GetPageInfo reports the tree in pages.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- receives the number of items
+//
+//      height [OUT]    -- receives the height of the tree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::GetTreeInfo(size_t  &numNodes
+                                                , size_t  &height) const
+{
+    numNodes = m_numItems;
+    height = (m_height > 0) ? static_cast<size_t>(m_height - 1) : 0;
+
+}  // end of "CPagedBPlusTree<NodeType>::GetTreeInfo"
+
+
+
+// ==== CPagedBPlusTree::InOrderTraverse ======================================
+//
+// This function visits every value in increasing order, by following the
+// links from the leftmost leaf with CPagedBPlusTree::ScanLeaves.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to the function to call for each value
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::InOrderTraverse(
+                                    void  (*fPtr)(const NodeType&)) const
+{
+    if(IsOpen())
+    {
+        ScanLeaves(FindLeaf(NULL), NULL, NULL, fPtr);
+    }
+
+}  // end of "CPagedBPlusTree<NodeType>::InOrderTraverse"
+
+
+
+// ==== CPagedBPlusTree::InnerKeys ============================================
+//
+// This function returns the array of separator values in an inner node.
+//
+// Access: protected
+//
+// Input:
+//      page [IN]       -- the node's page
+//
+// Output:
+//      A pointer to the first separator.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+NodeType*   CPagedBPlusTree<NodeType, Compare>::InnerKeys(char  *page)
+{
+    return reinterpret_cast<NodeType*>(page + INNER_KEYS_OFFSET);
+
+}  // end of "CPagedBPlusTree<NodeType>::InnerKeys"
+
+
+
+// ==== CPagedBPlusTree::Insert ===============================================
+//
+// This function adds a value to the subtree under a node.  In a leaf the
+// value is shifted into place.  In an inner node the function calls itself on
+// the child that should hold the value, and if that child split, the new
+// separator and the new child's page are shifted into place.  A node that is
+// already full is split instead: its values plus the new one are gathered in
+// the scratch area and divided between the node and a new node on its right.
+// For a leaf the new node's first value becomes the separator; for an inner
+// node the middle value moves up to become it.  The new leaf is linked into
+// the chain of leaves.
+//
+// Access: protected
+//
+// Input:
+//      pageNo [IN]     -- the number of the node's page
+//
+//      newItem [IN]    -- the value to add
+//
+//      bSplit [OUT]    -- set to true if the node was split
+//
+//      sepKey [OUT]    -- receives the separator between the node and the
+//                         new node, if it was split (it may be changed even
+//                         if it was not)
+//
+//      newPage [OUT]   -- receives the number of the new node's page, if the
+//                         node was split
+//
+// Output:
+//      A value of true if the value was added, false if it was already in
+//      the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::Insert(uint64_t  pageNo
+                                                , const NodeType  &newItem
+                                                , bool  &bSplit
+                                                , NodeType  &sepKey
+                                                , uint64_t  &newPage)
+{
+    CPageHandle     page(&m_pool, pageNo);
+    CNodeHeader     *header = NodeHeader(page.GetData());
+    size_t          count = header->m_count;
+    size_t          index;
+    size_t          leftCount;
+    size_t          rightCount;
+    bool            bFound;
+    NodeType        *allKeys = reinterpret_cast<NodeType*>(
+                                                    m_scratchKeys.data());
+
+    bSplit = false;
+    if(header->m_bLeaf)
+    {
+        NodeType    *keys = LeafKeys(page.GetData());
+
+        index = Search(keys, count, newItem, bFound);
+        if(bFound)
+        {
+            return false;
+        }
+
+        page.SetDirty();
+        if(count < LEAF_CAPACITY)
+        {
+            memmove(keys + index + 1, keys + index
+                                        , (count - index) * sizeof(NodeType));
+            keys[index] = newItem;
+            header->m_count = count + 1;
+            return true;
+        }
+
+        memcpy(allKeys, keys, index * sizeof(NodeType));
+        allKeys[index] = newItem;
+        memcpy(allKeys + index + 1, keys + index
+                                        , (count - index) * sizeof(NodeType));
+        leftCount = (count + 1) / 2;
+        rightCount = count + 1 - leftCount;
+
+        newPage = AllocNode(true);
+        CPageHandle     right(&m_pool, newPage);
+        CNodeHeader     *rightHeader = NodeHeader(right.GetData());
+        NodeType        *rightKeys = LeafKeys(right.GetData());
+
+        right.SetDirty();
+        memcpy(keys, allKeys, leftCount * sizeof(NodeType));
+        memcpy(rightKeys, allKeys + leftCount, rightCount * sizeof(NodeType));
+        header->m_count = leftCount;
+        rightHeader->m_count = rightCount;
+        rightHeader->m_next = header->m_next;
+        header->m_next = newPage;
+        sepKey = rightKeys[0];
+        bSplit = true;
+        return true;
+    }
+
+    NodeType    *keys = InnerKeys(page.GetData());
+    uint64_t    *children = Children(page.GetData());
+    uint64_t    childPage;
+    bool        bChildSplit;
+
+    index = Search(keys, count, newItem, bFound);
+    if(bFound)
+    {
+        ++index;
+    }
+    if(!Insert(children[index], newItem, bChildSplit, sepKey, childPage))
+    {
+        return false;
+    }
+    if(!bChildSplit)
+    {
+        return true;
+    }
+
+    page.SetDirty();
+    if(count < INNER_CAPACITY)
+    {
+        memmove(keys + index + 1, keys + index
+                                        , (count - index) * sizeof(NodeType));
+        memmove(children + index + 2, children + index + 1
+                                        , (count - index) * sizeof(uint64_t));
+        keys[index] = sepKey;
+        children[index + 1] = childPage;
+        header->m_count = count + 1;
+        return true;
+    }
+
+    uint64_t    *allChildren = m_scratchChildren.data();
+
+    memcpy(allKeys, keys, index * sizeof(NodeType));
+    allKeys[index] = sepKey;
+    memcpy(allKeys + index + 1, keys + index
+                                        , (count - index) * sizeof(NodeType));
+    memcpy(allChildren, children, (index + 1) * sizeof(uint64_t));
+    allChildren[index + 1] = childPage;
+    memcpy(allChildren + index + 2, children + index + 1
+                                        , (count - index) * sizeof(uint64_t));
+    leftCount = (count + 1) / 2;
+    rightCount = count - leftCount;
+
+    newPage = AllocNode(false);
+    CPageHandle     right(&m_pool, newPage);
+
+    right.SetDirty();
+    memcpy(keys, allKeys, leftCount * sizeof(NodeType));
+    memcpy(children, allChildren, (leftCount + 1) * sizeof(uint64_t));
+    memcpy(InnerKeys(right.GetData()), allKeys + leftCount + 1
+                                        , rightCount * sizeof(NodeType));
+    memcpy(Children(right.GetData()), allChildren + leftCount + 1
+                                        , (rightCount + 1) * sizeof(uint64_t));
+    header->m_count = leftCount;
+    NodeHeader(right.GetData())->m_count = rightCount;
+    sepKey = allKeys[leftCount];
+    bSplit = true;
+    return true;
+
+}  // end of "CPagedBPlusTree<NodeType>::Insert"
+
+
+
+// ==== CPagedBPlusTree::InsertItem ===========================================
+//
+// This function adds a value to the tree with CPagedBPlusTree::Insert.  If
+// the root splits, a new root is made above the two halves and the tree gains
+// a level.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- the value to add
+//
+// Output:
+//      A value of true if the value was added, false if it was already in the
+//      tree (or if the tree is not open).
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::InsertItem(
+                                                const NodeType  &newItem)
+{
+    NodeType    sepKey(newItem);
+    uint64_t    newPage;
+    bool        bSplit;
+
+    if(!IsOpen() || !Insert(m_root, newItem, bSplit, sepKey, newPage))
+    {
+        return false;
+    }
+    ++m_numItems;
+
+    if(bSplit)
+    {
+        uint64_t        rootPage = AllocNode(false);
+        CPageHandle     root(&m_pool, rootPage);
+
+        root.SetDirty();
+        NodeHeader(root.GetData())->m_count = 1;
+        InnerKeys(root.GetData())[0] = sepKey;
+        Children(root.GetData())[0] = m_root;
+        Children(root.GetData())[1] = newPage;
+        m_root = rootPage;
+        ++m_height;
+    }
+    return true;
+
+}  // end of "CPagedBPlusTree<NodeType>::InsertItem"
+
+
+
+// ==== CPagedBPlusTree::ItemInTree ===========================================
+//
+// This function determines whether a value is in the tree, by searching the
+// leaf that CPagedBPlusTree::FindLeaf leads to.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- the value to look for
+//
+// Output:
+//      A value of true if the value is in the tree, false otherwise (or if
+//      the tree is not open).
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::ItemInTree(
+                                        const NodeType  &target) const
+{
+    bool    bFound = false;
+
+    if(IsOpen())
+    {
+        CPageHandle     leaf(&m_pool, FindLeaf(&target));
+
+        Search(LeafKeys(leaf.GetData()), NodeHeader(leaf.GetData())->m_count
+                                                        , target, bFound);
+    }
+    return bFound;
+
+}  // end of "CPagedBPlusTree<NodeType>::ItemInTree"
+
+
+
+// ==== CPagedBPlusTree::LeafKeys =============================================
+//
+// This function returns the array of values in a leaf.
+//
+// Access: protected
+//
+// Input:
+//      page [IN]       -- the leaf's page
+//
+// Output:
+//      A pointer to the first value.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+NodeType*   CPagedBPlusTree<NodeType, Compare>::LeafKeys(char  *page)
+{
+    return reinterpret_cast<NodeType*>(page + sizeof(CNodeHeader));
+
+}  // end of "CPagedBPlusTree<NodeType>::LeafKeys"
+
+
+
+// ==== CPagedBPlusTree::NodeHeader ===========================================
+//
+// This function returns the header at the start of a node's page.
+//
+// Access: protected
+//
+// Input:
+//      page [IN]       -- the node's page
+//
+// Output:
+//      A pointer to the header.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+typename CPagedBPlusTree<NodeType, Compare>::CNodeHeader*
+                    CPagedBPlusTree<NodeType, Compare>::NodeHeader(char  *page)
+{
+    return reinterpret_cast<CNodeHeader*>(page);
+
+}  // end of "CPagedBPlusTree<NodeType>::NodeHeader"
+
+
+
+// ==== CPagedBPlusTree::Open =================================================
+//
+// This function opens the tree stored in a file, closing the file the tree
+// had open.  A file that does not exist (or is empty) is given a header and
+// an empty root leaf.  An existing file must have been written by a tree
+// with the same page size and value size.
+//
+// Access: public
+//
+// Input:
+//      path [IN]           -- the name of the file
+//
+//      memoryBudget [IN]   -- the number of bytes the buffer pool may use to
+//                             cache pages
+//
+// Output:
+//      A value of true if the tree was opened, false if the file could not
+//      be opened or is not a tree file of the right kind.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::Open(const string  &path
+                                                , size_t  memoryBudget)
+{
+    CFileHeader fileHeader;
+    uint64_t    headerPage;
+    bool        bValid;
+
+    Close();
+    if(!m_pool.Open(path, PAGE_SIZE, memoryBudget))
+    {
+        return false;
+    }
+
+    if(0 == m_pool.GetNumPages())
+    {
+        m_pool.NewPage(headerPage);
+        m_pool.UnpinPage(headerPage, true);
+        m_numItems = 0;
+        m_numNodes = 0;
+        m_freeList = NO_PAGE;
+        m_height = 1;
+        m_root = AllocNode(true);
+        WriteHeader();
+        return true;
+    }
+
+    {
+        CPageHandle     page(&m_pool, 0);
+        memcpy(&fileHeader, page.GetData(), sizeof(fileHeader));
+    }
+    bValid = (0 == memcmp(fileHeader.m_magic, PAGED_TREE_MAGIC
+                                                    , sizeof(PAGED_TREE_MAGIC))
+                && PAGE_SIZE == fileHeader.m_pageSize
+                && sizeof(NodeType) == fileHeader.m_valueSize
+                && fileHeader.m_root != NO_PAGE
+                && fileHeader.m_root < m_pool.GetNumPages());
+    if(!bValid)
+    {
+        m_pool.Close();
+        return false;
+    }
+
+    m_root = fileHeader.m_root;
+    m_numItems = static_cast<size_t>(fileHeader.m_numItems);
+    m_numNodes = fileHeader.m_numNodes;
+    m_freeList = fileHeader.m_freeList;
+    m_height = static_cast<int>(fileHeader.m_height);
+    return true;
+
+}  // end of "CPagedBPlusTree<NodeType>::Open"
+
+
+
+// ==== CPagedBPlusTree::RangeTraverse ========================================
+//
+// This function visits, in increasing order, every value in the tree from lo
+// to hi (both inclusive), starting in the leaf that would hold lo and
+// following the leaf links with CPagedBPlusTree::ScanLeaves.
+//
+// Access: public
+//
+// Input:
+//      lo [IN]         -- the smallest value to visit
+//
+//      hi [IN]         -- the largest value to visit
+//
+//      fPtr [IN]       -- a pointer to the function to call for each value
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::RangeTraverse(const NodeType  &lo
+                                    , const NodeType  &hi
+                                    , void  (*fPtr)(const NodeType&)) const
+{
+    if(IsOpen() && Compare3(lo, hi) <= 0)
+    {
+        ScanLeaves(FindLeaf(&lo), &lo, &hi, fPtr);
+    }
+
+}  // end of "CPagedBPlusTree<NodeType>::RangeTraverse"
+
+
+
+// ==== CPagedBPlusTree::ScanLeaves ===========================================
+//
+// This function visits values in increasing order, leaf after leaf along the
+// leaf links, from the first value not less than lo to the last value not
+// greater than hi.  Only one leaf is pinned at a time.
+//
+// Access: protected
+//
+// Input:
+//      pageNo [IN]     -- the number of the leaf to start in, which must be
+//                         the one that would hold lo
+//
+//      lo [IN]         -- a pointer to the lower bound, or NULL for none
+//
+//      hi [IN]         -- a pointer to the upper bound, or NULL for none
+//
+//      fPtr [IN]       -- a pointer to the function to call for each value
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::ScanLeaves(uint64_t  pageNo
+                                    , const NodeType  *lo
+                                    , const NodeType  *hi
+                                    , void  (*fPtr)(const NodeType&)) const
+{
+    size_t  index = 0;
+    bool    bFound;
+
+    while(pageNo != NO_PAGE)
+    {
+        CPageHandle     leaf(&m_pool, pageNo);
+        CNodeHeader     *header = NodeHeader(leaf.GetData());
+        NodeType        *keys = LeafKeys(leaf.GetData());
+
+        if(lo != NULL)
+        {
+            index = Search(keys, header->m_count, *lo, bFound);
+            lo = NULL;
+        }
+        for(; index < header->m_count; ++index)
+        {
+            if(hi != NULL && Compare3(keys[index], *hi) > 0)
+            {
+                return;
+            }
+            fPtr(keys[index]);
+        }
+        index = 0;
+        pageNo = header->m_next;
+    }
+
+}  // end of "CPagedBPlusTree<NodeType>::ScanLeaves"
+
+
+
+// ==== CPagedBPlusTree::Search ===============================================
+//
+// This function binary-searches a node's sorted values for a target.  In an
+// inner node, the child to descend into is the returned position, plus one if
+// the target was found (a separator is the smallest value of the subtree on
+// its right).
+//
+// Access: protected
+//
+// Input:
+//      keys [IN]       -- the node's values
+//
+//      count [IN]      -- the number of values
+//
+//      target [IN]     -- the value to look for
+//
+//      bFound [OUT]    -- set to true if the target is among the values
+//
+// Output:
+//      The position of the target if it was found, otherwise the position of
+//      the first value greater than it.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+size_t  CPagedBPlusTree<NodeType, Compare>::Search(const NodeType  keys[]
+                                                , size_t  count
+                                                , const NodeType  &target
+                                                , bool  &bFound) const
+{
+    size_t  low = 0;
+    size_t  high = count;
+    size_t  middle;
+    int     result;
+
+    while(low < high)
+    {
+        middle = low + (high - low) / 2;
+        result = Compare3(keys[middle], target);
+        if(0 == result)
+        {
+            bFound = true;
+            return middle;
+        }
+        if(result < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    bFound = false;
+    return low;
+
+}  // end of "CPagedBPlusTree<NodeType>::Search"
+
+
+
+// ==== CPagedBPlusTree::Sync =================================================
+//
+// This function writes the header and every dirty page back and flushes the
+// file, which leaves it holding the tree as it is now.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if everything was written and no earlier read or write
+//      has failed, false otherwise (or if the tree is not open).
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CPagedBPlusTree<NodeType, Compare>::Sync()
+{
+    if(!IsOpen())
+    {
+        return false;
+    }
+
+    WriteHeader();
+    return m_pool.Sync();
+
+}  // end of "CPagedBPlusTree<NodeType>::Sync"
+
+
+
+// ==== CPagedBPlusTree::WriteHeader ==========================================
+//
+// This function copies the tree's root, counts and free list to page 0.
+//
+// Access: protected
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CPagedBPlusTree<NodeType, Compare>::WriteHeader()
+{
+    CFileHeader     fileHeader;
+    CPageHandle     page(&m_pool, 0);
+
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.m_magic, PAGED_TREE_MAGIC, sizeof(PAGED_TREE_MAGIC));
+    fileHeader.m_pageSize = PAGE_SIZE;
+    fileHeader.m_valueSize = sizeof(NodeType);
+    fileHeader.m_root = m_root;
+    fileHeader.m_numItems = m_numItems;
+    fileHeader.m_numNodes = m_numNodes;
+    fileHeader.m_freeList = m_freeList;
+    fileHeader.m_height = static_cast<uint32_t>(m_height);
+    memcpy(page.GetData(), &fileHeader, sizeof(fileHeader));
+    page.SetDirty();
+
+}  // end of "CPagedBPlusTree<NodeType>::WriteHeader"
@@ -0,0 +1,173 @@
+// ============================================================================
+// File: cpagedbplustree.h
+// ============================================================================
+// This header file contains the declaration of the CPagedBPlusTree class, an
+// ordered set kept in a file rather than in memory, for sets too large to fit
+// in RAM.  It uses the template parameters "NodeType" and "Compare" as
+// CBSTree does; NodeType must be trivially copyable, since values are stored
+// in the file byte for byte.
+//
+// The tree is a B+ tree of PAGE_SIZE pages.  Every value is held in a leaf,
+// in sorted order, and the leaves are linked from left to right, so that
+// InOrderTraverse and RangeTraverse read them one after another once the
+// first one has been found.  The pages above the leaves hold only separator
+// values and the numbers of their child pages; with hundreds of children per
+// page a billion small values are reached in four or five levels.  Insertion
+// splits a full page in two, and deletion refills a page less than half full
+// from a neighbour, or merges the two; freed pages are kept on a list in the
+// file and reused.  Page 0 holds a header with the root, the number of items
+// and the head of that list.  GetTreeInfo reports the number of items and
+// the height in edges, as CBSTree does; GetPageInfo reports the number of
+// pages and of levels.
+//
+// Pages are reached through a CBufferPool (see cbufferpool.h), which keeps as
+// many of them in memory as the budget given to Open allows, chooses pages to
+// evict with the CLOCK algorithm and writes dirty pages back on a background
+// thread.  An operation pins only the pages on its path from the root.  The
+// upper levels are used by every operation, so they stay resident and a
+// lookup in a cold tree usually costs one read.
+//
+// The file is consistent after Sync or Close; there is no log, so a crash in
+// between can leave it damaged (CDurableBSTree keeps a write-ahead log, for
+// sets that fit in memory).  A failed read or write is reported by the next
+// Sync.  Like CBSTree the tree may be used by one thread at a time.
+// ============================================================================
+
+#ifndef CPAGED_BPLUS_TREE_HEADER
+#define CPAGED_BPLUS_TREE_HEADER
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <string>
+#include    <type_traits>
+#include    <vector>
+using namespace std;
+#include    "cbufferpool.h"
+#include    "ccompare.h"
+
+// class declaration
+template    <typename  NodeType, typename  Compare = CThreeWayCompare<NodeType> >
+class   CPagedBPlusTree
+{
+    static_assert(is_trivially_copyable<NodeType>::value
+                    , "CPagedBPlusTree values must be trivially copyable");
+    static_assert(alignof(NodeType) <= alignof(max_align_t)
+                    , "CPagedBPlusTree values must not be over-aligned");
+
+public:
+    // constructors and destructor
+    CPagedBPlusTree();
+    explicit CPagedBPlusTree(const Compare  &comp);
+    virtual ~CPagedBPlusTree() { Close(); }
+
+    // member functions
+    void    Close();
+    bool    DeleteItem(const NodeType  &target);
+    void    DestroyTree();
+    const CBufferPool&  GetBufferPool() const { return m_pool; }
+    size_t  GetNumItems() const { return m_numItems; }
+    void    GetPageInfo(size_t  &numPages, size_t  &numLevels) const;
+    void    GetTreeInfo(size_t  &numNodes, size_t  &height) const;
+    void    InOrderTraverse(void  (*fPtr)(const NodeType&)) const;
+    bool    InsertItem(const NodeType  &newItem);
+    bool    IsOpen() const { return m_pool.IsOpen(); }
+    bool    IsTreeEmpty() const { return (0 == m_numItems); }
+    bool    ItemInTree(const NodeType  &target) const;
+    bool    Open(const string  &path, size_t  memoryBudget = 64 << 20);
+    void    RangeTraverse(const NodeType  &lo, const NodeType  &hi
+                                    , void  (*fPtr)(const NodeType&)) const;
+    bool    Sync();
+
+    // the tree owns an open file, so it cannot be copied
+    CPagedBPlusTree(const CPagedBPlusTree  &other) = delete;
+    CPagedBPlusTree&    operator=(const CPagedBPlusTree  &rhs) = delete;
+
+protected:
+    // the contents of page 0
+    struct  CFileHeader
+    {
+        char        m_magic[8];
+        uint32_t    m_pageSize;
+        uint32_t    m_valueSize;
+        uint64_t    m_root;
+        uint64_t    m_numItems;
+        uint64_t    m_numNodes;
+        uint64_t    m_freeList;
+        uint32_t    m_height;
+        uint32_t    m_reserved;
+    };
+
+    // the start of every node page; m_next links a leaf to the leaf on its
+    // right, and a free page to the next free page
+    struct  CNodeHeader
+    {
+        uint32_t    m_bLeaf;
+        uint32_t    m_count;
+        uint64_t    m_next;
+        uint64_t    m_reserved[2];
+    };
+
+    static const size_t     PAGE_SIZE = 4096;
+
+    // page 0 is the header, so no node link ever refers to it
+    static const uint64_t   NO_PAGE = 0;
+
+    // a leaf holds values after its header; an inner node holds its child
+    // links after its header and then its separator values
+    static const size_t     LEAF_CAPACITY = (PAGE_SIZE - sizeof(CNodeHeader))
+                                                        / sizeof(NodeType);
+    static const size_t     INNER_CAPACITY = (PAGE_SIZE - sizeof(CNodeHeader)
+                                    - sizeof(uint64_t) - alignof(NodeType))
+                                    / (sizeof(NodeType) + sizeof(uint64_t));
+    static const size_t     INNER_KEYS_OFFSET = (sizeof(CNodeHeader)
+                                + (INNER_CAPACITY + 1) * sizeof(uint64_t)
+                                + alignof(NodeType) - 1)
+                                / alignof(NodeType) * alignof(NodeType);
+
+    // a node other than the root holds at least this many values
+    static const size_t     LEAF_MIN = LEAF_CAPACITY / 2;
+    static const size_t     INNER_MIN = INNER_CAPACITY / 2;
+
+    static_assert(INNER_CAPACITY >= 3
+                    , "CPagedBPlusTree values are too large for a page");
+
+    // member functions
+    uint64_t                AllocNode(bool  bLeaf);
+    static uint64_t*        Children(char  *page);
+    int                     Compare3(const NodeType  &lhs
+                                        , const NodeType  &rhs) const;
+    bool                    Delete(uint64_t  pageNo, const NodeType  &target
+                                        , bool  &bUnderflow);
+    uint64_t                FindLeaf(const NodeType  *target) const;
+    void                    FixChild(char  *parent, size_t  index);
+    void                    FreeNode(uint64_t  pageNo);
+    static NodeType*        InnerKeys(char  *page);
+    bool                    Insert(uint64_t  pageNo, const NodeType  &newItem
+                                        , bool  &bSplit, NodeType  &sepKey
+                                        , uint64_t  &newPage);
+    static NodeType*        LeafKeys(char  *page);
+    static CNodeHeader*     NodeHeader(char  *page);
+    void                    ScanLeaves(uint64_t  pageNo, const NodeType  *lo
+                                        , const NodeType  *hi
+                                        , void  (*fPtr)(const NodeType&))
+                                                                    const;
+    size_t                  Search(const NodeType  keys[], size_t  count
+                                        , const NodeType  &target
+                                        , bool  &bFound) const;
+    void                    WriteHeader();
+
+    // data members
+    mutable CBufferPool     m_pool;
+    Compare                 m_compare;
+    uint64_t                m_root;
+    size_t                  m_numItems;
+    uint64_t                m_numNodes;
+    uint64_t                m_freeList;
+    int                     m_height;
+    // room for the contents of two full nodes, for splits and refills
+    vector<char>            m_scratchKeys;
+    vector<uint64_t>        m_scratchChildren;
+};
+
+#include    "cpagedbplustree.cpp"
+#endif  // CPAGED_BPLUS_TREE_HEADER
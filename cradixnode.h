@@ -0,0 +1,168 @@
+// ============================================================================
+// File: cradixnode.h
+// ============================================================================
+// This file contains the definition of the CRadixNode class, the node type of
+// a CRadixTree.  It uses the "CharType" template parameter for the character
+// type of the keys.
+//
+// A node holds the label of the edge leading to it, a piece of one or more
+// characters that all of the keys below it share, and a flag telling whether
+// the characters from the root down to here form a key.  The children are
+// kept in an array sorted by the first character of their labels, and those
+// characters are also kept in a separate compact array, so the search for the
+// next child looks at a few bytes instead of at each child node.
+//
+// All of this lives in a single block of memory: a small header, then the
+// child links, then the first characters of the children, then the label.
+// There are no strings or vectors with blocks of their own.  The two child
+// arrays have room for a number of children that is a power of two (its size
+// class, as in an adaptive radix tree), so a node is only reallocated when
+// its class fills up or drops to a quarter full, and a leaf, which has no
+// children, holds nothing but its header and label.  Nodes are made with
+// Create and released with Destroy, never with new and delete; CharType must
+// be a trivial character type.
+// ============================================================================
+
+#ifndef CRADIX_NODE_HEADER
+#define CRADIX_NODE_HEADER
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <new>
+#include    <string_view>
+using namespace std;
+
+template    <typename  CharType>
+class   CRadixNode
+{
+public:
+    // member functions
+    CRadixNode**        Children() { return reinterpret_cast<CRadixNode**>(
+                                        reinterpret_cast<char*>(this)
+                                                    + CHILDREN_OFFSET); }
+    CRadixNode* const*  Children() const { return const_cast<CRadixNode*>(
+                                                    this)->Children(); }
+    static CRadixNode*  Create(size_t  labelLength, size_t  capacity);
+    static void         Destroy(CRadixNode  *nodePtr);
+    CharType*           FirstChars() { return reinterpret_cast<CharType*>(
+                                                Children() + m_capacity); }
+    const CharType*     FirstChars() const { return const_cast<CRadixNode*>(
+                                                    this)->FirstChars(); }
+    basic_string_view<CharType>     Label() const
+                                { return basic_string_view<CharType>(
+                                        FirstChars() + m_capacity
+                                                    , m_labelLength); }
+    CharType*           LabelChars() { return FirstChars() + m_capacity; }
+    static size_t       SizeClass(size_t  numChildren);
+
+    // data members
+    uint32_t    m_labelLength;
+    uint32_t    m_numChildren;
+    uint32_t    m_capacity;
+    bool        m_bKey;
+
+private:
+    // the child links start at the first pointer-aligned offset after the
+    // header
+    static const size_t     CHILDREN_OFFSET = (sizeof(uint32_t) * 3
+                                + sizeof(bool) + alignof(CRadixNode*) - 1)
+                                / alignof(CRadixNode*) * alignof(CRadixNode*);
+
+    // nodes are only made by Create
+    CRadixNode() {}
+};
+
+
+
+// ==== CRadixNode::Create ====================================================
+//
+// This function allocates a node with room for a label of a given length and
+// for a given number of children, in one block.  The node has no children,
+// holds no key, and its label characters are left for the caller to fill in.
+//
+// Access: public
+//
+// Input:
+//      labelLength [IN]    -- the number of characters in the label
+//
+//      capacity [IN]       -- the number of children there is room for
+//
+// Output:
+//      A pointer to the new node.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixNode<CharType>*   CRadixNode<CharType>::Create(size_t  labelLength
+                                                    , size_t  capacity)
+{
+    size_t          numBytes = CHILDREN_OFFSET
+                                + capacity * sizeof(CRadixNode*)
+                                + (capacity + labelLength) * sizeof(CharType);
+    CRadixNode      *nodePtr = new(::operator new(numBytes)) CRadixNode;
+
+    nodePtr->m_labelLength = static_cast<uint32_t>(labelLength);
+    nodePtr->m_numChildren = 0;
+    nodePtr->m_capacity = static_cast<uint32_t>(capacity);
+    nodePtr->m_bKey = false;
+    return nodePtr;
+
+}  // end of "CRadixNode<CharType>::Create"
+
+
+
+// ==== CRadixNode::Destroy ===================================================
+//
+// This function releases the block of a node made by Create.  The node's
+// children are not touched.
+//
+// Access: public
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the node to release
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixNode<CharType>::Destroy(CRadixNode<CharType>  *nodePtr)
+{
+    nodePtr->~CRadixNode();
+    ::operator delete(nodePtr);
+
+}  // end of "CRadixNode<CharType>::Destroy"
+
+
+
+// ==== CRadixNode::SizeClass =================================================
+//
+// This function gives the capacity a node with a given number of children is
+// allocated with: the number itself rounded up to a power of two, or zero
+// for a leaf.
+//
+// Access: public
+//
+// Input:
+//      numChildren [IN]    -- the number of children the node must hold
+//
+// Output:
+//      The capacity to allocate.
+//
+// ============================================================================
+
+template    <typename  CharType>
+size_t  CRadixNode<CharType>::SizeClass(size_t  numChildren)
+{
+    size_t  capacity = (numChildren > 0) ? 1 : 0;
+
+    while(capacity < numChildren)
+    {
+        capacity *= 2;
+    }
+    return capacity;
+
+}  // end of "CRadixNode<CharType>::SizeClass"
+
+#endif  // CRADIX_NODE_HEADER
@@ -0,0 +1,894 @@
+// ============================================================================
+// File: cradixtree.cpp
+// ============================================================================
+// This file contains the implementation of the CRadixTree class. It uses the
+// template parameter "CharType" for the character type of the keys.
+// ============================================================================
+
+#include    <climits>
+using namespace std;
+#include    "cradixtree.h"
+
+
+// ==== CRadixTree::CRadixTree ================================================
+//
+// This is the copy constructor for the CRadixTree class, it just makes a call
+// to the CopyTree member function and saves the return value in the root
+// member of the calling object.
+//
+// Access: public
+//
+// Input:
+//      other [IN]  -- a constant reference to a CRadixTree object.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixTree<CharType>::CRadixTree(const CRadixTree<CharType>  &other)
+                                    : m_root(NULL)
+                                    , m_numKeys(other.m_numKeys)
+                                    , m_numNodes(other.m_numNodes)
+{
+    m_root = CopyTree(other.m_root);
+
+}  // end of "CRadixTree<CharType>::CRadixTree"
+
+
+
+// ==== CRadixTree::AddChild ==================================================
+//
+// This function links a new child into a node's arrays at a given position.
+// If the node's size class is full, the node is first moved into a block of
+// the next class, and the link that held it is updated.
+//
+// Access: protected
+//
+// Input:
+//      link [IN/OUT]   -- the address of the link that holds the node
+//
+//      index [IN]      -- the position of the new child among the children
+//
+//      childPtr [IN]   -- a pointer to the new child
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::AddChild(CRadixNode<CharType>  **link
+                                        , size_t  index
+                                        , CRadixNode<CharType>  *childPtr)
+{
+    CRadixNode<CharType>    *nodePtr = *link;
+    size_t                  count = nodePtr->m_numChildren;
+
+    if(count == nodePtr->m_capacity)
+    {
+        size_t  capacity = CRadixNode<CharType>::SizeClass(count + 1);
+        nodePtr = Resize(nodePtr, nodePtr->Label(), capacity);
+        *link = nodePtr;
+    }
+
+    CRadixNode<CharType>    **children = nodePtr->Children();
+    CharType                *firstChars = nodePtr->FirstChars();
+    for(size_t i = count; i > index; --i)
+    {
+        children[i] = children[i - 1];
+        firstChars[i] = firstChars[i - 1];
+    }
+    children[index] = childPtr;
+    firstChars[index] = childPtr->Label()[0];
+    ++nodePtr->m_numChildren;
+
+}  // end of "CRadixTree<CharType>::AddChild"
+
+
+
+// ==== CRadixTree::ChildIndex ================================================
+//
+// This function looks for the child of a node whose label starts with a given
+// character, using a binary search over the node's array of first characters.
+// The characters are ordered with char_traits, just as basic_string orders
+// them, so the children are visited in the strings' natural order.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the node to search
+//
+//      first [IN]      -- the character to look for
+//
+//      bFound [OUT]    -- set to true if a child starts with that character,
+//                         false otherwise
+//
+// Output:
+//      The index of the matching child, or, if there is none, the index at
+//      which a child starting with that character would be inserted.
+//
+// ============================================================================
+
+template    <typename  CharType>
+size_t  CRadixTree<CharType>::ChildIndex(const CRadixNode<CharType>  *nodePtr
+                                            , CharType  first, bool  &bFound)
+{
+    const CharType  *firstChars = nodePtr->FirstChars();
+    size_t          low = 0;
+    size_t          high = nodePtr->m_numChildren;
+
+    while(low < high)
+    {
+        size_t  middle = low + (high - low) / 2;
+        if(char_traits<CharType>::lt(firstChars[middle], first))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    bFound = (low < nodePtr->m_numChildren
+                        && char_traits<CharType>::eq(firstChars[low], first));
+    return low;
+
+}  // end of "CRadixTree<CharType>::ChildIndex"
+
+
+
+// ==== CRadixTree::CopyTree ==================================================
+//
+// This function copies the contents of the sourcePtr tree into a new tree,
+// recursively, and returns a pointer to the root of the copy.  Each copy is
+// allocated in the size class of its number of children.
+//
+// Access: private
+//
+// Input:
+//      sourcePtr [IN]  -- a pointer to the root of the subtree to copy
+//
+// Output:
+//      A pointer to the root of the new subtree.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixNode<CharType>*  CRadixTree<CharType>::CopyTree(
+                                    const CRadixNode<CharType>  *sourcePtr)
+{
+    size_t                  count = sourcePtr->m_numChildren;
+    size_t                  capacity = CRadixNode<CharType>::SizeClass(count);
+    CRadixNode<CharType>    *nodePtr = NewNode(sourcePtr->Label()
+                                        , sourcePtr->m_bKey, capacity);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        nodePtr->Children()[i] = CopyTree(sourcePtr->Children()[i]);
+        nodePtr->FirstChars()[i] = sourcePtr->FirstChars()[i];
+    }
+    nodePtr->m_numChildren = static_cast<uint32_t>(count);
+    return nodePtr;
+
+}  // end of "CRadixTree<CharType>::CopyTree"
+
+
+
+// ==== CRadixTree::CountHeight ===============================================
+//
+// This recursive function finds the height of the subtree rooted at nodePtr,
+// counting edges.  The recursion is no deeper than the longest key.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+// Output:
+//      The height of the subtree.
+//
+// ============================================================================
+
+template    <typename  CharType>
+int     CRadixTree<CharType>::CountHeight(const CRadixNode<CharType>  *nodePtr)
+                                                                        const
+{
+    int     height = 0;
+
+    for(size_t i = 0; i < nodePtr->m_numChildren; ++i)
+    {
+        int childHeight = CountHeight(nodePtr->Children()[i]) + 1;
+        if(childHeight > height)
+        {
+            height = childHeight;
+        }
+    }
+
+    return height;
+
+}  // end of "CRadixTree<CharType>::CountHeight"
+
+
+
+// ==== CRadixTree::DeleteItem ================================================
+//
+// This function allows the caller to delete a key from the tree.  The key's
+// node stops being a key; it is then released if it has no children, and
+// merged with its child if it has just one.  Releasing a node can leave its
+// parent with a single child and no key of its own, in which case the parent
+// is merged with the remaining child, so every node except the root always
+// holds a key or branches.  The search keeps the addresses of the links that
+// hold the node and its parent, since both may be moved to new blocks.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- the key to delete
+//
+// Output:
+//      A value of false if the key is not in the tree, otherwise a value of
+//      true is returned and the key is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  CharType>
+bool    CRadixTree<CharType>::DeleteItem(KeyView  target)
+{
+    CRadixNode<CharType>    **parentLink = NULL;
+    CRadixNode<CharType>    **link = &m_root;
+    CRadixNode<CharType>    *nodePtr;
+    size_t                  childIndex = 0;
+    size_t                  pos = 0;
+    bool                    bFound;
+
+    while(pos < target.size())
+    {
+        nodePtr = *link;
+        size_t  index = ChildIndex(nodePtr, target[pos], bFound);
+        if(!bFound)
+        {
+            return false;
+        }
+
+        CRadixNode<CharType> *childPtr = nodePtr->Children()[index];
+        if(target.substr(pos, childPtr->m_labelLength) != childPtr->Label())
+        {
+            return false;
+        }
+
+        parentLink = link;
+        childIndex = index;
+        link = &nodePtr->Children()[index];
+        pos += childPtr->m_labelLength;
+    }
+
+    nodePtr = *link;
+    if(!nodePtr->m_bKey)
+    {
+        return false;
+    }
+
+    nodePtr->m_bKey = false;
+    --m_numKeys;
+    if(nodePtr == m_root)
+    {
+        return true;
+    }
+
+    if(0 == nodePtr->m_numChildren)
+    {
+        RemoveChild(parentLink, childIndex);
+        CRadixNode<CharType>::Destroy(nodePtr);
+        --m_numNodes;
+
+        CRadixNode<CharType> *parentPtr = *parentLink;
+        if(parentPtr != m_root && !parentPtr->m_bKey
+                                    && 1 == parentPtr->m_numChildren)
+        {
+            MergeChild(parentLink);
+        }
+    }
+    else if(1 == nodePtr->m_numChildren)
+    {
+        MergeChild(link);
+    }
+
+    return true;
+
+}  // end of "CRadixTree<CharType>::DeleteItem"
+
+
+
+// ==== CRadixTree::DestroyNodes ==============================================
+//
+// This function recursively releases the nodes of a subtree.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the root of the subtree
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::DestroyNodes(CRadixNode<CharType>  *nodePtr)
+{
+    for(size_t i = 0; i < nodePtr->m_numChildren; ++i)
+    {
+        DestroyNodes(nodePtr->Children()[i]);
+    }
+    CRadixNode<CharType>::Destroy(nodePtr);
+
+}  // end of "CRadixTree<CharType>::DestroyNodes"
+
+
+
+// ==== CRadixTree::DestroyTree ===============================================
+//
+// This function releases every node in the tree, leaving an empty root.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::DestroyTree()
+{
+    DestroyNodes(m_root);
+    m_root = NewNode(KeyView(), false, 0);
+    m_numKeys = 0;
+    m_numNodes = 1;
+
+}  // end of "CRadixTree<CharType>::DestroyTree"
+
+
+
+// ==== CRadixTree::FindNode ==================================================
+//
+// This function follows the labels from the root to the node that spells out
+// the target exactly.  Each step picks a child by the next character and then
+// checks the rest of its label, so every character of the target is looked
+// at once.
+//
+// Access: protected
+//
+// Input:
+//      target [IN]     -- the characters to follow
+//
+// Output:
+//      A pointer to the node that spells out the target, or NULL if there is
+//      none.  The node may or may not hold a key.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixNode<CharType>*  CRadixTree<CharType>::FindNode(KeyView  target) const
+{
+    CRadixNode<CharType>    *nodePtr = m_root;
+    size_t                  pos = 0;
+    bool                    bFound;
+
+    while(pos < target.size())
+    {
+        size_t  index = ChildIndex(nodePtr, target[pos], bFound);
+        if(!bFound)
+        {
+            return NULL;
+        }
+
+        nodePtr = nodePtr->Children()[index];
+        if(target.substr(pos, nodePtr->m_labelLength) != nodePtr->Label())
+        {
+            return NULL;
+        }
+        pos += nodePtr->m_labelLength;
+    }
+
+    return nodePtr;
+
+}  // end of "CRadixTree<CharType>::FindNode"
+
+
+
+// ==== CRadixTree::GetTreeInfo ===============================================
+//
+// This function allows the caller to get the current number of keys and the
+// height of the tree.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- a reference to an int that will contain the total
+//                         number of keys currently in the tree (or INT_MAX if
+//                         there are more than an int can hold)
+//
+//      height [OUT]    -- a reference to an int that will contain the height
+//                         of the tree; this is a zero-based value that
+//                         represents the longest path from the root to a leaf
+//                         (counting edges, not the nodes)
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::GetTreeInfo(int  &numNodes, int  &height) const
+{
+    numNodes = (m_numKeys > static_cast<size_t>(INT_MAX)) ? INT_MAX
+                                        : static_cast<int>(m_numKeys);
+    height = CountHeight(m_root);
+
+}  // end of "CRadixTree<CharType>::GetTreeInfo"
+
+
+
+// ==== CRadixTree::InOrder ===================================================
+//
+// This recursive function visits the keys of a subtree in order.  A node's
+// own key comes before those of its children, since it is a prefix of them,
+// and the children are already sorted.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]        -- a pointer to the root of the subtree
+//
+//      prefix [IN/OUT]     -- the characters from the root down to nodePtr's
+//                             parent; the function appends to it, and
+//                             restores it before returning
+//
+//      fPtr [IN]           -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::InOrder(const CRadixNode<CharType>  *nodePtr
+                                        , KeyType  &prefix
+                                        , void (*fPtr)(const KeyType&)) const
+{
+    size_t  length = prefix.size();
+
+    prefix += nodePtr->Label();
+    if(nodePtr->m_bKey)
+    {
+        fPtr(prefix);
+    }
+    for(size_t i = 0; i < nodePtr->m_numChildren; ++i)
+    {
+        InOrder(nodePtr->Children()[i], prefix, fPtr);
+    }
+    prefix.resize(length);
+
+}  // end of "CRadixTree<CharType>::InOrder"
+
+
+
+// ==== CRadixTree::InOrderTraverse ===========================================
+//
+// This function visits every key in the tree in increasing order by calling
+// CRadixTree::InOrder.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::InOrderTraverse(
+                                void  (*fPtr)(const KeyType&)) const
+{
+    KeyType     prefix;
+
+    InOrder(m_root, prefix, fPtr);
+
+}  // end of "CRadixTree<CharType>::InOrderTraverse"
+
+
+
+// ==== CRadixTree::InsertItem ================================================
+//
+// This function allows the caller to insert a new key into the tree.  The
+// search follows the labels as far as they match the key.  If it stops part
+// way along a label, that edge is split in two at the mismatch with a new
+// node in between, and the old child is moved to a block with the shorter
+// label.  The rest of the key, if any, then becomes the label of a new leaf;
+// otherwise the node where the key ends is marked as a key.  The search keeps
+// the address of the link that holds the current node, since adding a child
+// may move the node to a larger block.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- the key to insert
+//
+// Output:
+//      A value of true if the key was successfully inserted into the tree,
+//      false if it was already there.
+//
+// ============================================================================
+
+template    <typename  CharType>
+bool    CRadixTree<CharType>::InsertItem(KeyView  newItem)
+{
+    CRadixNode<CharType>    **link = &m_root;
+    CRadixNode<CharType>    *nodePtr;
+    CRadixNode<CharType>    *childPtr;
+    size_t                  pos = 0;
+    bool                    bFound;
+
+    for(;;)
+    {
+        nodePtr = *link;
+        if(pos == newItem.size())
+        {
+            if(nodePtr->m_bKey)
+            {
+                return false;
+            }
+            nodePtr->m_bKey = true;
+            ++m_numKeys;
+            return true;
+        }
+
+        size_t  index = ChildIndex(nodePtr, newItem[pos], bFound);
+        if(!bFound)
+        {
+            AddChild(link, index, NewNode(newItem.substr(pos), true, 0));
+            ++m_numNodes;
+            ++m_numKeys;
+            return true;
+        }
+
+        childPtr = nodePtr->Children()[index];
+
+        KeyView     label = childPtr->Label();
+        size_t      common = 1;
+        while(common < label.size() && pos + common < newItem.size()
+                && char_traits<CharType>::eq(label[common]
+                                                , newItem[pos + common]))
+        {
+            ++common;
+        }
+
+        if(common < label.size())
+        {
+            CRadixNode<CharType> *splitPtr = NewNode(label.substr(0, common)
+                                                            , false, 1);
+            childPtr = Resize(childPtr, label.substr(common)
+                                                , childPtr->m_capacity);
+            splitPtr->Children()[0] = childPtr;
+            splitPtr->FirstChars()[0] = childPtr->Label()[0];
+            splitPtr->m_numChildren = 1;
+            nodePtr->Children()[index] = splitPtr;
+            ++m_numNodes;
+        }
+
+        link = &nodePtr->Children()[index];
+        pos += common;
+    }
+
+}  // end of "CRadixTree<CharType>::InsertItem"
+
+
+
+// ==== CRadixTree::ItemInTree ================================================
+//
+// This function allows the caller to determine if a key is in the tree.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- the key to search for
+//
+// Output:
+//      A value of true if the key is found, false if not.
+//
+// ============================================================================
+
+template    <typename  CharType>
+bool    CRadixTree<CharType>::ItemInTree(KeyView  target) const
+{
+    const CRadixNode<CharType>  *nodePtr = FindNode(target);
+
+    return (nodePtr != NULL && nodePtr->m_bKey);
+
+}  // end of "CRadixTree<CharType>::ItemInTree"
+
+
+
+// ==== CRadixTree::MergeChild ================================================
+//
+// This function folds the only child of a node that holds no key into the
+// node itself.  A new block is made whose label is the node's label followed
+// by the child's, and which takes over the child's key flag and children; it
+// replaces the node in the link that held it, and both old blocks are
+// released.
+//
+// Access: protected
+//
+// Input:
+//      link [IN/OUT]   -- the address of the link that holds the node, which
+//                         must have exactly one child
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::MergeChild(CRadixNode<CharType>  **link)
+{
+    CRadixNode<CharType>    *nodePtr = *link;
+    CRadixNode<CharType>    *childPtr = nodePtr->Children()[0];
+    KeyView                 head = nodePtr->Label();
+    KeyType                 label(head);
+
+    label += childPtr->Label();
+    *link = Resize(childPtr, label, childPtr->m_capacity);
+    CRadixNode<CharType>::Destroy(nodePtr);
+    --m_numNodes;
+
+}  // end of "CRadixTree<CharType>::MergeChild"
+
+
+
+// ==== CRadixTree::NewNode ===================================================
+//
+// This function makes a node with a given label and key flag, no children,
+// and room for a given number of them.
+//
+// Access: protected
+//
+// Input:
+//      label [IN]      -- the label of the new node
+//
+//      bKey [IN]       -- true if the new node ends a key
+//
+//      capacity [IN]   -- the number of children there is room for
+//
+// Output:
+//      A pointer to the new node.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixNode<CharType>*  CRadixTree<CharType>::NewNode(KeyView  label
+                                                    , bool  bKey
+                                                    , size_t  capacity)
+{
+    CRadixNode<CharType>    *nodePtr = CRadixNode<CharType>::Create(
+                                                label.size(), capacity);
+
+    char_traits<CharType>::copy(nodePtr->LabelChars(), label.data()
+                                                        , label.size());
+    nodePtr->m_bKey = bKey;
+    return nodePtr;
+
+}  // end of "CRadixTree<CharType>::NewNode"
+
+
+
+// ==== CRadixTree::Range =====================================================
+//
+// This recursive function visits, in order, the keys of a subtree that lie
+// between two bounds.  Every key below a node starts with the node's prefix,
+// so the subtree is skipped entirely if the prefix already orders after the
+// upper bound, or orders before the lower bound without being a prefix of it.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]        -- a pointer to the root of the subtree
+//
+//      prefix [IN/OUT]     -- the characters from the root down to nodePtr's
+//                             parent; the function appends to it, and
+//                             restores it before returning
+//
+//      low [IN]            -- the smallest key to visit
+//
+//      high [IN]           -- the largest key to visit
+//
+//      fPtr [IN]           -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::Range(const CRadixNode<CharType>  *nodePtr
+                                        , KeyType  &prefix
+                                        , KeyView  low, KeyView  high
+                                        , void (*fPtr)(const KeyType&)) const
+{
+    size_t  length = prefix.size();
+
+    prefix += nodePtr->Label();
+
+    KeyView     path(prefix);
+    if(path.compare(high) <= 0 && (path.compare(low) >= 0
+                                || low.substr(0, path.size()) == path))
+    {
+        if(nodePtr->m_bKey && path.compare(low) >= 0)
+        {
+            fPtr(prefix);
+        }
+        for(size_t i = 0; i < nodePtr->m_numChildren; ++i)
+        {
+            Range(nodePtr->Children()[i], prefix, low, high, fPtr);
+        }
+    }
+
+    prefix.resize(length);
+
+}  // end of "CRadixTree<CharType>::Range"
+
+
+
+// ==== CRadixTree::RangeTraverse =============================================
+//
+// This function visits, in increasing order, every key in the tree from low
+// to high (both inclusive) by calling CRadixTree::Range.
+//
+// Access: public
+//
+// Input:
+//      low [IN]        -- the smallest key to visit
+//
+//      high [IN]       -- the largest key to visit
+//
+//      fPtr [IN]       -- a pointer to the function to call for each key
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::RangeTraverse(KeyView  low, KeyView  high
+                                    , void  (*fPtr)(const KeyType&)) const
+{
+    KeyType     prefix;
+
+    Range(m_root, prefix, low, high, fPtr);
+
+}  // end of "CRadixTree<CharType>::RangeTraverse"
+
+
+
+// ==== CRadixTree::RemoveChild ===============================================
+//
+// This function unlinks a child from a node's arrays; the child itself is
+// not released.  If that leaves the node's size class a quarter full or
+// less, the node is moved into a block of the smaller class, and the link
+// that held it is updated.
+//
+// Access: protected
+//
+// Input:
+//      link [IN/OUT]   -- the address of the link that holds the node
+//
+//      index [IN]      -- the position of the child to unlink
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  CharType>
+void    CRadixTree<CharType>::RemoveChild(CRadixNode<CharType>  **link
+                                                    , size_t  index)
+{
+    CRadixNode<CharType>    *nodePtr = *link;
+    CRadixNode<CharType>    **children = nodePtr->Children();
+    CharType                *firstChars = nodePtr->FirstChars();
+    size_t                  count = --nodePtr->m_numChildren;
+
+    for(size_t i = index; i < count; ++i)
+    {
+        children[i] = children[i + 1];
+        firstChars[i] = firstChars[i + 1];
+    }
+
+    if(count <= nodePtr->m_capacity / 4)
+    {
+        *link = Resize(nodePtr, nodePtr->Label()
+                                    , CRadixNode<CharType>::SizeClass(count));
+    }
+
+}  // end of "CRadixTree<CharType>::RemoveChild"
+
+
+
+// ==== CRadixTree::Resize ====================================================
+//
+// This function moves a node into a new block with a given label and room for
+// a given number of children, keeping its key flag and children, and
+// releases the old block.  It serves both to change a node's size class and
+// to change its label.
+//
+// Access: protected
+//
+// Input:
+//      nodePtr [IN]    -- a pointer to the node to move
+//
+//      label [IN]      -- the label of the new block; it may refer to the old
+//                         node's own label
+//
+//      capacity [IN]   -- the number of children there is room for, at least
+//                         the number the node has
+//
+// Output:
+//      A pointer to the node in its new block.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixNode<CharType>*  CRadixTree<CharType>::Resize(
+                                        CRadixNode<CharType>  *nodePtr
+                                        , KeyView  label, size_t  capacity)
+{
+    CRadixNode<CharType>    *newPtr = NewNode(label, nodePtr->m_bKey
+                                                            , capacity);
+
+    for(size_t i = 0; i < nodePtr->m_numChildren; ++i)
+    {
+        newPtr->Children()[i] = nodePtr->Children()[i];
+        newPtr->FirstChars()[i] = nodePtr->FirstChars()[i];
+    }
+    newPtr->m_numChildren = nodePtr->m_numChildren;
+    CRadixNode<CharType>::Destroy(nodePtr);
+    return newPtr;
+
+}  // end of "CRadixTree<CharType>::Resize"
+
+
+
+// ==== CRadixTree::operator= =================================================
+//
+// This is the overloaded assignment operator for the CRadixTree class.  It
+// first checks for assignment to self, then releases all of the nodes in the
+// calling object and replicates the parameter's tree with CopyTree.
+//
+// Access: public
+//
+// Input:
+//      rhs [IN]    -- a const reference to an existing CRadixTree object
+//
+// Output:
+//      A reference to the calling object.
+//
+// ============================================================================
+
+template    <typename  CharType>
+CRadixTree<CharType>&  CRadixTree<CharType>::operator=(
+                                    const CRadixTree<CharType>  &rhs)
+{
+    if(this != &rhs)
+    {
+        DestroyNodes(m_root);
+        m_root = CopyTree(rhs.m_root);
+        m_numKeys = rhs.m_numKeys;
+        m_numNodes = rhs.m_numNodes;
+    }
+    return *this;
+
+}  // end of "CRadixTree<CharType>::operator="
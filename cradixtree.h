@@ -0,0 +1,101 @@
+// ============================================================================
+// File: cradixtree.h
+// ============================================================================
+// This header file contains the declaration of the CRadixTree class, an
+// ordered set of strings.  It uses the template parameter "CharType" for the
+// character type of the keys, which are std::basic_string<CharType> values.
+//
+// A CBSTree of strings keeps a full copy of every key in its own node and
+// compares whole strings at each level.  A radix tree instead stores each
+// shared prefix once: every edge is labelled with a run of characters (see
+// cradixnode.h), a key is spelled out by the labels on the path from the root
+// to its node, and a node with a single child is always merged into it.  For
+// keys such as URLs and file paths, which share long prefixes, this saves a
+// great deal of memory, and a lookup costs O(key length) no matter how many
+// keys there are.
+//
+// The interface follows CBSTree.  Keys are passed as string views, so either
+// strings or string literals can be used.  InOrderTraverse visits the keys in
+// the order of std::basic_string's own comparison, and RangeTraverse visits
+// only those between two bounds, skipping whole subtrees that fall outside
+// them.  GetTreeInfo reports the number of keys and the height of the tree in
+// nodes; GetNumNodes reports how many nodes hold them.
+// ============================================================================
+
+#ifndef CRADIX_TREE_HEADER
+#define CRADIX_TREE_HEADER
+
+#include    <string>
+#include    <string_view>
+#include    <vector>
+using namespace std;
+#include    "cradixnode.h"
+
+// class declaration
+template    <typename  CharType = char>
+class   CRadixTree
+{
+public:
+    // the key types
+    typedef basic_string<CharType>          KeyType;
+    typedef basic_string_view<CharType>     KeyView;
+
+    // constructors and destructor
+    CRadixTree() : m_root(NewNode(KeyView(), false, 0)), m_numKeys(0)
+                                                    , m_numNodes(1) {}
+    CRadixTree(const CRadixTree  &other);
+    virtual ~CRadixTree() { DestroyNodes(m_root); }
+
+    // member functions
+    bool    DeleteItem(KeyView  target);
+    void    DestroyTree();
+    size_t  GetNumNodes() const { return m_numNodes; }
+    void    GetTreeInfo(int  &numNodes, int  &height) const;
+    void    InOrderTraverse(void  (*fPtr)(const KeyType&)) const;
+    bool    InsertItem(KeyView  newItem);
+    bool    IsTreeEmpty() const { return (0 == m_numKeys); }
+    bool    ItemInTree(KeyView  target) const;
+    void    RangeTraverse(KeyView  low, KeyView  high
+                                        , void  (*fPtr)(const KeyType&)) const;
+
+    // operators
+    CRadixTree<CharType>&  operator=(const CRadixTree<CharType>  &rhs);
+
+protected:
+    // member functions
+    void                    AddChild(CRadixNode<CharType>  **link
+                                        , size_t  index
+                                        , CRadixNode<CharType>  *childPtr);
+    static size_t           ChildIndex(const CRadixNode<CharType>  *nodePtr
+                                        , CharType  first, bool  &bFound);
+    int                     CountHeight(const CRadixNode<CharType>  *nodePtr)
+                                                                    const;
+    void                    DestroyNodes(CRadixNode<CharType>  *nodePtr);
+    CRadixNode<CharType>*   FindNode(KeyView  target) const;
+    void                    InOrder(const CRadixNode<CharType>  *nodePtr
+                                        , KeyType  &prefix
+                                        , void (*fPtr)(const KeyType&)) const;
+    void                    MergeChild(CRadixNode<CharType>  **link);
+    static CRadixNode<CharType>*    NewNode(KeyView  label, bool  bKey
+                                        , size_t  capacity);
+    void                    Range(const CRadixNode<CharType>  *nodePtr
+                                        , KeyType  &prefix
+                                        , KeyView  low, KeyView  high
+                                        , void (*fPtr)(const KeyType&)) const;
+    void                    RemoveChild(CRadixNode<CharType>  **link
+                                        , size_t  index);
+    static CRadixNode<CharType>*    Resize(CRadixNode<CharType>  *nodePtr
+                                        , KeyView  label, size_t  capacity);
+
+private:
+    // member functions
+    CRadixNode<CharType>*   CopyTree(const CRadixNode<CharType>  *sourcePtr);
+
+    // data members (the root has an empty label and is never removed)
+    CRadixNode<CharType>    *m_root;
+    size_t                  m_numKeys;
+    size_t                  m_numNodes;
+};
+
+#include    "cradixtree.cpp"
+#endif  // CRADIX_TREE_HEADER
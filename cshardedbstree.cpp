@@ -0,0 +1,483 @@
+// ============================================================================
+// File: cshardedbstree.cpp
+// ============================================================================
+// This file contains the implementation of the CShardedBSTree class. It uses
+// the template parameter "NodeType" for the type of values that are stored in
+// the tree, and the template parameter "Compare" for the function object that
+// orders them.
+// ============================================================================
+
+#include    <algorithm>
+#include    <cstdint>
+#include    <functional>
+#include    <type_traits>
+using namespace std;
+#include    "cshardedbstree.h"
+
+
+// ==== CShardedBSTree::CShardedBSTree ========================================
+//
+// This constructor creates an empty tree whose items are assigned to shards
+// by hash.  NodeType must be hashable with std::hash.
+//
+// Access: public
+//
+// Input:
+//      numShards [IN]  -- the number of shards (at least one is created)
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+CShardedBSTree<NodeType, Compare>::CShardedBSTree(size_t  numShards)
+                                        : m_shards(NULL)
+                                        , m_numShards(numShards < 1 ? 1
+                                                                : numShards)
+                                        , m_shardMode(SHARD_BY_HASH)
+{
+    m_shards = new CShard[m_numShards];
+
+}  // end of "CShardedBSTree<NodeType>::CShardedBSTree"
+
+
+
+// ==== CShardedBSTree::CShardedBSTree ========================================
+//
+// This constructor creates an empty tree whose items are assigned to shards
+// by range.  There is one more shard than there are split points: shard 0
+// holds the items that order before splitPoints[0], shard i holds those from
+// splitPoints[i - 1] up to (but not including) splitPoints[i], and the last
+// shard holds everything from the last split point on.
+//
+// Access: public
+//
+// Input:
+//      splitPoints [IN]    -- the boundaries between shards, in increasing
+//                             order
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+CShardedBSTree<NodeType, Compare>::CShardedBSTree(
+                                        const vector<NodeType>  &splitPoints)
+                                        : m_shards(NULL)
+                                        , m_numShards(splitPoints.size() + 1)
+                                        , m_shardMode(SHARD_BY_RANGE)
+                                        , m_splitPoints(splitPoints)
+{
+    m_shards = new CShard[m_numShards];
+
+}  // end of "CShardedBSTree<NodeType>::CShardedBSTree"
+
+
+
+// ==== CShardedBSTree::DeleteItem ============================================
+//
+// This function deletes a target item from the shard that owns it, holding
+// only that shard's lock.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object
+//
+// Output:
+//      A value of false if the target item is not in the tree, otherwise a
+//      value of true is returned and the item is removed from the tree.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CShardedBSTree<NodeType, Compare>::DeleteItem(const NodeType  &target)
+{
+    CShard  &shard = m_shards[ShardOf(target)];
+    lock_guard<mutex>   guard(shard.m_lock);
+
+    return shard.m_tree.DeleteItem(target);
+
+}  // end of "CShardedBSTree<NodeType>::DeleteItem"
+
+
+
+// ==== CShardedBSTree::DestroyTree ===========================================
+//
+// This function releases every node in every shard.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CShardedBSTree<NodeType, Compare>::DestroyTree()
+{
+    vector<unique_lock<mutex> > guards;
+
+    LockAll(guards);
+    for(size_t i = 0; i < m_numShards; ++i)
+    {
+        m_shards[i].m_tree.DestroyTree();
+    }
+
+}  // end of "CShardedBSTree<NodeType>::DestroyTree"
+
+
+
+// ==== CShardedBSTree::GetTreeInfo ===========================================
+//
+// This function reports the total number of items in the tree and the height
+// of the tallest shard, which bounds the work of any single lookup.
+//
+// Access: public
+//
+// Input:
+//      numNodes [OUT]  -- the number of items in all of the shards
+//
+//      height [OUT]    -- the height of the tallest shard
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CShardedBSTree<NodeType, Compare>::GetTreeInfo(size_t  &numNodes
+                                                    , size_t  &height) const
+{
+    vector<unique_lock<mutex> > guards;
+    size_t                      shardNodes;
+    size_t                      shardHeight;
+
+    numNodes = 0;
+    height = 0;
+    LockAll(guards);
+    for(size_t i = 0; i < m_numShards; ++i)
+    {
+        m_shards[i].m_tree.GetTreeInfo(shardNodes, shardHeight);
+        numNodes += shardNodes;
+        if(shardHeight > height)
+        {
+            height = shardHeight;
+        }
+    }
+
+}  // end of "CShardedBSTree<NodeType>::GetTreeInfo"
+
+
+
+// ==== CShardedBSTree::InOrderTraverse =======================================
+//
+// This function visits every item in the tree in order.  Range shards are
+// already ordered with respect to each other, so they are traversed one after
+// the other.  Hash shards are merged: each shard is walked by a cursor of its
+// own (see CBSTree::CInOrderCursor), and a heap of the shards, ordered by the
+// item each cursor is on, yields the smallest of those items and then takes
+// that shard's next one, in O(log S) steps for S shards.  No items are
+// copied.
+//
+// Access: public
+//
+// Input:
+//      fPtr [IN]       -- a pointer to the function to call for each item
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CShardedBSTree<NodeType, Compare>::InOrderTraverse(
+                                void  (*fPtr)(const NodeType&)) const
+{
+    vector<unique_lock<mutex> > guards;
+
+    LockAll(guards);
+    if(SHARD_BY_RANGE == m_shardMode)
+    {
+        for(size_t i = 0; i < m_numShards; ++i)
+        {
+            m_shards[i].m_tree.InOrderTraverse(fPtr);
+        }
+        return;
+    }
+
+    vector<CCursor> cursors;
+    vector<size_t>  heap;
+    auto            laterHead = [&cursors, this](size_t  lhs, size_t  rhs)
+                                { return OrdersBefore(cursors[rhs].Current()
+                                                , cursors[lhs].Current()); };
+
+    cursors.reserve(m_numShards);
+    for(size_t i = 0; i < m_numShards; ++i)
+    {
+        cursors.push_back(CCursor(m_shards[i].m_tree));
+        if(!cursors[i].AtEnd())
+        {
+            heap.push_back(i);
+        }
+    }
+    make_heap(heap.begin(), heap.end(), laterHead);
+
+    while(!heap.empty())
+    {
+        pop_heap(heap.begin(), heap.end(), laterHead);
+        CCursor &cursor = cursors[heap.back()];
+        fPtr(cursor.Current());
+        cursor.Next();
+        if(cursor.AtEnd())
+        {
+            heap.pop_back();
+        }
+        else
+        {
+            push_heap(heap.begin(), heap.end(), laterHead);
+        }
+    }
+
+}  // end of "CShardedBSTree<NodeType>::InOrderTraverse"
+
+
+
+// ==== CShardedBSTree::InsertItem ============================================
+//
+// This function inserts a new item into the shard that owns it, holding only
+// that shard's lock.
+//
+// Access: public
+//
+// Input:
+//      newItem [IN]    -- a const reference a NodeType object
+//
+// Output:
+//      A value of true if the item was successfully inserted into the tree,
+//      false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CShardedBSTree<NodeType, Compare>::InsertItem(const NodeType  &newItem)
+{
+    CShard  &shard = m_shards[ShardOf(newItem)];
+    lock_guard<mutex>   guard(shard.m_lock);
+
+    return shard.m_tree.InsertItem(newItem);
+
+}  // end of "CShardedBSTree<NodeType>::InsertItem"
+
+
+
+// ==== CShardedBSTree::IsTreeEmpty ===========================================
+//
+// This function checks whether every shard is empty.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      A value of true if there are no items in the tree, false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CShardedBSTree<NodeType, Compare>::IsTreeEmpty() const
+{
+    vector<unique_lock<mutex> > guards;
+    bool                        bEmpty = true;
+
+    LockAll(guards);
+    for(size_t i = 0; i < m_numShards && bEmpty; ++i)
+    {
+        bEmpty = m_shards[i].m_tree.IsTreeEmpty();
+    }
+    return bEmpty;
+
+}  // end of "CShardedBSTree<NodeType>::IsTreeEmpty"
+
+
+
+// ==== CShardedBSTree::ItemInTree ============================================
+//
+// This function searches the shard that owns the target, holding only that
+// shard's lock.  The lock is needed even though the search does not change
+// any items, because a shard in BALANCE_SPLAY mode restructures itself on
+// every lookup.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object that contains
+//                         the target key value to search for
+//
+// Output:
+//      A value of true if the target item is found, false if not.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CShardedBSTree<NodeType, Compare>::ItemInTree(const NodeType  &target)
+                                                                        const
+{
+    const CShard    &shard = m_shards[ShardOf(target)];
+    lock_guard<mutex>   guard(shard.m_lock);
+
+    return shard.m_tree.ItemInTree(target);
+
+}  // end of "CShardedBSTree<NodeType>::ItemInTree"
+
+
+
+// ==== CShardedBSTree::LockAll ===============================================
+//
+// This function locks every shard, adding a guard for each lock to the
+// caller's list; the locks are released when the list goes out of scope,
+// even if a traversal callback or an allocation throws.  The locks are always
+// taken in index order, so two threads locking all of the shards cannot
+// deadlock.  The list is sized first, so if taking a lock fails, the locks
+// already taken are released with it.
+//
+// Access: protected
+//
+// Input:
+//      guards [OUT]    -- the caller's (empty) list of lock guards
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CShardedBSTree<NodeType, Compare>::LockAll(
+                                vector<unique_lock<mutex> >  &guards) const
+{
+    guards.reserve(m_numShards);
+    for(size_t i = 0; i < m_numShards; ++i)
+    {
+        guards.push_back(unique_lock<mutex>(m_shards[i].m_lock));
+    }
+
+}  // end of "CShardedBSTree<NodeType>::LockAll"
+
+
+
+// ==== CShardedBSTree::OrdersBefore ==========================================
+//
+// This function asks the Compare object whether lhs orders before rhs.  Like
+// CBSTree, it accepts both three-way comparators and less-than predicates.
+//
+// Access: protected
+//
+// Input:
+//      lhs [IN]    -- a const reference to the left-hand value
+//
+//      rhs [IN]    -- a const reference to the right-hand value
+//
+// Output:
+//      A value of true if lhs orders before rhs, false otherwise.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+bool    CShardedBSTree<NodeType, Compare>::OrdersBefore(const NodeType  &lhs
+                                                , const NodeType  &rhs) const
+{
+    typedef decltype(m_compare(lhs, rhs))   ResultType;
+
+    if constexpr (is_same<typename decay<ResultType>::type, bool>::value)
+    {
+        return m_compare(lhs, rhs);
+    }
+    else
+    {
+        return m_compare(lhs, rhs) < 0;
+    }
+
+}  // end of "CShardedBSTree<NodeType>::OrdersBefore"
+
+
+
+// ==== CShardedBSTree::RebalanceTree =========================================
+//
+// This function rebalances every shard.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+void    CShardedBSTree<NodeType, Compare>::RebalanceTree()
+{
+    vector<unique_lock<mutex> > guards;
+
+    LockAll(guards);
+    for(size_t i = 0; i < m_numShards; ++i)
+    {
+        m_shards[i].m_tree.RebalanceTree();
+    }
+
+}  // end of "CShardedBSTree<NodeType>::RebalanceTree"
+
+
+
+// ==== CShardedBSTree::ShardOf ===============================================
+//
+// This function picks the shard that owns an item.  For range shards it is
+// the number of split points that do not order after the item, found with a
+// binary search.  For hash shards the std::hash value is mixed (for integers
+// it is often the value itself) and reduced modulo the number of shards.
+//
+// Access: protected
+//
+// Input:
+//      item [IN]       -- a const reference to the item
+//
+// Output:
+//      The index of the shard that owns the item.
+//
+// ============================================================================
+
+template    <typename  NodeType, typename  Compare>
+size_t  CShardedBSTree<NodeType, Compare>::ShardOf(const NodeType  &item) const
+{
+    if(SHARD_BY_RANGE == m_shardMode)
+    {
+        size_t  low = 0;
+        size_t  high = m_splitPoints.size();
+        while(low < high)
+        {
+            size_t  middle = low + (high - low) / 2;
+            if(OrdersBefore(item, m_splitPoints[middle]))
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+        return low;
+    }
+
+    uint64_t    mixed = 0;
+    if constexpr (is_default_constructible<hash<NodeType> >::value)
+    {
+        mixed = hash<NodeType>()(item);
+    }
+    mixed ^= mixed >> 33;
+    mixed *= 0xFF51AFD7ED558CCDull;
+    mixed ^= mixed >> 33;
+
+    return static_cast<size_t>(mixed % m_numShards);
+
+}  // end of "CShardedBSTree<NodeType>::ShardOf"
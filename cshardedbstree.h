@@ -0,0 +1,94 @@
+// ============================================================================
+// File: cshardedbstree.h
+// ============================================================================
+// This header file contains the declaration of the CShardedBSTree class. It
+// uses the template parameter "NodeType" for the type of values that are
+// stored in the tree, and the template parameter "Compare" for the function
+// object that orders them (see cbstree.h).
+//
+// The key space is split across a fixed number of CBSTree shards, and each
+// shard has its own mutex.  InsertItem, DeleteItem and ItemInTree lock only
+// the shard that owns the item, so threads working on different shards run in
+// parallel instead of queueing on one lock.
+//
+// Items can be assigned to shards in one of two ways.  With SHARD_BY_HASH, an
+// item goes to the shard picked by its std::hash value, which spreads any
+// workload evenly but scatters neighbouring keys.  With SHARD_BY_RANGE, the
+// caller supplies sorted split points and each shard owns one range, so
+// shards hold contiguous runs of keys.  InOrderTraverse visits the items in
+// order either way: range shards are simply walked one after the other, while
+// hash shards are merged through a heap of per-shard cursors.
+//
+// The functions that look at every shard (DestroyTree, GetTreeInfo,
+// InOrderTraverse, IsTreeEmpty, RebalanceTree) lock all of the shards in index
+// order, so they see a consistent snapshot and cannot deadlock with each
+// other.  The locks are held by guards, so they are released even if a
+// callback or an allocation throws.  A traversal callback runs with those
+// locks held, so it must not call back into the same tree.
+// ============================================================================
+
+#ifndef CSHARDED_BIN_SEARCH_TREE_HEADER
+#define CSHARDED_BIN_SEARCH_TREE_HEADER
+
+#include    <mutex>
+#include    <vector>
+using namespace std;
+#include    "cbstree.h"
+
+// the ways a CShardedBSTree can assign items to shards
+enum    ShardMode { SHARD_BY_HASH, SHARD_BY_RANGE };
+
+// class declaration
+template    <typename  NodeType, typename  Compare = CThreeWayCompare<NodeType> >
+class   CShardedBSTree
+{
+public:
+    // constructors and destructor
+    explicit CShardedBSTree(size_t  numShards);
+    explicit CShardedBSTree(const vector<NodeType>  &splitPoints);
+    virtual ~CShardedBSTree() { delete [] m_shards; }
+
+    // member functions
+    bool    DeleteItem(const NodeType  &target);
+    void    DestroyTree();
+    size_t  GetNumShards() const { return m_numShards; }
+    ShardMode   GetShardMode() const { return m_shardMode; }
+    void    GetTreeInfo(size_t  &numNodes, size_t  &height) const;
+    void    InOrderTraverse(void  (*fPtr)(const NodeType&)) const;
+    bool    InsertItem(const NodeType  &newItem);
+    bool    IsTreeEmpty() const;
+    bool    ItemInTree(const NodeType  &target) const;
+    void    RebalanceTree();
+
+    // the shards hold mutexes, so the tree cannot be copied
+    CShardedBSTree(const CShardedBSTree  &other) = delete;
+    CShardedBSTree&  operator=(const CShardedBSTree  &rhs) = delete;
+
+protected:
+    // one shard: a tree and the lock that guards it
+    struct  CShard
+    {
+        CBSTree<NodeType, Compare>  m_tree;
+        mutable mutex               m_lock;
+    };
+
+    // walks one shard's items in order during a hash-sharded traversal
+    typedef typename CBSTree<NodeType, Compare>::CInOrderCursor  CCursor;
+
+    // member functions
+    void                    LockAll(vector<unique_lock<mutex> >  &guards)
+                                                                    const;
+    bool                    OrdersBefore(const NodeType  &lhs
+                                        , const NodeType  &rhs) const;
+    size_t                  ShardOf(const NodeType  &item) const;
+
+    // data members
+    CShard                  *m_shards;
+    size_t                  m_numShards;
+    ShardMode               m_shardMode;
+    vector<NodeType>        m_splitPoints;
+    Compare                 m_compare;
+};
+
+#include    "cshardedbstree.cpp"
+#endif  // CSHARDED_BIN_SEARCH_TREE_HEADER
@@ -0,0 +1,331 @@
+// ============================================================================
+// File: csmallarray.cpp
+// ============================================================================
+// This file contains the implementation of the CSmallArray class.  It uses
+// the template parameter "ItemType" for the type of the items it holds.
+// ============================================================================
+
+#include    <new>
+#include    <utility>
+using namespace std;
+#include    "csmallarray.h"
+
+
+// ==== CSmallArray::assign ===================================================
+//
+// This function replaces the contents of the array with copies of a range of
+// items.
+//
+// Access: public
+//
+// Input:
+//      first [IN]      -- a pointer to the first item to copy
+//
+//      last [IN]       -- a pointer just past the last item to copy
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::assign(const ItemType  *first
+                                                , const ItemType  *last)
+{
+    size_t      count = static_cast<size_t>(last - first);
+    ItemType    *items;
+
+    clear();
+    if(0 == count)
+    {
+        return;
+    }
+
+    reserve(count);
+    items = data();
+    for(size_t i = 0; i < count; ++i)
+    {
+        new(&items[i]) ItemType(first[i]);
+        ++m_block->m_size;
+    }
+
+}  // end of "CSmallArray<ItemType>::assign"
+
+
+
+// ==== CSmallArray::clear ====================================================
+//
+// This function destroys every item in the array.  The block is kept, so the
+// array can fill up again without allocating, and the array starts at the
+// front of it again.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::clear()
+{
+    ItemType    *items = data();
+
+    for(size_t i = 0; i < size(); ++i)
+    {
+        items[i].~ItemType();
+    }
+    if(m_block != NULL)
+    {
+        m_block->m_start = 0;
+        m_block->m_size = 0;
+    }
+
+}  // end of "CSmallArray<ItemType>::clear"
+
+
+
+// ==== CSmallArray::erase ====================================================
+//
+// This function removes a range of items from the array.  The items after
+// the range are moved down to close the gap, unless the range starts at the
+// front of the array: then the start of the array is moved up past it
+// instead, so removing the first item is O(1).  An array that is left empty
+// starts at the front of its block again.
+//
+// Access: public
+//
+// Input:
+//      first [IN]      -- a pointer to the first item to remove
+//
+//      last [IN]       -- a pointer just past the last item to remove
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::erase(ItemType  *first, ItemType  *last)
+{
+    ItemType    *endPtr = end();
+    ItemType    *destPtr = first;
+
+    if(first == last)
+    {
+        return;
+    }
+
+    if(first == begin())
+    {
+        for(; destPtr != last; ++destPtr)
+        {
+            destPtr->~ItemType();
+        }
+        m_block->m_start += static_cast<uint32_t>(last - first);
+    }
+    else
+    {
+        for(ItemType *srcPtr = last; srcPtr != endPtr
+                                                ; ++srcPtr, ++destPtr)
+        {
+            *destPtr = std::move(*srcPtr);
+        }
+        for(; destPtr != endPtr; ++destPtr)
+        {
+            destPtr->~ItemType();
+        }
+    }
+
+    m_block->m_size -= static_cast<uint32_t>(last - first);
+    if(0 == m_block->m_size)
+    {
+        m_block->m_start = 0;
+    }
+
+}  // end of "CSmallArray<ItemType>::erase"
+
+
+
+// ==== CSmallArray::insert ===================================================
+//
+// This function inserts a copy of an item into the array, in front of a
+// given position.  If there is no room after the last item, the items are
+// first slid down to the front of the block when the room in front of them
+// is at least as large as they are (see CSmallArray::SlideDown), and the
+// block is replaced by one twice the size otherwise.
+//
+// Access: public
+//
+// Input:
+//      position [IN]   -- a pointer to the item to insert in front of, or to
+//                         the end of the array
+//
+//      item [IN]       -- a const reference to the item to insert
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::insert(ItemType  *position
+                                                , const ItemType  &item)
+{
+    size_t      index = static_cast<size_t>(position - data());
+    size_t      count = size();
+    ItemType    *items;
+
+    if(count == capacity())
+    {
+        if(m_block != NULL && m_block->m_start >= count)
+        {
+            SlideDown();
+        }
+        else
+        {
+            reserve((count < MIN_CAPACITY) ? MIN_CAPACITY : 2 * count);
+        }
+    }
+
+    items = data();
+    if(index == count)
+    {
+        new(&items[count]) ItemType(item);
+    }
+    else
+    {
+        new(&items[count]) ItemType(std::move(items[count - 1]));
+        for(size_t i = count - 1; i > index; --i)
+        {
+            items[i] = std::move(items[i - 1]);
+        }
+        items[index] = item;
+    }
+    ++m_block->m_size;
+
+}  // end of "CSmallArray<ItemType>::insert"
+
+
+
+// ==== CSmallArray::Release ==================================================
+//
+// This function destroys every item in the array and frees its block, which
+// leaves the array empty and without a block.
+//
+// Access: public
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::Release()
+{
+    clear();
+    ::operator delete(m_block);
+    m_block = NULL;
+
+}  // end of "CSmallArray<ItemType>::Release"
+
+
+
+// ==== CSmallArray::reserve ==================================================
+//
+// This function makes room for a given number of items, counted from the
+// first item.  If the block is too small, a new one of exactly that size is
+// allocated, the items are moved to the front of it and the old block is
+// freed.
+//
+// Access: public
+//
+// Input:
+//      newCapacity [IN]    -- the number of items to make room for
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::reserve(size_t  newCapacity)
+{
+    size_t      count = size();
+    CHeader     *newBlock;
+    ItemType    *items;
+    ItemType    *newItems;
+
+    if(newCapacity <= capacity())
+    {
+        return;
+    }
+
+    newBlock = new(::operator new(ITEMS_OFFSET
+                                    + newCapacity * sizeof(ItemType))) CHeader;
+    newBlock->m_start = 0;
+    newBlock->m_size = static_cast<uint32_t>(count);
+    newBlock->m_capacity = static_cast<uint32_t>(newCapacity);
+    newItems = Items(newBlock);
+    items = data();
+    for(size_t i = 0; i < count; ++i)
+    {
+        new(&newItems[i]) ItemType(std::move(items[i]));
+        items[i].~ItemType();
+    }
+
+    ::operator delete(m_block);
+    m_block = newBlock;
+
+}  // end of "CSmallArray<ItemType>::reserve"
+
+
+
+// ==== CSmallArray::SlideDown ================================================
+//
+// This function moves the items down to the front of the block, to take back
+// the room that removing items from the front has left there.  Slots that
+// were empty are move-constructed into, slots that held items are
+// move-assigned, and the slots the items have left are destroyed.
+//
+// Access: private
+//
+// Input:
+//      Nothing
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+template    <typename  ItemType>
+void    CSmallArray<ItemType>::SlideDown()
+{
+    size_t      start = m_block->m_start;
+    size_t      count = m_block->m_size;
+    ItemType    *items = Items(m_block);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(i < start)
+        {
+            new(&items[i]) ItemType(std::move(items[start + i]));
+        }
+        else
+        {
+            items[i] = std::move(items[start + i]);
+        }
+    }
+    for(size_t i = (start > count) ? start : count; i < start + count; ++i)
+    {
+        items[i].~ItemType();
+    }
+    m_block->m_start = 0;
+
+}  // end of "CSmallArray<ItemType>::SlideDown"
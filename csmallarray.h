@@ -0,0 +1,112 @@
+// ============================================================================
+// File: csmallarray.h
+// ============================================================================
+// This header file contains the declaration of the CSmallArray class.  It uses
+// the template parameter "ItemType" for the type of the items it holds.
+//
+// A CSmallArray is a growable array, like a vector, that is one pointer wide:
+// the number of items and the room for them are kept in a small header at
+// the front of the block that holds the items, and an empty array has no
+// block at all.  It is what a CBSTree keeps its small set in (see
+// CSmallSet in cbstreepolicy.h), in a union with the root of its nodes, so a
+// small tree pays for one word and one block.  The tree's cached spines are
+// CSmallArrays as well.
+//
+// Items can be removed from either end in O(1).  Removing items from the
+// front only moves the start of the array up its block; the room left in
+// front is taken back by sliding the items down when the block fills up,
+// but only once it is at least as large as the items themselves, so each
+// item is slid O(1) times on average and the block stays within a constant
+// factor of the items it holds.
+//
+// It cannot be copied; use assign.  An item passed to insert or push_back
+// must not be one of the array's own items.  A CSmallArray can be a member of
+// a union, whose owner must then construct and destroy it explicitly.
+// ============================================================================
+
+#ifndef CSMALL_ARRAY_HEADER
+#define CSMALL_ARRAY_HEADER
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <new>
+#include    <utility>
+using namespace std;
+
+// class declaration
+template    <typename  ItemType>
+class   CSmallArray
+{
+public:
+    // member functions that look at the contents
+    ItemType*           begin() { return data(); }
+    const ItemType*     begin() const { return data(); }
+    size_t              capacity() const { return (NULL == m_block) ? 0
+                            : m_block->m_capacity - m_block->m_start; }
+    ItemType*           data() { return (NULL == m_block) ? NULL
+                                    : Items(m_block) + m_block->m_start; }
+    const ItemType*     data() const { return const_cast<CSmallArray*>(
+                                                            this)->data(); }
+    bool                empty() const { return (0 == size()); }
+    ItemType*           end() { return data() + size(); }
+    const ItemType*     end() const { return data() + size(); }
+    size_t              size() const { return (NULL == m_block) ? 0
+                                                : m_block->m_size; }
+
+    // element access
+    ItemType&           back() { return data()[size() - 1]; }
+    const ItemType&     back() const { return data()[size() - 1]; }
+    ItemType&           front() { return *data(); }
+    const ItemType&     front() const { return *data(); }
+    ItemType&           operator[](size_t  index) { return data()[index]; }
+    const ItemType&     operator[](size_t  index) const
+                                                { return data()[index]; }
+
+    // member functions that change the contents
+    void    assign(const ItemType  *first, const ItemType  *last);
+    void    clear();
+    void    erase(ItemType  *position) { erase(position, position + 1); }
+    void    erase(ItemType  *first, ItemType  *last);
+    void    insert(ItemType  *position, const ItemType  &item);
+    void    pop_back() { erase(end() - 1); }
+    void    push_back(const ItemType  &item) { insert(end(), item); }
+    void    Release();
+    void    reserve(size_t  newCapacity);
+
+    // constructor and destructor (the array owns its block, so it cannot be
+    // copied)
+    CSmallArray() : m_block(NULL) {}
+    CSmallArray(const CSmallArray  &other) = delete;
+    ~CSmallArray() { Release(); }
+    CSmallArray&    operator=(const CSmallArray  &rhs) = delete;
+
+private:
+    // the header at the front of a block (the items occupy the slots from
+    // m_start up; the slots in front of them are empty)
+    struct  CHeader
+    {
+        uint32_t    m_start;
+        uint32_t    m_size;
+        uint32_t    m_capacity;
+    };
+
+    // the items start at the first offset after the header that suits them
+    static const size_t     ITEMS_OFFSET = (sizeof(CHeader)
+                                    + alignof(ItemType) - 1)
+                                    / alignof(ItemType) * alignof(ItemType);
+
+    // the smallest block that is allocated
+    static const size_t     MIN_CAPACITY = 4;
+
+    // member functions
+    void                SlideDown();
+    static ItemType*    Items(CHeader  *block) { return reinterpret_cast<
+                                        ItemType*>(reinterpret_cast<char*>(
+                                                    block) + ITEMS_OFFSET); }
+
+    // data members (NULL while the array has no block)
+    CHeader     *m_block;
+};
+
+#include    "csmallarray.cpp"
+#endif  // CSMALL_ARRAY_HEADER
@@ -0,0 +1,170 @@
+// ============================================================================
+// File: cstaticbstree.cpp
+// ============================================================================
+// This file contains the implementation of the CStaticBSTree class. It uses
+// the template parameter "NodeType" for the type of values that are stored in
+// the tree, and the template parameter "Size" for how many there are.  Every
+// function is constexpr, so none of them may allocate, throw or call anything
+// that is not constexpr itself.
+// ============================================================================
+
+#include    "cstaticbstree.h"
+
+
+// ==== CStaticBSTree::CStaticBSTree ==========================================
+//
+// This is the constructor for the CStaticBSTree class.  It copies the values
+// into a scratch array, sorts them with an insertion sort (the tables this is
+// meant for are small, and the standard sorts are not constexpr in C++17),
+// then drops the duplicates, so that the tree is a set like CBSTree, and
+// places the distinct values in Eytzinger order with CStaticBSTree::Layout.
+// Any slots left over at the end of the array are unused.
+//
+// Access: public
+//
+// Input:
+//      values [IN]     -- the values to store, in any order
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  Size>
+constexpr CStaticBSTree<NodeType, Size>::CStaticBSTree(
+                                        const NodeType  (&values)[Size])
+                                        : m_values(), m_numItems(0)
+{
+    array<NodeType, Size>   sorted = {};
+
+    for(size_t i = 0; i < Size; ++i)
+    {
+        NodeType    value = values[i];
+        size_t      j = i;
+        while(j > 0 && value < sorted[j - 1])
+        {
+            sorted[j] = sorted[j - 1];
+            --j;
+        }
+        sorted[j] = value;
+    }
+
+    for(size_t i = 0; i < Size; ++i)
+    {
+        if(0 == m_numItems || sorted[m_numItems - 1] < sorted[i])
+        {
+            sorted[m_numItems++] = sorted[i];
+        }
+    }
+
+    Layout(sorted, 0, 0);
+
+}  // end of "CStaticBSTree<NodeType>::CStaticBSTree"
+
+
+
+// ==== CStaticBSTree::ItemInTree =============================================
+//
+// This function determines if a target item is in the tree.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to a NodeType object that contains
+//                         the target key value to search for
+//
+// Output:
+//      A value of true if the target item is found, false if not.
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  Size>
+constexpr bool  CStaticBSTree<NodeType, Size>::ItemInTree(
+                                        const NodeType  &target) const
+{
+    const NodeType  *boundPtr = LowerBound(target);
+
+    return (boundPtr != NULL && !(target < *boundPtr));
+
+}  // end of "CStaticBSTree<NodeType>::ItemInTree"
+
+
+
+// ==== CStaticBSTree::Layout =================================================
+//
+// This recursive function fills the subtree rooted at a slot with the next
+// values from the sorted array, visiting the slots in order (left subtree,
+// slot, right subtree) so that an in-order walk of the layout is sorted.  The
+// recursion is only as deep as the tree, about log2(Size) levels.  Only the
+// first m_numItems slots are filled.
+//
+// Access: protected
+//
+// Input:
+//      sorted [IN]     -- the values in sorted order
+//
+//      next [IN]       -- the index of the next unplaced value in sorted
+//
+//      slot [IN]       -- the slot at the root of the subtree to fill
+//
+// Output:
+//      The index of the next unplaced value once the subtree is filled.
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  Size>
+constexpr size_t    CStaticBSTree<NodeType, Size>::Layout(
+                                        const array<NodeType, Size>  &sorted
+                                        , size_t  next, size_t  slot)
+{
+    if(slot >= m_numItems)
+    {
+        return next;
+    }
+
+    next = Layout(sorted, next, 2 * slot + 1);
+    m_values[slot] = sorted[next++];
+    return Layout(sorted, next, 2 * slot + 2);
+
+}  // end of "CStaticBSTree<NodeType>::Layout"
+
+
+
+// ==== CStaticBSTree::LowerBound =============================================
+//
+// This function finds the smallest value in the tree that does not order
+// before the target.  The search walks down the layout from slot 0, moving
+// to slot 2i + 1 or 2i + 2 until it passes the last item, and remembers the
+// last slot at which it went left.
+//
+// Access: public
+//
+// Input:
+//      target [IN]     -- a const reference to the key to search for
+//
+// Output:
+//      A pointer to the lower bound of the target, or NULL if every value in
+//      the tree orders before it.
+//
+// ============================================================================
+
+template    <typename  NodeType, size_t  Size>
+constexpr const NodeType*   CStaticBSTree<NodeType, Size>::LowerBound(
+                                        const NodeType  &target) const
+{
+    const NodeType  *boundPtr = NULL;
+    size_t          slot = 0;
+
+    while(slot < m_numItems)
+    {
+        if(m_values[slot] < target)
+        {
+            slot = 2 * slot + 2;
+        }
+        else
+        {
+            boundPtr = &m_values[slot];
+            slot = 2 * slot + 1;
+        }
+    }
+
+    return boundPtr;
+
+}  // end of "CStaticBSTree<NodeType>::LowerBound"
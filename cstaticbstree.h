@@ -0,0 +1,63 @@
+// ============================================================================
+// File: cstaticbstree.h
+// ============================================================================
+// This header file contains the declaration of the CStaticBSTree class. It
+// uses the template parameter "NodeType" for the type of values that are
+// stored in the tree, and the template parameter "Size" for how many there
+// are.
+//
+// A CStaticBSTree is a read-only search tree for a set of values known when
+// the program is built, such as a table of opcodes.  The constructor is
+// constexpr: it sorts the values and lays them out in "Eytzinger" order
+// (breadth-first, so the children of slot i are slots 2i + 1 and 2i + 2)
+// inside a std::array.  A tree declared constexpr is therefore built by the
+// compiler, with no startup cost and no heap, and ItemInTree and LowerBound
+// can be folded away entirely when the key is a constant too.  The top levels
+// of the layout share a few cache lines, so run-time lookups are fast as well.
+//
+// The tree is a set: a value listed more than once is stored once, and
+// GetNumItems counts the distinct values, which may be fewer than Size.  The
+// values are ordered with operator<, which must be usable in constant
+// expressions.  A list of values can be given directly, and the Size
+// parameter is deduced from it:
+//
+//      constexpr CStaticBSTree  opcodes({ 0x90, 0x0F, 0xC3, 0xE8 });
+//      static_assert(opcodes.ItemInTree(0xC3), "missing opcode");
+// ============================================================================
+
+#ifndef CSTATIC_BIN_SEARCH_TREE_HEADER
+#define CSTATIC_BIN_SEARCH_TREE_HEADER
+
+#include    <array>
+#include    <cstddef>
+using namespace std;
+
+// class declaration
+template    <typename  NodeType, size_t  Size>
+class   CStaticBSTree
+{
+public:
+    // constructor
+    constexpr CStaticBSTree(const NodeType  (&values)[Size]);
+
+    // member functions
+    constexpr size_t    GetNumItems() const { return m_numItems; }
+    constexpr bool      ItemInTree(const NodeType  &target) const;
+    constexpr const NodeType*   LowerBound(const NodeType  &target) const;
+
+protected:
+    // member functions
+    constexpr size_t    Layout(const array<NodeType, Size>  &sorted
+                                , size_t  next, size_t  slot);
+
+    // data members
+    array<NodeType, Size>   m_values;
+    size_t                  m_numItems;
+};
+
+// lets the Size parameter be deduced from a list of values
+template    <typename  NodeType, size_t  Size>
+CStaticBSTree(const NodeType  (&)[Size]) -> CStaticBSTree<NodeType, Size>;
+
+#include    "cstaticbstree.cpp"
+#endif  // CSTATIC_BIN_SEARCH_TREE_HEADER
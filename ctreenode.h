@@ -1,8 +1,13 @@
 // ============================================================================
 // File: ctreenode.h (Fall 2018)
 // ============================================================================
-// This file contains the definition of the CTreeNode class.  It uses the
-// "NodeValueType" template parameter to store a copy of a value.
+// This file contains the definitions of the CTreeNode and CTombstoneNode
+// classes.  They use the "NodeValueType" template parameter to store a copy
+// of a value.  A CTombstoneNode also has an m_bDeleted flag, which marks a
+// node whose value has been deleted lazily, leaving the node in place as a
+// tombstone (see CBSTree::SetLazyDelete).  A plain CTreeNode cannot be a
+// tombstone and spends no space on the flag: its m_bDeleted always reads
+// false, so code written for either kind of node can test it all the same.
 // ============================================================================
 
 #ifndef CTREE_NODE_HEADER
@@ -10,6 +15,7 @@
 
 #include    <iostream>
 using namespace std;
+#include    "cnostate.h"
 
 template    <typename NodeValueType>
 class   CTreeNode
@@ -18,13 +24,32 @@ public:
     // constructor
     CTreeNode() : m_left(NULL), m_right(NULL) {}
     CTreeNode(const NodeValueType  &newValue) : m_value(newValue), m_left(NULL)
-                                                                , m_right(NULL) {}
+                                    , m_right(NULL) {}
     ~CTreeNode() { m_left = m_right = NULL; }
 
     // data members
     NodeValueType       m_value;
     CTreeNode           *m_left;
     CTreeNode           *m_right;
+    static constexpr CNoState<bool>     m_bDeleted = CNoState<bool>();
+};
+
+template    <typename NodeValueType>
+class   CTombstoneNode
+{
+public:
+    // constructor
+    CTombstoneNode() : m_left(NULL), m_right(NULL), m_bDeleted(false) {}
+    CTombstoneNode(const NodeValueType  &newValue) : m_value(newValue)
+                                    , m_left(NULL), m_right(NULL)
+                                    , m_bDeleted(false) {}
+    ~CTombstoneNode() { m_left = m_right = NULL; }
+
+    // data members
+    NodeValueType       m_value;
+    CTombstoneNode      *m_left;
+    CTombstoneNode      *m_right;
+    bool                m_bDeleted;
 };
 
 #endif  // CTREE_NODE_HEADER
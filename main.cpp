@@ -7,6 +7,7 @@
 // ============================================================================
 
 #include    <iostream>
+#include    <iomanip>
 #include    <cstdlib>
 using namespace std;
 #include    "cbstree.h"
@@ -17,12 +18,19 @@ using namespace std;
 // defined constants
 const   int         BUFLEN = 256;
 
+// the tree the driver works on: the default features, plus async release
+typedef CBSTree<int, CThreeWayCompare<int>, CRuntimeBalance
+                , CHeapNodeAlloc<int>, CLatencyStats
+                , CTreeFeatures<int, FEATURE_DEFAULT | FEATURE_ASYNC_RELEASE> >
+                                                                    CIntTree;
+
 // function prototypes
-void    AddRandomInts(CBSTree<int>  &tree);
-void    AddSequentialInts(CBSTree<int>  &tree);
-void    BalanceTree(CBSTree<int>  &tree);
+void    AddRandomInts(CIntTree  &tree);
+void    AddSequentialInts(CIntTree  &tree);
+void    BalanceTree(CIntTree  &tree);
+void    DisplayLatency(CIntTree  &tree);
 void    DisplayMenu();
-void    DisplayTree(const CBSTree<int>  &tree);
+void    DisplayTree(const CIntTree  &tree);
 void    PrintInt(const int &intRef);
 
 
@@ -33,10 +41,17 @@ void    PrintInt(const int &intRef);
 int     main()
 {
     bool                bLoop = true;
-    CBSTree<int>        myIntTree;
+    CIntTree            myIntTree;
     char                buf[BUFLEN];
-    int                 height;
-    int                 numNodes;
+    size_t              height;
+    size_t              numNodes;
+
+    // free released trees on a background thread, so that R and Q return
+    // at once however large the tree has grown
+    myIntTree.SetAsyncRelease(true);
+
+    // time every operation, for the L option
+    myIntTree.EnableLatencyStats();
 
     // loop and let the user manipulate the tree
     do  {
@@ -73,6 +88,11 @@ int     main()
                     }
                 break;
 
+            // display and reset the latency histograms
+            case 'L':
+                DisplayLatency(myIntTree);
+                break;
+
             // display tree statistics
             case 'S':
                 myIntTree.GetTreeInfo(numNodes, height);
@@ -127,7 +147,7 @@ int     main()
 //
 // ============================================================================
 
-void    AddRandomInts(CBSTree<int>  &tree)
+void    AddRandomInts(CIntTree  &tree)
 {
     int         intVal;
     int         numInts;
@@ -186,7 +206,7 @@ void    AddRandomInts(CBSTree<int>  &tree)
 //
 // ============================================================================
 
-void    AddSequentialInts(CBSTree<int>  &tree)
+void    AddSequentialInts(CIntTree  &tree)
 {
     int         lower;
     int         upper;
@@ -230,7 +250,7 @@ void    AddSequentialInts(CBSTree<int>  &tree)
 //
 // ============================================================================
 
-void    BalanceTree(CBSTree<int>  &tree)
+void    BalanceTree(CIntTree  &tree)
 {
     cout << "BalanceTree called..." << endl;
     tree.RebalanceTree();
@@ -239,6 +259,68 @@ void    BalanceTree(CBSTree<int>  &tree)
 
 
 
+// ==== DisplayLatency ========================================================
+//
+// This function displays the latency histograms of the tree parameter, one
+// line per operation, along with the tree's current size and height, then
+// empties the histograms so that the next display covers only what happens
+// in between.
+//
+// Input:
+//      tree [IN/OUT]   -- a reference to a CBSTree object instantiated for
+//                         an int
+//
+// Output:
+//      Nothing
+//
+// ============================================================================
+
+void    DisplayLatency(CIntTree  &tree)
+{
+    const char  *names[NUM_LATENCY_OPS] = { "insert", "delete", "find"
+                                            , "delete range", "pop"
+                                            , "rebalance" };
+    size_t      height;
+    size_t      numNodes;
+
+    tree.GetTreeInfo(numNodes, height);
+    cout << "The tree has " << numNodes << " nodes and a height of "
+         << height << "; times are in nanoseconds" << endl;
+    cout << left << setw(14) << "operation" << right << setw(10) << "count"
+         << setw(10) << "mean" << setw(10) << "p50" << setw(10) << "p99"
+         << setw(10) << "p99.9" << setw(10) << "max" << endl;
+
+    for (int op = 0; op < NUM_LATENCY_OPS; ++op)
+        {
+        const CLatencyHistogram *histPtr;
+
+        histPtr = tree.GetLatencyStats(static_cast<LatencyOp>(op));
+        if (NULL == histPtr || 0 == histPtr->GetCount())
+            {
+            continue;
+            }
+
+        cout << left << setw(14) << names[op] << right
+             << setw(10) << histPtr->GetCount() << fixed << setprecision(0)
+             << setw(10) << CLatencyHistogram::ToNanoseconds(
+                                                    histPtr->GetMean())
+             << setw(10) << CLatencyHistogram::ToNanoseconds(
+                                    double(histPtr->GetPercentile(50)))
+             << setw(10) << CLatencyHistogram::ToNanoseconds(
+                                    double(histPtr->GetPercentile(99)))
+             << setw(10) << CLatencyHistogram::ToNanoseconds(
+                                    double(histPtr->GetPercentile(99.9)))
+             << setw(10) << CLatencyHistogram::ToNanoseconds(
+                                    double(histPtr->GetMax()))
+             << endl;
+        }
+
+    tree.ResetLatencyStats();
+
+}  // end of "DisplayLatency"
+
+
+
 // ==== DisplayMenu ===========================================================
 //
 // This function displays the list of menu options available to the user.
@@ -254,6 +336,7 @@ void    DisplayMenu()
     cout << "A)dd random values to the tree\n";
     cout << "B)alance the tree\n";
     cout << "I)nsert sequential values to the tree\n";
+    cout << "L)atency of tree operations\n";
     cout << "R)elease all tree nodes\n";
     cout << "S)how tree statistics\n";
     cout << "Q)uit\n";
@@ -276,7 +359,7 @@ void    DisplayMenu()
 //      Nothing
 //
 // ============================================================================
-void    DisplayTree(const CBSTree<int>  &tree)
+void    DisplayTree(const CIntTree  &tree)
 {
     char        buf[BUFLEN];
 